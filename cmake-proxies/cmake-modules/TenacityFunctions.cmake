@@ -505,3 +505,41 @@ macro( tenacity_header_only_library NAME SOURCES IMPORT_TARGETS
    list( APPEND TENACITY_LIBRARIES "${NAME}" )
    set( TENACITY_LIBRARIES "${TENACITY_LIBRARIES}" PARENT_SCOPE )
 endmacro()
+
+# Define an executable of tests and benchmarks for a library, built when the
+# TESTS option is on.  Pass a name, sources, and the targets to link.
+# ctest runs the tests; run the executable with --benchmark to time the
+# benchmarks.  See tests/harness/LibraryTest.h.
+function( tenacity_library_test NAME SOURCES LIBRARIES )
+   set( TARGET ${NAME} )
+   set( HARNESS ${CMAKE_SOURCE_DIR}/tests/harness )
+
+   message( STATUS "========== Configuring ${TARGET} ==========" )
+
+   add_executable( ${TARGET} )
+
+   set( OPTIONS )
+   tenacity_append_common_compiler_options( OPTIONS NO )
+
+   target_sources( ${TARGET}
+      PRIVATE
+         ${SOURCES}
+         ${HARNESS}/LibraryTest.cpp
+         ${HARNESS}/LibraryTest.h
+   )
+   target_compile_options( ${TARGET} ${OPTIONS} )
+   target_include_directories( ${TARGET}
+      PRIVATE
+         ${HARNESS}
+         ${CMAKE_SOURCE_DIR}/libraries
+   )
+   target_link_libraries( ${TARGET}
+      PRIVATE
+         ${LIBRARIES}
+         lib-preferences
+         wxWidgets::wxWidgets
+   )
+   set_target_properties( ${TARGET} PROPERTIES FOLDER "tests" )
+
+   add_test( NAME ${TARGET} COMMAND ${TARGET} )
+endfunction()
@@ -11,6 +11,7 @@ Paul Licameli split from AudioIO.cpp
 
 #include "AudioIOBase.h"
 
+#include "DeviceManager.h"
 #include "Meter.h"
 #include "Prefs.h"
 
@@ -196,6 +197,8 @@ bool AudioIOBase::IsMonitoring() const
 
 std::vector<long> AudioIOBase::GetSupportedPlaybackRates(int devIndex, double rate)
 {
+   DeviceManager::Instance()->WaitForRescan();
+
    if (devIndex == -1)
    {  // weren't given a device index, get the prefs / default one
       devIndex = getPlayDevIndex();
@@ -261,6 +264,8 @@ std::vector<long> AudioIOBase::GetSupportedPlaybackRates(int devIndex, double ra
 
 std::vector<long> AudioIOBase::GetSupportedCaptureRates(int devIndex, double rate)
 {
+   DeviceManager::Instance()->WaitForRescan();
+
    if (devIndex == -1)
    {  // not given a device, look up in prefs / default
       devIndex = getRecordDevIndex();
@@ -395,6 +400,8 @@ int AudioIOBase::GetOptimalSupportedSampleRate()
 
 int AudioIOBase::getPlayDevIndex(const std::string &devNameArg)
 {
+   DeviceManager::Instance()->WaitForRescan();
+
    std::string devName(devNameArg);
    // if we don't get given a device, look up the preferences
    if (devName.empty())
@@ -450,6 +457,8 @@ int AudioIOBase::getPlayDevIndex(const std::string &devNameArg)
 
 int AudioIOBase::getRecordDevIndex(const std::string &devNameArg)
 {
+   DeviceManager::Instance()->WaitForRescan();
+
    std::string devName(devNameArg);
    // if we don't get given a device, look up the preferences
    if (devName.empty())
@@ -507,6 +516,8 @@ int AudioIOBase::getRecordDevIndex(const std::string &devNameArg)
 
 std::string AudioIOBase::GetDeviceInfo() const
 {
+   DeviceManager::Instance()->WaitForRescan();
+
    std::ostringstream s;
 
    if (IsStreamActive()) {
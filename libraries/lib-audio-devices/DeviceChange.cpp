@@ -215,6 +215,14 @@ public:
    
       // Instantiate the monitor object
       struct udev_monitor *mon = udev_monitor_new_from_netlink(udev, "udev");
+      if (!mon)
+      {
+         udev_unref(udev);
+         pthread_exit(NULL);
+      }
+
+      // Only sound cards matter; other devices come and go too often
+      udev_monitor_filter_add_match_subsystem_devtype(mon, "sound", NULL);
 
       // Start receiving notifications
       udev_monitor_enable_receiving(mon);
@@ -259,6 +267,7 @@ public:
          }
       }
    
+      udev_monitor_unref(mon);
       udev_unref(udev);
 
       pthread_exit(NULL);
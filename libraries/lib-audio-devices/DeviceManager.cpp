@@ -10,7 +10,10 @@
 #include "DeviceManager.h"
 
 #include <wx/log.h>
+#include <algorithm>
+#include <future>
 #include <thread>
+#include <utility>
 
 
 #include "portaudio.h"
@@ -19,6 +22,7 @@
 #endif
 
 #include "AudioIOBase.h"
+#include "BasicUI.h"
 
 #include "DeviceChange.h" // for HAVE_DEVICE_CHANGE
 
@@ -45,20 +49,14 @@ const std::vector<Device> &DeviceManager::GetOutputDevices()
 
 Device* DeviceManager::GetDefaultDevice(int hostIndex, bool isInput)
 {
-   if (hostIndex < 0 || hostIndex >= Pa_GetHostApiCount()) {
-      return nullptr;
-   }
-
-   const struct PaHostApiInfo *apiinfo = Pa_GetHostApiInfo(hostIndex);   // get info on API
+   // The defaults were found when scanning, so that portaudio, which may be
+   // restarting, need not be asked
    std::vector<Device>& devices = isInput ? mInputDeviceSources : mOutputDeviceSources;
-   size_t i;
-   int targetDevice = isInput ? apiinfo->defaultInputDevice : apiinfo->defaultOutputDevice;
-
-   for (i = 0; i < devices.size(); i++)
+   for (auto &device : devices)
    {
-      if (devices[i].GetDeviceIndex() == targetDevice)
+      if (device.GetHostIndex() == hostIndex && device.IsDefaultDevice())
       {
-         return &devices[i];
+         return &device;
       }
    }
 
@@ -121,34 +119,22 @@ static void AddSources(int deviceIndex, int rate, std::vector<Device>& devices,
    devices.push_back(device);
 }
 
-/// Gets a NEW list of devices by terminating and restarting portaudio
-/// Assumes that DeviceManager is only used on the main thread.
-void DeviceManager::Rescan()
+static bool SameDevices(const std::vector<Device>& a, const std::vector<Device>& b)
 {
-   // get rid of the previous scan info
-   this->mInputDeviceSources.clear();
-   this->mOutputDeviceSources.clear();
-
-   // if we are doing a second scan then restart portaudio to get NEW devices
-   if (m_inited) {
-      // check to see if there is a stream open - can happen if monitoring,
-      // but otherwise Rescan() should not be available to the user.
-      auto gAudioIO = AudioIOBase::Get();
-      if (gAudioIO) {
-         if (gAudioIO->IsMonitoring())
-         {
-            using namespace std::chrono;
-            gAudioIO->StopStream();
-            while (gAudioIO->IsBusy())
-               std::this_thread::sleep_for(100ms);
-         }
-      }
+   return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+      [](const Device& x, const Device& y) {
+         return x.GetDeviceIndex() == y.GetDeviceIndex() &&
+            x.GetHostIndex() == y.GetHostIndex() &&
+            x.GetNumChannels() == y.GetNumChannels() &&
+            x.IsDefaultDevice() == y.IsDefaultDevice() &&
+            x.GetName() == y.GetName() &&
+            x.GetHostName() == y.GetHostName();
+      });
+}
 
-      // restart portaudio - this updates the device list
-      // FIXME: TRAP_ERR restarting PortAudio
-      Pa_Terminate();
-      Pa_Initialize();
-   }
+auto DeviceManager::Enumerate() -> Snapshot
+{
+   Snapshot snapshot;
 
    // FIXME: TRAP_ERR PaErrorCode not handled in ReScan()
    int nDevices = Pa_GetDeviceCount();
@@ -158,29 +144,216 @@ void DeviceManager::Rescan()
    //So we need to call port mixer for every device to get the sources
    for (int i = 0; i < nDevices; i++) {
       const PaDeviceInfo *info = Pa_GetDeviceInfo(i);
+      const PaHostApiInfo *apiinfo = Pa_GetHostApiInfo(info->hostApi);
       if (info->maxOutputChannels > 0) {
-         AddSources(i, info->defaultSampleRate, mOutputDeviceSources, false);
+         AddSources(i, info->defaultSampleRate, snapshot.outputs, false);
+         snapshot.outputs.back().SetDefaultDevice(
+            apiinfo->defaultOutputDevice == i);
       }
 
       if (info->maxInputChannels > 0) {
 #ifdef __WXMSW__
 #if !defined(EXPERIMENTAL_FULL_WASAPI)
-         if (Pa_GetHostApiInfo(info->hostApi)->type != paWASAPI ||
+         if (apiinfo->type != paWASAPI ||
              PaWasapi_IsLoopback(i) > 0)
 #endif
 #endif
-         AddSources(i, info->defaultSampleRate, mInputDeviceSources, true);
+         {
+            AddSources(i, info->defaultSampleRate, snapshot.inputs, true);
+            snapshot.inputs.back().SetDefaultDevice(
+               apiinfo->defaultInputDevice == i);
+         }
       }
    }
 
-   // If this was not an initial scan update each device toolbar.
-   if ( m_inited )
+   return snapshot;
+}
+
+void DeviceManager::Take(Snapshot snapshot)
+{
+   const bool changed = !m_inited ||
+      !SameDevices(snapshot.inputs, mInputDeviceSources) ||
+      !SameDevices(snapshot.outputs, mOutputDeviceSources);
+   mInputDeviceSources = std::move(snapshot.inputs);
+   mOutputDeviceSources = std::move(snapshot.outputs);
+
+   // If this was not an initial scan, and something was plugged or
+   // unplugged, update each device toolbar.
+   if ( m_inited && changed )
       Publish(DeviceChangeMessage::Rescan);
 
    m_inited = true;
    mRescanTime = std::chrono::steady_clock::now();
 }
 
+bool DeviceManager::PrepareRestart()
+{
+   // check to see if there is a stream open - can happen if monitoring,
+   // but otherwise Rescan() should not be available to the user.
+   auto gAudioIO = AudioIOBase::Get();
+   if (gAudioIO) {
+      if (gAudioIO->IsMonitoring())
+      {
+         using namespace std::chrono;
+         gAudioIO->StopStream();
+         while (gAudioIO->IsBusy())
+            std::this_thread::sleep_for(100ms);
+      }
+      // A device change notification can arrive while recording; portaudio
+      // can't be restarted under an open stream
+      if (gAudioIO->IsStreamActive())
+         return false;
+   }
+   return true;
+}
+
+void DeviceManager::PortAudioLoop()
+{
+   while (true) {
+      std::function<void()> job;
+      {
+         std::unique_lock<std::mutex> lock{ mJobMutex };
+         mJobAvailable.wait(lock, [this]{
+            return mStopPortAudio || !mJobs.empty(); });
+         if (mJobs.empty())
+            return;
+         job = std::move(mJobs.front());
+         mJobs.pop_front();
+      }
+      job();
+   }
+}
+
+void DeviceManager::Post(std::function<void()> job)
+{
+   {
+      std::lock_guard<std::mutex> lock{ mJobMutex };
+      mJobs.push_back(std::move(job));
+   }
+   if (!mPortAudioThread.joinable())
+      mPortAudioThread = std::thread{ [this]{ PortAudioLoop(); } };
+   mJobAvailable.notify_one();
+}
+
+template<typename Function>
+auto DeviceManager::Call(Function function) -> decltype(function())
+{
+   auto task = std::make_shared<
+      std::packaged_task<decltype(function())()>>(std::move(function));
+   auto result = task->get_future();
+   Post([task]{ (*task)(); });
+   return result.get();
+}
+
+void DeviceManager::StopPortAudioThread()
+{
+   {
+      std::lock_guard<std::mutex> lock{ mJobMutex };
+      mStopPortAudio = true;
+   }
+   mJobAvailable.notify_one();
+   if (mPortAudioThread.joinable())
+      mPortAudioThread.join();
+}
+
+int DeviceManager::InitializePortAudio()
+{
+   return Call([]{ return Pa_Initialize(); });
+}
+
+void DeviceManager::TerminatePortAudio()
+{
+   WaitForRescan();
+   // FIXME: ? TRAP_ERR.  Pa_Terminate probably OK if err without reporting.
+   Call([]{ Pa_Terminate(); });
+   StopPortAudioThread();
+}
+
+/// Gets a NEW list of devices by terminating and restarting portaudio
+/// Assumes that DeviceManager is only used on the main thread.
+void DeviceManager::Rescan()
+{
+   WaitForRescan();
+
+   // if we are doing a second scan then restart portaudio to get NEW devices
+   if (m_inited) {
+      if (!PrepareRestart())
+         return;
+
+      // restart portaudio - this updates the device list
+      // FIXME: TRAP_ERR restarting PortAudio
+      Call([]{
+         Pa_Terminate();
+         Pa_Initialize();
+      });
+   }
+
+   Take(Enumerate());
+}
+
+void DeviceManager::RescanInBackground()
+{
+   if (!m_inited) {
+      // Nothing can be shown without the devices, so don't defer it
+      Init();
+      return;
+   }
+
+   if (mScanning) {
+      mRescanAgain = true;
+      return;
+   }
+
+   if (!PrepareRestart()) {
+      wxLogDebug(wxT("RescanInBackground() skipped while a stream is open"));
+      return;
+   }
+
+   // Restarting makes some host APIs (ALSA, JACK) probe every card, which
+   // can take seconds; that's why this isn't on the main thread
+   auto task = std::make_shared<std::packaged_task<Snapshot()>>([]{
+      // FIXME: TRAP_ERR restarting PortAudio
+      Pa_Terminate();
+      Pa_Initialize();
+      return Enumerate();
+   });
+   mScanned = task->get_future();
+   mScanning = true;
+   Post([this, task]{
+      (*task)();
+      BasicUI::CallAfter([this]{
+         // WaitForRescan() may have taken the devices already, or a later
+         // rescan may be running; then this does nothing
+         TakeScanned();
+         if (!mScanning && std::exchange(mRescanAgain, false))
+            RescanInBackground();
+      });
+   });
+}
+
+bool DeviceManager::IsRescanning() const
+{
+   return mScanning;
+}
+
+void DeviceManager::WaitForRescan()
+{
+   if (mScanning)
+      mScanned.wait();
+   TakeScanned();
+}
+
+void DeviceManager::TakeScanned()
+{
+   using namespace std::chrono;
+   if (!mScanning ||
+       mScanned.wait_for(0s) != std::future_status::ready)
+      return;
+
+   mScanning = false;
+   Take(mScanned.get());
+}
+
 
 float DeviceManager::GetTimeSinceRescan() {
    auto now = std::chrono::steady_clock::now();
@@ -202,7 +375,7 @@ DeviceManager::DeviceManager()
 
 DeviceManager::~DeviceManager()
 {
-
+   StopPortAudioThread();
 }
 
 void DeviceManager::Init()
@@ -220,7 +393,7 @@ void DeviceManager::Init()
 #if defined(HAVE_DEVICE_CHANGE)
 void DeviceManager::DeviceChangeNotification()
 {
-   Rescan();
+   RescanInBackground();
    return;
 }
 #endif
@@ -19,6 +19,12 @@
 #define __AUDACITY_DEVICEMANAGER__
 
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include <wx/string.h> // member variables
@@ -41,6 +47,30 @@ class AUDIO_DEVICES_API DeviceManager final
    /// Assumes that DeviceManager is only used on the main thread.
    void Rescan();
 
+   /// Like Rescan(), but restarts portaudio and enumerates on the portaudio
+   /// thread.  The new devices are taken on the main thread when done, and
+   /// DeviceChangeMessage::Rescan is published only if they differ.
+   void RescanInBackground();
+
+   /// Calls Pa_Initialize() on the portaudio thread, which makes every
+   /// Pa_Initialize() and Pa_Terminate() call.  Some host APIs (WASAPI,
+   /// DirectSound and ASIO, through COM) tie their state to that thread, so
+   /// it lives until TerminatePortAudio().
+   /// @return the PaError
+   int InitializePortAudio();
+   /// Waits for any rescan, calls Pa_Terminate() on the portaudio thread,
+   /// and stops that thread
+   void TerminatePortAudio();
+
+   /// Whether a background rescan is running
+   bool IsRescanning() const;
+
+   /// Portaudio must not be used while it is being restarted: callers of it
+   /// on the main thread call this first, which blocks until a background
+   /// rescan, if any, is done, and takes its devices.  A rescan starts only
+   /// from the event loop, so lists got after the first call stay valid.
+   void WaitForRescan();
+
    // Time since devices scanned in seconds.
    float GetTimeSinceRescan();
 
@@ -58,8 +88,43 @@ class AUDIO_DEVICES_API DeviceManager final
 #endif
 
 private:
+   struct Snapshot
+   {
+      std::vector<Device> inputs;
+      std::vector<Device> outputs;
+   };
+
+   /// Stops monitoring, so that portaudio may be restarted
+   /// @return false if a stream is still open
+   bool PrepareRestart();
+   /// Reads the devices from portaudio, without probing them
+   static Snapshot Enumerate();
+   void Take(Snapshot snapshot);
+   /// Takes the devices of a background rescan, if it is done
+   void TakeScanned();
+
+   void PortAudioLoop();
+   /// Runs a job on the portaudio thread, starting it if needed
+   void Post(std::function<void()> job);
+   /// Runs a function on the portaudio thread and waits for its result
+   template<typename Function>
+   auto Call(Function function) -> decltype(function());
+   void StopPortAudioThread();
+
    std::chrono::time_point<std::chrono::steady_clock> mRescanTime;
 
+   std::thread mPortAudioThread;
+   std::mutex mJobMutex;
+   std::condition_variable mJobAvailable;
+   std::deque<std::function<void()>> mJobs;
+   bool mStopPortAudio{ false };
+
+   /// Main thread only
+   bool mScanning{ false };
+   std::future<Snapshot> mScanned;
+   /// A device change arrived during a background rescan
+   bool mRescanAgain{ false };
+
  protected:
    //private constructor - Singleton.
    DeviceManager();
@@ -0,0 +1,240 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file Metering.cpp
+
+**********************************************************************/
+
+#include "Metering.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define METERING_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr unsigned Phases = 4;
+constexpr unsigned Taps = 12;
+
+//! The polyphase interpolation filter of ITU-R BS.1770-4, annex 2
+constexpr float Filter[Phases][Taps] = {
+   {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,
+      0.0332031250000f, -0.0594482421875f,  0.1373291015625f,
+      0.9721679687500f, -0.1022949218750f,  0.0476074218750f,
+     -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+   { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,
+      0.0891113281250f, -0.1665039062500f,  0.4650878906250f,
+      0.7797851562500f, -0.2003173828125f,  0.1015625000000f,
+     -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+   { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,
+      0.1015625000000f, -0.2003173828125f,  0.7797851562500f,
+      0.4650878906250f, -0.1665039062500f,  0.0891113281250f,
+     -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+   { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,
+      0.0476074218750f, -0.1022949218750f,  0.9721679687500f,
+      0.1373291015625f, -0.0594482421875f,  0.0332031250000f,
+     -0.0196533203125f,  0.0109863281250f,  0.0017089843750f },
+};
+
+//! The filter with taps reversed, to multiply the history oldest first
+struct Reversed
+{
+   constexpr Reversed() : taps{}
+   {
+      for (unsigned pp = 0; pp < Phases; ++pp)
+         for (unsigned tt = 0; tt < Taps; ++tt)
+            taps[pp][tt] = Filter[pp][Taps - 1 - tt];
+   }
+   float taps[Phases][Taps];
+};
+constexpr Reversed ReversedFilter;
+
+#ifdef METERING_SSE2
+//! Vectors per frame in the vectorized pass; more channels are done scalar
+constexpr unsigned MaxVectors = 8;
+#endif
+
+}
+
+Metering::Metering(float clipLevel)
+   : mClipLevel{ clipLevel }
+{
+}
+
+Metering::~Metering() = default;
+
+void Metering::Reset()
+{
+   std::fill(mHistory.begin(), mHistory.end(), 0.0f);
+   std::fill(mPositions.begin(), mPositions.end(), 0u);
+}
+
+void Metering::Clip(Levels &levels, size_t frame, float magnitude) const
+{
+   // In addition to the longest run, keep the runs at the head and tail, in
+   // case there's a run of clipped samples that crosses block boundaries
+   if (magnitude >= mClipLevel) {
+      if (levels.headClipped == frame)
+         ++levels.headClipped;
+      ++levels.tailClipped;
+      levels.longestClipped =
+         std::max(levels.longestClipped, levels.tailClipped);
+   }
+   else
+      levels.tailClipped = 0;
+}
+
+float Metering::Oversample(unsigned channel, float sample)
+{
+   const auto history = mHistory.data() + channel * 2 * Taps;
+   auto &position = mPositions[channel];
+   history[position] = history[position + Taps] = sample;
+   position = (position + 1) % Taps;
+   // Now the last Taps samples begin at position, oldest first
+   const auto window = history + position;
+
+#ifdef METERING_SSE2
+   const auto w0 = _mm_loadu_ps(window);
+   const auto w1 = _mm_loadu_ps(window + 4);
+   const auto w2 = _mm_loadu_ps(window + 8);
+   __m128 phases[Phases];
+   for (unsigned pp = 0; pp < Phases; ++pp) {
+      const auto taps = ReversedFilter.taps[pp];
+      phases[pp] = _mm_add_ps(
+         _mm_add_ps(
+            _mm_mul_ps(w0, _mm_loadu_ps(taps)),
+            _mm_mul_ps(w1, _mm_loadu_ps(taps + 4))),
+         _mm_mul_ps(w2, _mm_loadu_ps(taps + 8)));
+   }
+   // Sum each phase across the lanes
+   _MM_TRANSPOSE4_PS(phases[0], phases[1], phases[2], phases[3]);
+   const auto sums = _mm_add_ps(_mm_add_ps(phases[0], phases[1]),
+      _mm_add_ps(phases[2], phases[3]));
+   const auto magnitudes =
+      _mm_andnot_ps(_mm_set1_ps(-0.0f), sums);
+   auto peak = _mm_max_ps(magnitudes,
+      _mm_shuffle_ps(magnitudes, magnitudes, _MM_SHUFFLE(1, 0, 3, 2)));
+   peak = _mm_max_ss(peak, _mm_shuffle_ps(peak, peak, _MM_SHUFFLE(2, 3, 0, 1)));
+   return _mm_cvtss_f32(peak);
+#else
+   float peak = 0;
+   for (unsigned pp = 0; pp < Phases; ++pp) {
+      float sum = 0;
+      for (unsigned tt = 0; tt < Taps; ++tt)
+         sum += window[tt] * ReversedFilter.taps[pp][tt];
+      peak = std::max(peak, std::fabs(sum));
+   }
+   return peak;
+#endif
+}
+
+const std::vector<Metering::Levels> &Metering::Measure(const float *samples,
+   unsigned numChannels, size_t numFrames, bool truePeak)
+{
+   if (numChannels != mNumChannels) {
+      mNumChannels = numChannels;
+      mLevels.resize(numChannels);
+      mSums.resize(numChannels);
+      mHistory.assign(numChannels * 2 * Taps, 0.0f);
+      mPositions.assign(numChannels, 0u);
+   }
+   std::fill(mLevels.begin(), mLevels.end(), Levels{});
+   std::fill(mSums.begin(), mSums.end(), 0.0);
+   if (numChannels == 0)
+      return mLevels;
+
+   const size_t total = numFrames * numChannels;
+   size_t sample = 0;
+
+#ifdef METERING_SSE2
+   // With 1, 2 or 4 channels, every vector holds the same lanes of channels;
+   // with a multiple of 4, each vector of a frame holds the same channels
+   const unsigned vectors = numChannels % 4 == 0 ? numChannels / 4
+      : 4 % numChannels == 0 ? 1 : 0;
+   if (vectors > 0 && vectors <= MaxVectors) {
+      __m128 peaks[MaxVectors];
+      __m128 sums[MaxVectors];
+      for (unsigned vv = 0; vv < vectors; ++vv)
+         peaks[vv] = sums[vv] = _mm_setzero_ps();
+      const auto sign = _mm_set1_ps(-0.0f);
+      const auto clip = _mm_set1_ps(mClipLevel);
+      // Whether the channels of each vector may end with a run of clipped
+      // samples
+      bool inRun[MaxVectors]{};
+
+      const size_t stride = 4 * vectors;
+      for (const size_t end = total - total % stride; sample < end;) {
+         for (unsigned vv = 0; vv < vectors; ++vv, sample += 4) {
+            const auto x = _mm_loadu_ps(samples + sample);
+            const auto magnitude = _mm_andnot_ps(sign, x);
+            peaks[vv] = _mm_max_ps(peaks[vv], magnitude);
+            sums[vv] = _mm_add_ps(sums[vv], _mm_mul_ps(x, x));
+            if (_mm_movemask_ps(_mm_cmpge_ps(magnitude, clip))) {
+               for (unsigned ll = 0; ll < 4; ++ll)
+                  Clip(mLevels[(sample + ll) % numChannels],
+                     (sample + ll) / numChannels,
+                     std::fabs(samples[sample + ll]));
+               inRun[vv] = true;
+            }
+            else if (inRun[vv]) {
+               for (unsigned ll = 0; ll < 4; ++ll)
+                  mLevels[(sample + ll) % numChannels].tailClipped = 0;
+               inRun[vv] = false;
+            }
+            if (truePeak)
+               for (unsigned ll = 0; ll < 4; ++ll) {
+                  auto &levels = mLevels[(sample + ll) % numChannels];
+                  levels.truePeak = std::max(levels.truePeak,
+                     Oversample((sample + ll) % numChannels,
+                        samples[sample + ll]));
+               }
+         }
+      }
+
+      // Fold the lanes into their channels
+      alignas(16) float lanes[4];
+      for (unsigned vv = 0; vv < vectors; ++vv) {
+         _mm_store_ps(lanes, peaks[vv]);
+         for (unsigned ll = 0; ll < 4; ++ll) {
+            auto &peak = mLevels[(4 * vv + ll) % numChannels].peak;
+            peak = std::max(peak, lanes[ll]);
+         }
+         _mm_store_ps(lanes, sums[vv]);
+         for (unsigned ll = 0; ll < 4; ++ll)
+            mSums[(4 * vv + ll) % numChannels] += lanes[ll];
+      }
+   }
+#endif
+
+   // The remainder, or all of the samples when not vectorized
+   unsigned channel = sample % numChannels;
+   for (auto frame = sample / numChannels; sample < total; ++sample) {
+      const auto x = samples[sample];
+      const auto magnitude = std::fabs(x);
+      auto &levels = mLevels[channel];
+      levels.peak = std::max(levels.peak, magnitude);
+      mSums[channel] += x * x;
+      Clip(levels, frame, magnitude);
+      if (truePeak)
+         levels.truePeak =
+            std::max(levels.truePeak, Oversample(channel, x));
+      if (++channel == numChannels) {
+         channel = 0;
+         ++frame;
+      }
+   }
+
+   for (channel = 0; channel < numChannels; ++channel) {
+      auto &levels = mLevels[channel];
+      levels.rms = numFrames > 0
+         ? static_cast<float>(std::sqrt(mSums[channel] / numFrames)) : 0;
+      levels.truePeak = std::max(levels.truePeak, levels.peak);
+   }
+   return mLevels;
+}
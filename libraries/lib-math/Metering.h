@@ -0,0 +1,77 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file Metering.h
+  @brief Levels of blocks of interleaved samples, for meters
+
+**********************************************************************/
+
+#ifndef __TENACITY_METERING__
+#define __TENACITY_METERING__
+
+#include <cstddef>
+#include <vector>
+
+//! Measures peak, RMS, runs of clipped samples and optionally the true peak
+//! of all channels of interleaved samples, in one pass over the samples
+/*!
+ The pass uses SSE2 where the compiler targets it, when there are 1, 2 or a
+ multiple of 4 channels; otherwise it is scalar.
+
+ The true peak is the peak of the signal oversampled four times with the
+ interpolation filter of ITU-R BS.1770.  The filter remembers the last samples
+ of each channel, so successive blocks of one stream should be measured by
+ the same object, and Reset() called between streams.
+ */
+class MATH_API Metering
+{
+public:
+   //! Levels of one channel in one block
+   struct Levels
+   {
+      float peak = 0;        //!< Greatest absolute sample value
+      float rms = 0;         //!< Root of the mean of the squares
+      //! Greatest absolute value oversampled, and no less than peak;
+      //! equal to peak if the true peak was not requested
+      float truePeak = 0;
+      //! Length of the run of clipped samples starting the block
+      size_t headClipped = 0;
+      //! Length of the run of clipped samples ending the block
+      size_t tailClipped = 0;
+      //! Length of the longest run of clipped samples in the block
+      size_t longestClipped = 0;
+   };
+
+   //! @param clipLevel samples of at least this magnitude count as clipped
+   explicit Metering(float clipLevel);
+   ~Metering();
+
+   //! Forget the samples remembered for oversampling
+   void Reset();
+
+   //! Measure each of numChannels channels of interleaved samples
+   /*! Allocates only when the number of channels grows.
+    @return one Levels for each channel, valid until the next call */
+   const std::vector<Levels> &Measure(const float *samples,
+      unsigned numChannels, size_t numFrames, bool truePeak);
+
+   //! The result of the last call to Measure()
+   const std::vector<Levels> &GetLevels() const { return mLevels; }
+
+private:
+   void Clip(Levels &levels, size_t frame, float magnitude) const;
+   float Oversample(unsigned channel, float sample);
+
+   const float mClipLevel;
+   unsigned mNumChannels{ 0 };
+   std::vector<Levels> mLevels;
+   //! Sums of squares of the current block, in double precision
+   std::vector<double> mSums;
+   //! For each channel, its last samples twice over, so that they are
+   //! always contiguous; and where the next one goes
+   std::vector<float> mHistory;
+   std::vector<unsigned> mPositions;
+};
+
+#endif
@@ -111,6 +111,11 @@ std::pair<size_t, size_t>
    return { idone, odone };
 }
 
+void Resample::Reset()
+{
+   soxr_clear(mHandle.get());
+}
+
 void Resample::SetMethod(const bool useBestMethod)
 {
    if (useBestMethod)
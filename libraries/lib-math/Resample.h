@@ -72,6 +72,11 @@ class MATH_API Resample final
                         float  *outBuffer,
                         size_t  outBufferLen);
 
+   /// Forget the samples of the stream processed so far, keeping the
+   /// configuration, so that an unrelated stream can follow without the
+   /// cost of making a new resampler.  Also allowed after lastFlag.
+   void Reset();
+
  protected:
    void SetMethod(const bool useBestMethod);
 
@@ -0,0 +1,113 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file SignalFeatures.cpp
+
+**********************************************************************/
+
+#include "SignalFeatures.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIGNAL_FEATURES_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+#ifdef SIGNAL_FEATURES_SSE2
+//! Number of bits set in each four bit mask
+constexpr unsigned char BitCounts[16] =
+   { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+//! Number of changes in a run of four bits, oldest lowest, following the bit
+//! before them
+inline size_t Changes(int bits, int previous)
+{
+   return BitCounts[(bits ^ ((bits << 1) | previous)) & 0xF];
+}
+#endif
+
+}
+
+SignalFeatures SignalFeatures::Measure(const float *samples, size_t len)
+{
+   SignalFeatures result;
+   if (len == 0)
+      return result;
+
+   // The first sample has no step before it
+   result.sumSquares = static_cast<double>(samples[0]) * samples[0];
+   bool negative = samples[0] < 0;
+   bool down = false;
+   size_t ii = 1;
+
+#ifdef SIGNAL_FEATURES_SSE2
+   if (len > 4) {
+      const auto zero = _mm_setzero_ps();
+      auto sums = _mm_setzero_pd();
+      int previousSigns = negative, previousSteps = down;
+      for (const size_t end = len - (len - 1) % 4; ii < end; ii += 4) {
+         const auto x = _mm_loadu_ps(samples + ii);
+         const auto steps = _mm_sub_ps(x, _mm_loadu_ps(samples + ii - 1));
+         // Products of floats are exact in double
+         const auto low = _mm_cvtps_pd(x);
+         const auto high = _mm_cvtps_pd(_mm_movehl_ps(x, x));
+         sums = _mm_add_pd(sums,
+            _mm_add_pd(_mm_mul_pd(low, low), _mm_mul_pd(high, high)));
+
+         const int signs = _mm_movemask_ps(_mm_cmplt_ps(x, zero));
+         result.signChanges += Changes(signs, previousSigns);
+         previousSigns = signs >> 3;
+         const int directions = _mm_movemask_ps(_mm_cmplt_ps(steps, zero));
+         result.directionChanges += Changes(directions, previousSteps);
+         previousSteps = directions >> 3;
+      }
+      alignas(16) double lanes[2];
+      _mm_store_pd(lanes, sums);
+      result.sumSquares += lanes[0] + lanes[1];
+      negative = previousSigns;
+      down = previousSteps;
+   }
+#endif
+
+   // The remainder, or all of the samples when not vectorized
+   for (; ii < len; ++ii) {
+      const auto x = samples[ii];
+      result.sumSquares += static_cast<double>(x) * x;
+      if ((x < 0) != negative) {
+         negative = !negative;
+         ++result.signChanges;
+      }
+      if ((x - samples[ii - 1] < 0) != down) {
+         down = !down;
+         ++result.directionChanges;
+      }
+   }
+   return result;
+}
+
+float SignalFeatures::Peak(const float *samples, size_t len)
+{
+   float peak = 0;
+   size_t ii = 0;
+
+#ifdef SIGNAL_FEATURES_SSE2
+   const auto sign = _mm_set1_ps(-0.0f);
+   auto peaks = _mm_setzero_ps();
+   for (const size_t end = len - len % 4; ii < end; ii += 4)
+      peaks = _mm_max_ps(peaks,
+         _mm_andnot_ps(sign, _mm_loadu_ps(samples + ii)));
+   alignas(16) float lanes[4];
+   _mm_store_ps(lanes, peaks);
+   peak = *std::max_element(lanes, lanes + 4);
+#endif
+
+   for (; ii < len; ++ii)
+      peak = std::max(peak, std::fabs(samples[ii]));
+   return peak;
+}
@@ -0,0 +1,38 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file SignalFeatures.h
+  @brief Statistics of blocks of samples that tell sound from silence
+
+**********************************************************************/
+
+#ifndef __TENACITY_SIGNAL_FEATURES__
+#define __TENACITY_SIGNAL_FEATURES__
+
+#include <cstddef>
+
+//! Energy, zero crossings and changes of direction of a block of samples of
+//! one channel, in one pass over the samples
+/*!
+ The pass uses SSE2 where the compiler targets it; otherwise it is scalar.
+ A sample is negative, and a step between samples goes down, when it is less
+ than zero; so zero counts as positive.
+ */
+struct MATH_API SignalFeatures
+{
+   //! Sum of the squares of the samples, in double precision
+   double sumSquares = 0;
+   //! Number of consecutive pairs of samples of different sign
+   size_t signChanges = 0;
+   //! Number of consecutive steps between samples of different direction;
+   //! the step before the first sample counts as going up
+   size_t directionChanges = 0;
+
+   static SignalFeatures Measure(const float *samples, size_t len);
+
+   //! Greatest absolute value of the samples, or zero if there are none
+   static float Peak(const float *samples, size_t len);
+};
+
+#endif
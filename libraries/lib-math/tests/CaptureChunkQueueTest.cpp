@@ -0,0 +1,143 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file CaptureChunkQueueTest.cpp
+
+ CaptureChunkQueue belongs to the capture journal, but depends only on
+ sample formats, so it is tested here
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <atomic>
+#include <thread>
+
+#include "CaptureChunkQueue.h"
+
+namespace {
+
+constexpr size_t ChunkSamples = 256;
+//! As many as the journal allows
+constexpr size_t MaxChunks = 64;
+
+//! Samples that tell the channel and the position apart
+std::vector<float> Sequence(unsigned channel, size_t start, size_t count)
+{
+   std::vector<float> result(count);
+   for (size_t ii = 0; ii < count; ++ii)
+      result[ii] = float(channel * 100000 + start + ii);
+   return result;
+}
+
+bool Append(CaptureChunkQueue &queue, unsigned channel,
+   const std::vector<float> &data)
+{
+   return queue.Append(channel, reinterpret_cast<constSamplePtr>(data.data()),
+      floatSample, data.size());
+}
+
+}
+
+LIBRARY_TEST(CaptureChunkQueueHoldsAChunkOfManyChannels)
+{
+   // More channels than chunks in the budget, each filling a chunk before
+   // the consumer takes any
+   constexpr unsigned Channels = 96;
+   CaptureChunkQueue queue{ Channels, ChunkSamples, MaxChunks };
+   CHECK(queue.MaxChunksPerChannel() == 2);
+
+   for (unsigned round = 0; round < 2; ++round)
+      for (unsigned channel = 0; channel < Channels; ++channel)
+         CHECK(Append(queue, channel,
+            Sequence(channel, round * ChunkSamples, ChunkSamples)));
+   CHECK(!queue.Overflowed());
+
+   queue.Finish();
+   CaptureChunkQueue::Chunk chunk;
+   std::vector<size_t> popped(Channels);
+   while (queue.Pop(chunk)) {
+      CHECK(chunk.samples == Sequence(chunk.channel,
+         popped[chunk.channel] * ChunkSamples, ChunkSamples));
+      ++popped[chunk.channel];
+      queue.Recycle(std::move(chunk.samples));
+   }
+   for (const auto count : popped)
+      CHECK(count == 2);
+}
+
+LIBRARY_TEST(CaptureChunkQueueOverflowsPerChannel)
+{
+   // One channel that can't be written can't take the budget of the others
+   constexpr unsigned Channels = 4;
+   CaptureChunkQueue queue{ Channels, ChunkSamples, MaxChunks };
+   CHECK(queue.MaxChunksPerChannel() == MaxChunks / Channels);
+
+   for (size_t ii = 0; ii < MaxChunks / Channels; ++ii)
+      CHECK(Append(queue, 0, Sequence(0, ii * ChunkSamples, ChunkSamples)));
+   CHECK(!queue.Overflowed());
+   CHECK(!Append(queue, 0, Sequence(0, 0, ChunkSamples)));
+   CHECK(queue.Overflowed());
+   // Nothing more is taken
+   CHECK(!Append(queue, 1, Sequence(1, 0, ChunkSamples)));
+}
+
+LIBRARY_TEST(CaptureChunkQueueFinishesPartialChunks)
+{
+   CaptureChunkQueue queue{ 2, ChunkSamples, MaxChunks };
+   CHECK(Append(queue, 1, Sequence(1, 0, 100)));
+   CHECK(queue.AppendSilence(0, 10));
+   queue.Finish();
+
+   CaptureChunkQueue::Chunk chunk;
+   CHECK(queue.Pop(chunk));
+   CHECK(chunk.channel == 0);
+   CHECK(chunk.samples == std::vector<float>(10, 0.0f));
+   CHECK(queue.Pop(chunk));
+   CHECK(chunk.channel == 1);
+   CHECK(chunk.samples == Sequence(1, 0, 100));
+   CHECK(!queue.Pop(chunk));
+}
+
+LIBRARY_TEST(CaptureChunkQueueStreamsManyChannels)
+{
+   // A recording of more channels than chunks in the budget, appended in
+   // blocks as the audio engine does, with a consumer that keeps up to
+   // within a chunk of each channel
+   constexpr unsigned Channels = 128;
+   constexpr size_t Block = 100;
+   constexpr size_t Length = 20 * ChunkSamples;
+   CaptureChunkQueue queue{ Channels, ChunkSamples, MaxChunks };
+
+   std::vector<size_t> written(Channels);
+   std::atomic<size_t> totalWritten{ 0 };
+   bool inOrder = true;
+   std::thread consumer{ [&]{
+      CaptureChunkQueue::Chunk chunk;
+      while (queue.Pop(chunk)) {
+         const auto channel = chunk.channel;
+         inOrder = inOrder && chunk.samples ==
+            Sequence(channel, written[channel], chunk.samples.size());
+         written[channel] += chunk.samples.size();
+         totalWritten += chunk.samples.size();
+         queue.Recycle(std::move(chunk.samples));
+      }
+   } };
+
+   bool good = true;
+   for (size_t start = 0; start < Length; start += Block) {
+      while (Channels * start > totalWritten + Channels * ChunkSamples)
+         std::this_thread::yield();
+      for (unsigned channel = 0; channel < Channels; ++channel)
+         good = good && Append(queue, channel,
+            Sequence(channel, start, std::min(Block, Length - start)));
+   }
+   queue.Finish();
+   consumer.join();
+
+   CHECK(good);
+   CHECK(inOrder);
+   for (const auto count : written)
+      CHECK(count == Length);
+}
@@ -0,0 +1,164 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file DitherTest.cpp
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "Dither.h"
+
+namespace {
+
+constexpr size_t Length = 1 << 16;
+
+//! Quantize without dither, as the converters are expected to
+short ToInt16(float sample)
+{
+   const auto x = std::lrint(std::clamp(sample, -1.0f, 1.0f) * 32768.0f);
+   return short(std::clamp(x, -32768L, 32767L));
+}
+
+int ToInt24(float sample)
+{
+   const auto x = std::lrint(std::clamp(sample, -1.0f, 1.0f) * 8388608.0f);
+   return int(std::clamp(x, -8388608L, 8388607L));
+}
+
+std::vector<short> Quantize(DitherType type, const std::vector<float> &input)
+{
+   // The dithers draw from rand(); seed it so every run is the same
+   srand(1);
+   std::vector<short> output(input.size());
+   Dither{}.Apply(type,
+      reinterpret_cast<constSamplePtr>(input.data()), floatSample,
+      reinterpret_cast<samplePtr>(output.data()), int16Sample,
+      input.size());
+   return output;
+}
+
+//! Greatest and mean quantization error, in units of the last bit
+std::pair<double, double> Errors(
+   const std::vector<float> &input, const std::vector<short> &output)
+{
+   double greatest = 0, sum = 0;
+   for (size_t ii = 0; ii < input.size(); ++ii) {
+      const auto error = output[ii] - double(input[ii]) * 32768;
+      greatest = std::max(greatest, std::fabs(error));
+      sum += error;
+   }
+   return { greatest, sum / input.size() };
+}
+
+void CheckReference(const char *name, const std::vector<short> &output)
+{
+   std::vector<float> values(output.begin(), output.end());
+   CHECK_REFERENCE(name, values.data(), values.size(), 0);
+}
+
+}
+
+LIBRARY_TEST(DitherNoneIsRounding)
+{
+   // Include values out of range, to test the clipping
+   const auto input = LibraryTest::Noise(Length, 3, 1.2f);
+   const auto output = Quantize(DitherType::none, input);
+   for (size_t ii = 0; ii < Length; ++ii)
+      CHECK(output[ii] == ToInt16(input[ii]));
+}
+
+LIBRARY_TEST(DitherNoneToInt24)
+{
+   const auto input = LibraryTest::Noise(Length, 4, 1.2f);
+   std::vector<int> output(Length);
+   Dither{}.Apply(DitherType::none,
+      reinterpret_cast<constSamplePtr>(input.data()), floatSample,
+      reinterpret_cast<samplePtr>(output.data()), int24Sample, Length);
+   for (size_t ii = 0; ii < Length; ++ii)
+      CHECK(output[ii] == ToInt24(input[ii]));
+}
+
+LIBRARY_TEST(DitherInt24ToInt16)
+{
+   const auto input = LibraryTest::Noise(Length, 5, 0.9f);
+   std::vector<int> int24(Length);
+   for (size_t ii = 0; ii < Length; ++ii)
+      int24[ii] = ToInt24(input[ii]);
+
+   std::vector<short> output(Length);
+   Dither{}.Apply(DitherType::none,
+      reinterpret_cast<constSamplePtr>(int24.data()), int24Sample,
+      reinterpret_cast<samplePtr>(output.data()), int16Sample, Length);
+   for (size_t ii = 0; ii < Length; ++ii)
+      CHECK(output[ii] == ToInt16(int24[ii] / 8388608.0f));
+}
+
+LIBRARY_TEST(DitherRectangle)
+{
+   const auto input = LibraryTest::Noise(Length, 6, 0.9f);
+   const auto output = Quantize(DitherType::rectangle, input);
+   const auto errors = Errors(input, output);
+   // Half a bit of noise, and half a bit of rounding
+   CHECK(errors.first <= 1.0 + 1e-3);
+   CHECK_NEAR(errors.second, 0, 0.02);
+   CheckReference("DitherRectangle", output);
+}
+
+LIBRARY_TEST(DitherTriangle)
+{
+   const auto input = LibraryTest::Noise(Length, 7, 0.9f);
+   const auto output = Quantize(DitherType::triangle, input);
+   const auto errors = Errors(input, output);
+   CHECK(errors.first <= 1.5 + 1e-3);
+   CHECK_NEAR(errors.second, 0, 0.02);
+   CheckReference("DitherTriangle", output);
+}
+
+LIBRARY_TEST(DitherShaped)
+{
+   const auto input = LibraryTest::Noise(Length, 8, 0.9f);
+   const auto output = Quantize(DitherType::shaped, input);
+   const auto errors = Errors(input, output);
+   // Noise shaping moves the error to high frequencies, making it larger
+   CHECK(errors.first <= 16);
+   CHECK_NEAR(errors.second, 0, 0.05);
+   CheckReference("DitherShaped", output);
+}
+
+namespace {
+
+size_t BenchmarkDither(DitherType type)
+{
+   const auto input = LibraryTest::Noise(1 << 24, 1, 0.9f);
+   LibraryTest::StartTiming();
+   Quantize(type, input);
+   return input.size();
+}
+
+}
+
+LIBRARY_BENCHMARK(DitherNoneToInt16)
+{
+   return BenchmarkDither(DitherType::none);
+}
+
+LIBRARY_BENCHMARK(DitherRectangleToInt16)
+{
+   return BenchmarkDither(DitherType::rectangle);
+}
+
+LIBRARY_BENCHMARK(DitherTriangleToInt16)
+{
+   return BenchmarkDither(DitherType::triangle);
+}
+
+LIBRARY_BENCHMARK(DitherShapedToInt16)
+{
+   return BenchmarkDither(DitherType::shaped);
+}
@@ -0,0 +1,129 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file MeteringTest.cpp
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Metering.h"
+
+namespace {
+
+constexpr float ClipLevel = 0.99f;
+
+//! The per sample loop that meters used before Metering
+std::vector<Metering::Levels> Reference(
+   const std::vector<float> &samples, unsigned numChannels)
+{
+   std::vector<Metering::Levels> result(numChannels);
+   std::vector<double> sums(numChannels);
+   const auto numFrames = samples.size() / numChannels;
+   for (size_t ii = 0; ii < numFrames; ++ii)
+      for (unsigned jj = 0; jj < numChannels; ++jj) {
+         const auto x = samples[ii * numChannels + jj];
+         auto &levels = result[jj];
+         levels.peak = std::max(levels.peak, std::fabs(x));
+         sums[jj] += x * x;
+         if (std::fabs(x) >= ClipLevel) {
+            if (levels.headClipped == ii)
+               ++levels.headClipped;
+            ++levels.tailClipped;
+            levels.longestClipped =
+               std::max(levels.longestClipped, levels.tailClipped);
+         }
+         else
+            levels.tailClipped = 0;
+      }
+   for (unsigned jj = 0; jj < numChannels; ++jj)
+      result[jj].rms =
+         numFrames > 0 ? float(std::sqrt(sums[jj] / numFrames)) : 0;
+   return result;
+}
+
+//! Noise with runs of clipped samples, at the ends too
+std::vector<float> ClippedNoise(size_t count, unsigned seed)
+{
+   auto samples = LibraryTest::Noise(count, seed);
+   for (size_t ii = 0; ii < count; ++ii)
+      if (ii < 5 || ii + 7 >= count || (ii / 3) % 97 == 0)
+         samples[ii] = (ii % 2) ? 1.0f : -1.0f;
+   return samples;
+}
+
+}
+
+LIBRARY_TEST(MeteringMatchesReference)
+{
+   for (unsigned numChannels = 1; numChannels <= 9; ++numChannels)
+      for (size_t numFrames : { 0, 1, 3, 1000, 4099 }) {
+         const auto samples =
+            ClippedNoise(numFrames * numChannels, numChannels);
+         Metering metering{ ClipLevel };
+         const auto &levels = metering.Measure(
+            samples.data(), numChannels, numFrames, false);
+         const auto expected = Reference(samples, numChannels);
+         CHECK(levels.size() == numChannels);
+         for (unsigned jj = 0; jj < numChannels; ++jj) {
+            CHECK(levels[jj].peak == expected[jj].peak);
+            CHECK(levels[jj].truePeak == levels[jj].peak);
+            CHECK_NEAR(levels[jj].rms, expected[jj].rms, 1e-5);
+            CHECK(levels[jj].headClipped == expected[jj].headClipped);
+            CHECK(levels[jj].tailClipped == expected[jj].tailClipped);
+            CHECK(levels[jj].longestClipped == expected[jj].longestClipped);
+         }
+      }
+}
+
+LIBRARY_TEST(MeteringTruePeak)
+{
+   // A quarter of the sample rate, sampled halfway between the peaks
+   constexpr size_t Count = 4096;
+   std::vector<float> samples(2 * Count);
+   for (size_t ii = 0; ii < Count; ++ii) {
+      samples[2 * ii] = float(std::sin(M_PI / 2 * ii + M_PI / 4));
+      samples[2 * ii + 1] = 0.5f;
+   }
+
+   Metering metering{ ClipLevel };
+   const auto &levels = metering.Measure(samples.data(), 2, Count, true);
+   CHECK_NEAR(levels[0].peak, std::sqrt(0.5), 1e-6);
+   CHECK_NEAR(levels[0].truePeak, 1.0, 0.02);
+   // The step from silence at the start overshoots
+   CHECK(levels[1].truePeak > 0.5f);
+
+   // The filter continues across blocks, so a constant signal now passes
+   // through it unchanged
+   metering.Measure(samples.data(), 2, Count / 2, true);
+   CHECK_NEAR(metering.GetLevels()[1].truePeak, 0.5, 0.005);
+   metering.Measure(samples.data() + Count, 2, Count / 2, true);
+   CHECK_NEAR(metering.GetLevels()[0].truePeak, 1.0, 0.02);
+   CHECK_NEAR(metering.GetLevels()[1].truePeak, 0.5, 0.005);
+}
+
+LIBRARY_BENCHMARK(MeteringStereo)
+{
+   constexpr size_t Frames = 512, Repeats = 1 << 12;
+   const auto samples = LibraryTest::Noise(2 * Frames, 1);
+   Metering metering{ ClipLevel };
+   LibraryTest::StartTiming();
+   for (size_t ii = 0; ii < Repeats; ++ii)
+      metering.Measure(samples.data(), 2, Frames, false);
+   return 2 * Frames * Repeats;
+}
+
+LIBRARY_BENCHMARK(MeteringStereoTruePeak)
+{
+   constexpr size_t Frames = 512, Repeats = 1 << 10;
+   const auto samples = LibraryTest::Noise(2 * Frames, 1);
+   Metering metering{ ClipLevel };
+   LibraryTest::StartTiming();
+   for (size_t ii = 0; ii < Repeats; ++ii)
+      metering.Measure(samples.data(), 2, Frames, true);
+   return 2 * Frames * Repeats;
+}
@@ -0,0 +1,144 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file RealFFTfTest.cpp
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "RealFFTf.h"
+
+namespace {
+
+//! Straightforward transform, in double precision, of bins 0 to size/2
+void SlowDFT(const std::vector<float> &input,
+   std::vector<double> &real, std::vector<double> &imag)
+{
+   const auto size = input.size();
+   real.assign(size / 2 + 1, 0);
+   imag.assign(size / 2 + 1, 0);
+   for (size_t k = 0; k <= size / 2; ++k) {
+      for (size_t n = 0; n < size; ++n) {
+         const auto angle = 2 * M_PI * ((k * n) % size) / size;
+         real[k] += input[n] * std::cos(angle);
+         imag[k] -= input[n] * std::sin(angle);
+      }
+   }
+}
+
+}
+
+LIBRARY_TEST(RealFFTfMatchesDFT)
+{
+   for (size_t size = 8; size <= 2048; size *= 2) {
+      const auto input = LibraryTest::Noise(size, size);
+      std::vector<double> expectedReal, expectedImag;
+      SlowDFT(input, expectedReal, expectedImag);
+
+      auto hFFT = GetFFT(size);
+      auto buffer = input;
+      RealFFTf(buffer.data(), hFFT.get());
+      std::vector<float> real(size / 2 + 1), imag(size / 2 + 1);
+      ReorderToFreq(hFFT.get(), buffer.data(), real.data(), imag.data());
+
+      // Rounding error of the float transform grows with the magnitudes of
+      // the bins, which are about sqrt(size) for noise
+      const auto tolerance = 1e-5 * size;
+      for (size_t k = 0; k <= size / 2; ++k)
+         CHECK_NEAR(real[k], expectedReal[k], tolerance);
+
+      // Accept either sign convention for the imaginary parts, but the same
+      // one for all bins
+      double errorMinus = 0, errorPlus = 0;
+      for (size_t k = 0; k <= size / 2; ++k) {
+         errorMinus = std::max(errorMinus, std::fabs(imag[k] - expectedImag[k]));
+         errorPlus = std::max(errorPlus, std::fabs(imag[k] + expectedImag[k]));
+      }
+      CHECK(std::min(errorMinus, errorPlus) <= tolerance);
+
+      CHECK_REFERENCE("RealFFTf" + std::to_string(size),
+         buffer.data(), buffer.size(), 0);
+   }
+}
+
+LIBRARY_TEST(RealFFTfRoundTrip)
+{
+   for (size_t size = 8; size <= 8192; size *= 2) {
+      const auto input = LibraryTest::Noise(size, size);
+      auto hFFT = GetFFT(size);
+
+      auto buffer = input;
+      RealFFTf(buffer.data(), hFFT.get());
+
+      // The inverse takes its input in natural order
+      std::vector<float> real(size / 2 + 1), imag(size / 2 + 1);
+      ReorderToFreq(hFFT.get(), buffer.data(), real.data(), imag.data());
+      for (size_t k = 0; k < size / 2; ++k) {
+         buffer[2 * k] = real[k];
+         buffer[2 * k + 1] = imag[k];
+      }
+      buffer[1] = real[size / 2];
+      InverseRealFFTf(buffer.data(), hFFT.get());
+      std::vector<float> output(size);
+      ReorderToTime(hFFT.get(), buffer.data(), output.data());
+
+      // The round trip scales by a constant; find it by least squares, then
+      // require the output to be the input times that constant
+      double dot = 0, norm = 0;
+      for (size_t n = 0; n < size; ++n) {
+         dot += double(output[n]) * input[n];
+         norm += double(input[n]) * input[n];
+      }
+      const auto scale = dot / norm;
+      CHECK(scale > 0);
+      for (size_t n = 0; n < size; ++n)
+         CHECK_NEAR(output[n] / scale, input[n], 1e-5);
+   }
+}
+
+namespace {
+
+size_t BenchmarkFFT(size_t size, bool inverse)
+{
+   constexpr size_t Total = 1 << 24;
+   auto hFFT = GetFFT(size);
+   const auto input = LibraryTest::Noise(size, 1);
+   std::vector<float> buffer(size);
+   LibraryTest::StartTiming();
+   for (size_t done = 0; done < Total; done += size) {
+      // Start from the same data each time, so values don't grow
+      std::copy(input.begin(), input.end(), buffer.begin());
+      if (inverse)
+         InverseRealFFTf(buffer.data(), hFFT.get());
+      else
+         RealFFTf(buffer.data(), hFFT.get());
+   }
+   return Total;
+}
+
+}
+
+LIBRARY_BENCHMARK(RealFFTf256)
+{
+   return BenchmarkFFT(256, false);
+}
+
+LIBRARY_BENCHMARK(RealFFTf2048)
+{
+   return BenchmarkFFT(2048, false);
+}
+
+LIBRARY_BENCHMARK(RealFFTf16384)
+{
+   return BenchmarkFFT(16384, false);
+}
+
+LIBRARY_BENCHMARK(InverseRealFFTf2048)
+{
+   return BenchmarkFFT(2048, true);
+}
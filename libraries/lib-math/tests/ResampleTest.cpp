@@ -0,0 +1,125 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file ResampleTest.cpp
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Resample.h"
+
+namespace {
+
+constexpr double InRate = 44100;
+constexpr double OutRate = 48000;
+
+//! Feed all of input through resample in blocks, and flush it
+std::vector<float> Convert(
+   Resample &resample, double factor, std::vector<float> input)
+{
+   constexpr size_t BlockSize = 4096;
+   std::vector<float> output;
+   std::vector<float> block(BlockSize * 3);
+   size_t pos = 0;
+   while (true) {
+      const auto len = std::min(BlockSize, input.size() - pos);
+      const bool last = (pos + len == input.size());
+      const auto result = resample.Process(factor, input.data() + pos, len,
+         last, block.data(), block.size());
+      pos += result.first;
+      output.insert(output.end(), block.begin(), block.begin() + result.second);
+      if (last && result.first == len && result.second == 0)
+         break;
+      CHECK(result.first > 0 || result.second > 0);
+   }
+   return output;
+}
+
+double RMS(const float *data, size_t count)
+{
+   double sum = 0;
+   for (size_t ii = 0; ii < count; ++ii)
+      sum += double(data[ii]) * data[ii];
+   return std::sqrt(sum / count);
+}
+
+size_t RisingZeroCrossings(const float *data, size_t count)
+{
+   size_t result = 0;
+   for (size_t ii = 1; ii < count; ++ii)
+      if (data[ii - 1] < 0 && data[ii] >= 0)
+         ++result;
+   return result;
+}
+
+//! Check that a resampled 1 kHz sine keeps its level and frequency
+void CheckSine(const std::vector<float> &output, double rate)
+{
+   // Ignore the filter transients at both ends
+   const size_t margin = rate / 20;
+   CHECK(output.size() > 4 * margin);
+   const auto data = output.data() + margin;
+   const auto count = output.size() - 2 * margin;
+
+   CHECK_NEAR(RMS(data, count), 0.5 / std::sqrt(2.0), 1e-3);
+   CHECK_NEAR(RisingZeroCrossings(data, count), 1000.0 * count / rate, 1.0);
+}
+
+}
+
+LIBRARY_TEST(ResampleConstantRate)
+{
+   const auto input = LibraryTest::Sine(InRate, 1000, InRate, 0.5f);
+   const auto factor = OutRate / InRate;
+   Resample resample{ true, factor, factor };
+   const auto output = Convert(resample, factor, input);
+
+   CHECK_NEAR(output.size(), OutRate, 2);
+   CheckSine(output, OutRate);
+   CHECK_REFERENCE("ResampleConstantRate", output.data(), output.size(), 0);
+}
+
+LIBRARY_TEST(ResampleVariableRate)
+{
+   const auto input = LibraryTest::Sine(InRate, 1000, InRate, 0.5f);
+   Resample resample{ true, 0.5, 2.0 };
+   const auto output = Convert(resample, 2.0, input);
+
+   // The variable rate converter is less exact about the length
+   CHECK_NEAR(output.size(), 2 * InRate, 64);
+   CheckSine(output, 2 * InRate);
+   CHECK_REFERENCE("ResampleVariableRate", output.data(), output.size(), 0);
+}
+
+namespace {
+
+size_t BenchmarkConvert(bool best, double minFactor, double maxFactor)
+{
+   const auto input = LibraryTest::Noise(10 * InRate, 1);
+   Resample resample{ best, minFactor, maxFactor };
+   LibraryTest::StartTiming();
+   Convert(resample, maxFactor, input);
+   return input.size();
+}
+
+}
+
+LIBRARY_BENCHMARK(ResampleBest44To48)
+{
+   return BenchmarkConvert(true, OutRate / InRate, OutRate / InRate);
+}
+
+LIBRARY_BENCHMARK(ResampleFast44To48)
+{
+   return BenchmarkConvert(false, OutRate / InRate, OutRate / InRate);
+}
+
+LIBRARY_BENCHMARK(ResampleVariable44To48)
+{
+   return BenchmarkConvert(true, 0.5, OutRate / InRate);
+}
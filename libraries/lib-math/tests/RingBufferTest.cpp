@@ -0,0 +1,174 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file RingBufferTest.cpp
+
+ RingBuffer belongs to the audio engine, but depends only on sample
+ formats, so it is tested here
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+#include "RingBuffer.h"
+
+namespace {
+
+std::vector<float> Sequence(size_t start, size_t count)
+{
+   // Integers up to 2^24 are exact in float
+   std::vector<float> result(count);
+   for (size_t ii = 0; ii < count; ++ii)
+      result[ii] = float((start + ii) % (1 << 24));
+   return result;
+}
+
+size_t Put(RingBuffer &buffer, const std::vector<float> &data,
+   size_t padding = 0)
+{
+   return buffer.Put(reinterpret_cast<constSamplePtr>(data.data()),
+      floatSample, data.size(), padding);
+}
+
+std::vector<float> Get(RingBuffer &buffer, size_t count)
+{
+   std::vector<float> result(count);
+   result.resize(buffer.Get(
+      reinterpret_cast<samplePtr>(result.data()), floatSample, count));
+   return result;
+}
+
+//! Move count samples through a buffer, with one thread putting and another
+//! getting, in chunks of random sizes; returns whether all arrived in order
+bool Stream(size_t bufferSize, size_t count, size_t maxChunk)
+{
+   RingBuffer buffer{ floatSample, bufferSize };
+
+   std::thread producer{ [&]{
+      std::mt19937 engine{ 1 };
+      size_t written = 0;
+      while (written < count) {
+         const auto chunk = std::min<size_t>(
+            { 1 + engine() % maxChunk, count - written, buffer.AvailForPut() });
+         if (chunk == 0) {
+            std::this_thread::yield();
+            continue;
+         }
+         written += Put(buffer, Sequence(written, chunk));
+         buffer.Flush();
+      }
+   } };
+
+   std::mt19937 engine{ 2 };
+   bool ok = true;
+   size_t read = 0;
+   while (read < count) {
+      const auto chunk = std::min<size_t>(
+         { 1 + engine() % maxChunk, buffer.AvailForGet() });
+      if (chunk == 0) {
+         std::this_thread::yield();
+         continue;
+      }
+      const auto data = Get(buffer, chunk);
+      ok = ok && data == Sequence(read, data.size());
+      read += data.size();
+   }
+
+   producer.join();
+   return ok;
+}
+
+}
+
+LIBRARY_TEST(RingBufferCapacity)
+{
+   RingBuffer buffer{ floatSample, 1000 };
+   // A few samples are always kept free
+   CHECK(buffer.AvailForPut() == 996);
+   CHECK(buffer.AvailForGet() == 0);
+
+   CHECK(Put(buffer, Sequence(0, 2000)) == 996);
+   CHECK(buffer.AvailForPut() == 0);
+}
+
+LIBRARY_TEST(RingBufferFlush)
+{
+   RingBuffer buffer{ floatSample, 1000 };
+   CHECK(Put(buffer, Sequence(0, 100)) == 100);
+   // Not visible to the reader yet
+   CHECK(buffer.AvailForGet() == 0);
+   buffer.Flush();
+   CHECK(buffer.AvailForGet() == 100);
+}
+
+LIBRARY_TEST(RingBufferWrapAround)
+{
+   RingBuffer buffer{ floatSample, 1000 };
+   for (size_t start = 0; start < 7000; start += 700) {
+      CHECK(Put(buffer, Sequence(start, 700)) == 700);
+      buffer.Flush();
+      CHECK(Get(buffer, 1000) == Sequence(start, 700));
+   }
+}
+
+LIBRARY_TEST(RingBufferPaddingAndDiscard)
+{
+   RingBuffer buffer{ floatSample, 1000 };
+   CHECK(Put(buffer, Sequence(1, 10), 5) == 15);
+   buffer.Flush();
+   CHECK(buffer.Discard(4) == 4);
+
+   auto expected = Sequence(5, 6);
+   expected.resize(11, 0.0f);
+   CHECK(Get(buffer, 100) == expected);
+}
+
+LIBRARY_TEST(RingBufferConvertsFormat)
+{
+   // Stored as float, put and got as 16 bit, without loss
+   RingBuffer buffer{ floatSample, 1000 };
+   std::vector<short> input(500);
+   for (size_t ii = 0; ii < input.size(); ++ii)
+      input[ii] = short(ii * 131 - 32768);
+   buffer.Put(reinterpret_cast<constSamplePtr>(input.data()), int16Sample,
+      input.size());
+   buffer.Flush();
+
+   std::vector<short> output(input.size());
+   CHECK(buffer.Get(reinterpret_cast<samplePtr>(output.data()), int16Sample,
+      output.size()) == output.size());
+   CHECK(output == input);
+}
+
+LIBRARY_TEST(RingBufferTwoThreads)
+{
+   CHECK(Stream(1000, 1 << 20, 300));
+}
+
+LIBRARY_BENCHMARK(RingBufferOneThread)
+{
+   constexpr size_t Total = 1 << 26, Chunk = 4096;
+   RingBuffer buffer{ floatSample, 4 * Chunk };
+   const auto input = LibraryTest::Noise(Chunk, 1);
+   std::vector<float> output(Chunk);
+   LibraryTest::StartTiming();
+   for (size_t done = 0; done < Total; done += Chunk) {
+      Put(buffer, input);
+      buffer.Flush();
+      buffer.Get(reinterpret_cast<samplePtr>(output.data()), floatSample,
+         Chunk);
+   }
+   return Total;
+}
+
+LIBRARY_BENCHMARK(RingBufferTwoThreads)
+{
+   constexpr size_t Total = 1 << 24;
+   CHECK(Stream(1 << 16, Total, 4096));
+   return Total;
+}
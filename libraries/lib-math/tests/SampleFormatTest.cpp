@@ -0,0 +1,155 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file SampleFormatTest.cpp
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <cstring>
+
+#include "SampleFormat.h"
+
+namespace {
+
+constexpr size_t Length = 1 << 16;
+
+std::vector<short> Int16Ramp()
+{
+   std::vector<short> result(Length);
+   for (size_t ii = 0; ii < Length; ++ii)
+      result[ii] = short(int(ii) - 32768);
+   return result;
+}
+
+}
+
+LIBRARY_TEST(SampleFormatInt16ToFloat)
+{
+   // Every 16 bit value
+   const auto input = Int16Ramp();
+   std::vector<float> output(Length);
+   SamplesToFloats(reinterpret_cast<constSamplePtr>(input.data()),
+      int16Sample, output.data(), Length);
+   for (size_t ii = 0; ii < Length; ++ii)
+      CHECK(output[ii] == input[ii] / 32768.0f);
+}
+
+LIBRARY_TEST(SampleFormatInt24ToFloat)
+{
+   std::vector<int> input(Length);
+   for (size_t ii = 0; ii < Length; ++ii)
+      input[ii] = int(ii * 256 + ii % 256) - (1 << 23);
+   std::vector<float> output(Length);
+   SamplesToFloats(reinterpret_cast<constSamplePtr>(input.data()),
+      int24Sample, output.data(), Length);
+   for (size_t ii = 0; ii < Length; ++ii)
+      CHECK(output[ii] == input[ii] / 8388608.0f);
+}
+
+LIBRARY_TEST(SampleFormatInt16RoundTrip)
+{
+   // Conversion to float and back, without dither, is lossless
+   const auto input = Int16Ramp();
+   std::vector<float> floats(Length);
+   SamplesToFloats(reinterpret_cast<constSamplePtr>(input.data()),
+      int16Sample, floats.data(), Length);
+
+   std::vector<short> output(Length);
+   CopySamples(reinterpret_cast<constSamplePtr>(floats.data()), floatSample,
+      reinterpret_cast<samplePtr>(output.data()), int16Sample, Length,
+      DitherType::none);
+   CHECK(output == input);
+}
+
+LIBRARY_TEST(SampleFormatInt16ToInt24)
+{
+   const auto input = Int16Ramp();
+   std::vector<int> output(Length);
+   CopySamples(reinterpret_cast<constSamplePtr>(input.data()), int16Sample,
+      reinterpret_cast<samplePtr>(output.data()), int24Sample, Length,
+      DitherType::none);
+   for (size_t ii = 0; ii < Length; ++ii)
+      CHECK(output[ii] == input[ii] * 256);
+}
+
+LIBRARY_TEST(SampleFormatStrides)
+{
+   // Deinterleave the second of three channels, and interleave it again
+   const auto input = LibraryTest::Noise(3 * Length, 9);
+   std::vector<float> channel(Length);
+   SamplesToFloats(reinterpret_cast<constSamplePtr>(input.data() + 1),
+      floatSample, channel.data(), Length, 3, 1);
+   for (size_t ii = 0; ii < Length; ++ii)
+      CHECK(channel[ii] == input[3 * ii + 1]);
+
+   std::vector<float> output(2 * Length);
+   CopySamples(reinterpret_cast<constSamplePtr>(channel.data()), floatSample,
+      reinterpret_cast<samplePtr>(output.data() + 1), floatSample, Length,
+      DitherType::none, 1, 2);
+   for (size_t ii = 0; ii < Length; ++ii) {
+      CHECK(output[2 * ii] == 0);
+      CHECK(output[2 * ii + 1] == channel[ii]);
+   }
+}
+
+LIBRARY_TEST(SampleFormatClearAndReverse)
+{
+   auto data = Int16Ramp();
+   const auto original = data;
+   const auto ptr = reinterpret_cast<samplePtr>(data.data());
+
+   ReverseSamples(ptr, int16Sample, 10, 101);
+   for (size_t ii = 0; ii < 101; ++ii)
+      CHECK(data[10 + ii] == original[110 - ii]);
+   ReverseSamples(ptr, int16Sample, 10, 101);
+   CHECK(data == original);
+
+   ClearSamples(ptr, int16Sample, 100, 50);
+   for (size_t ii = 0; ii < Length; ++ii)
+      CHECK(data[ii] == (ii >= 100 && ii < 150 ? 0 : original[ii]));
+}
+
+namespace {
+
+template<typename Sample>
+size_t BenchmarkCopy(sampleFormat srcFormat, sampleFormat dstFormat,
+   unsigned srcStride = 1)
+{
+   constexpr size_t Samples = 1 << 24;
+   const auto noise = LibraryTest::Noise(Samples * srcStride, 1, 0.9f);
+   std::vector<Sample> input(noise.size());
+   CopySamples(reinterpret_cast<constSamplePtr>(noise.data()), floatSample,
+      reinterpret_cast<samplePtr>(input.data()), srcFormat, noise.size(),
+      DitherType::none);
+
+   std::vector<char> output(Samples * SAMPLE_SIZE(dstFormat));
+   LibraryTest::StartTiming();
+   CopySamples(reinterpret_cast<constSamplePtr>(input.data()), srcFormat,
+      output.data(), dstFormat, Samples, DitherType::none, srcStride, 1);
+   return Samples;
+}
+
+}
+
+LIBRARY_BENCHMARK(CopyInt16ToFloat)
+{
+   return BenchmarkCopy<short>(int16Sample, floatSample);
+}
+
+LIBRARY_BENCHMARK(CopyInt24ToFloat)
+{
+   return BenchmarkCopy<int>(int24Sample, floatSample);
+}
+
+LIBRARY_BENCHMARK(CopyFloatToInt16)
+{
+   return BenchmarkCopy<float>(floatSample, int16Sample);
+}
+
+LIBRARY_BENCHMARK(CopyDeinterleaveFloat)
+{
+   return BenchmarkCopy<float>(floatSample, floatSample, 2);
+}
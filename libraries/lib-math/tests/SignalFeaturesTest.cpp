@@ -0,0 +1,102 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file SignalFeaturesTest.cpp
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "SignalFeatures.h"
+
+namespace {
+
+int Sign(float x)
+{
+   return x < 0 ? -1 : 1;
+}
+
+//! The per sample loops that the voice key used before SignalFeatures
+SignalFeatures Reference(const std::vector<float> &samples)
+{
+   SignalFeatures result;
+   if (samples.empty())
+      return result;
+   int sign = Sign(samples[0]);
+   int direction = 1;
+   float last = samples[0];
+   for (const auto x : samples) {
+      result.sumSquares += static_cast<double>(x) * x;
+      if (Sign(x) != sign) {
+         sign = Sign(x);
+         ++result.signChanges;
+      }
+      if (Sign(x - last) != direction) {
+         direction = Sign(x - last);
+         ++result.directionChanges;
+      }
+      last = x;
+   }
+   return result;
+}
+
+//! Noise with runs of zeroes and of repeated values
+std::vector<float> Flattened(size_t count, unsigned seed)
+{
+   auto samples = LibraryTest::Noise(count, seed);
+   for (size_t ii = 0; ii < count; ++ii)
+      if ((ii / 5) % 7 == 0)
+         samples[ii] = 0;
+      else if ((ii / 3) % 11 == 0)
+         samples[ii] = 0.25f;
+   return samples;
+}
+
+}
+
+LIBRARY_TEST(SignalFeaturesMatchReference)
+{
+   for (size_t count : { 0, 1, 2, 4, 5, 6, 9, 441, 1000, 4099 })
+      for (unsigned seed = 1; seed <= 3; ++seed) {
+         const auto samples = Flattened(count, seed);
+         const auto features =
+            SignalFeatures::Measure(samples.data(), samples.size());
+         const auto expected = Reference(samples);
+         CHECK_NEAR(features.sumSquares, expected.sumSquares,
+            1e-12 * std::max(1.0, expected.sumSquares));
+         CHECK(features.signChanges == expected.signChanges);
+         CHECK(features.directionChanges == expected.directionChanges);
+
+         float peak = 0;
+         for (const auto x : samples)
+            peak = std::max(peak, std::fabs(x));
+         CHECK(SignalFeatures::Peak(samples.data(), samples.size()) == peak);
+      }
+}
+
+LIBRARY_TEST(SignalFeaturesOfSine)
+{
+   // 100 Hz for one second crosses zero twice and turns twice in a cycle
+   const auto samples = LibraryTest::Sine(44100, 100, 44100, 0.5f);
+   const auto features =
+      SignalFeatures::Measure(samples.data(), samples.size());
+   CHECK_NEAR(features.sumSquares, 0.125 * samples.size(), 1e-6 * 44100);
+   CHECK_NEAR(features.signChanges, 200, 1);
+   CHECK_NEAR(features.directionChanges, 200, 1);
+   CHECK_NEAR(SignalFeatures::Peak(samples.data(), samples.size()), 0.5, 1e-4);
+}
+
+LIBRARY_BENCHMARK(SignalFeaturesMeasure)
+{
+   constexpr size_t Count = 441, Repeats = 1 << 14;
+   const auto samples = LibraryTest::Noise(Count, 1);
+   size_t changes = 0;
+   LibraryTest::StartTiming();
+   for (size_t ii = 0; ii < Repeats; ++ii)
+      changes += SignalFeatures::Measure(samples.data(), Count).signChanges;
+   return changes > 0 ? Count * Repeats : 0;
+}
@@ -0,0 +1,132 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file SpectrumTest.cpp
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "FFT.h"
+#include "Spectrum.h"
+
+namespace {
+
+constexpr double Rate = 44100;
+
+//! The same averaging of windowed power spectra, by slow transforms
+std::vector<double> SlowSpectrum(
+   const std::vector<float> &data, size_t windowSize)
+{
+   const auto half = windowSize / 2;
+   std::vector<double> power(half, 0);
+   unsigned windows = 0;
+   for (size_t start = 0; start + windowSize <= data.size(); start += half) {
+      std::vector<float> in(data.begin() + start,
+         data.begin() + start + windowSize);
+      WindowFunc(eWinFuncHann, windowSize, in.data());
+      for (size_t k = 0; k < half; ++k) {
+         double real = 0, imag = 0;
+         for (size_t n = 0; n < windowSize; ++n) {
+            const auto angle = 2 * M_PI * ((k * n) % windowSize) / windowSize;
+            real += in[n] * std::cos(angle);
+            imag -= in[n] * std::sin(angle);
+         }
+         power[k] += real * real + imag * imag;
+      }
+      ++windows;
+   }
+   for (auto &value : power)
+      value = 10 * std::log10(value / windowSize / windows);
+   return power;
+}
+
+}
+
+LIBRARY_TEST(SpectrumMatchesSlowSpectrum)
+{
+   constexpr size_t WindowSize = 512;
+   auto data = LibraryTest::Sine(4 * WindowSize, 3000, Rate, 0.5f);
+   const auto noise = LibraryTest::Noise(data.size(), 7, 0.01f);
+   for (size_t ii = 0; ii < data.size(); ++ii)
+      data[ii] += noise[ii];
+
+   std::vector<float> output(WindowSize / 2);
+   CHECK(ComputeSpectrum(data.data(), data.size(), WindowSize, Rate,
+      output.data(), false, eWinFuncHann));
+   const auto expected = SlowSpectrum(data, WindowSize);
+
+   for (size_t k = 0; k < output.size(); ++k)
+      CHECK_NEAR(output[k], expected[k], 0.02);
+
+   CHECK_REFERENCE("Spectrum", output.data(), output.size(), 0);
+}
+
+LIBRARY_TEST(SpectrumFindsSinePeak)
+{
+   constexpr size_t WindowSize = 1024;
+   constexpr size_t Bin = 100;
+   const auto data = LibraryTest::Sine(
+      8 * WindowSize, Bin * Rate / WindowSize, Rate);
+
+   std::vector<float> output(WindowSize / 2);
+   CHECK(ComputeSpectrum(data.data(), data.size(), WindowSize, Rate,
+      output.data(), false, eWinFuncHann));
+   const auto peak = std::max_element(output.begin(), output.end());
+   CHECK(size_t(peak - output.begin()) == Bin);
+}
+
+LIBRARY_TEST(SpectrumAutocorrelation)
+{
+   constexpr size_t WindowSize = 1024;
+   const auto data = LibraryTest::Sine(8 * WindowSize, 441, Rate, 0.5f);
+
+   std::vector<float> output(WindowSize / 2);
+   CHECK(ComputeSpectrum(data.data(), data.size(), WindowSize, Rate,
+      output.data(), true, eWinFuncHann));
+   for (auto value : output)
+      CHECK(std::isfinite(value) && value >= 0);
+
+   CHECK_REFERENCE("SpectrumAutocorrelation",
+      output.data(), output.size(), 0);
+}
+
+LIBRARY_TEST(SpectrumTooShort)
+{
+   std::vector<float> data(100), output(128);
+   CHECK(!ComputeSpectrum(data.data(), data.size(), 256, Rate,
+      output.data(), false, eWinFuncHann));
+}
+
+namespace {
+
+size_t BenchmarkSpectrum(size_t windowSize, bool autocorrelation)
+{
+   const auto data = LibraryTest::Noise(10 * Rate, 1);
+   std::vector<float> output(windowSize / 2);
+   LibraryTest::StartTiming();
+   ComputeSpectrum(data.data(), data.size(), windowSize, Rate,
+      output.data(), autocorrelation, eWinFuncHann);
+   return data.size();
+}
+
+}
+
+LIBRARY_BENCHMARK(Spectrum1024)
+{
+   return BenchmarkSpectrum(1024, false);
+}
+
+LIBRARY_BENCHMARK(Spectrum8192)
+{
+   return BenchmarkSpectrum(8192, false);
+}
+
+LIBRARY_BENCHMARK(SpectrumAutocorrelation1024)
+{
+   return BenchmarkSpectrum(1024, true);
+}
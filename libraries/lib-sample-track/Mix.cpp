@@ -23,7 +23,9 @@
 
 #include "Mix.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "float_cast.h"
 #include "Resample.h"
@@ -32,6 +34,7 @@
 #include "Envelope.h"
 #include "SampleTrack.h"
 #include "SampleTrackCache.h"
+#include "SampleTrackPrefetch.h"
 
 Mixer::WarpOptions::WarpOptions(const TrackList &list)
 : envelope(DefaultWarp::Call(list)), minSpeed(0.0), maxSpeed(0.0)
@@ -188,6 +191,17 @@ void Mixer::Clear()
    }
 }
 
+const float *Mixer::GetFloats(SampleTrackCache &cache,
+                             sampleCount start, size_t len)
+{
+   if (mPrefetch && len <= mPrefetched.size()) {
+      const auto iTrack = &cache - mInputTrack.get();
+      if (mPrefetch->Get(mPrefetchIndices[iTrack], start, len, mPrefetched.data()))
+         return mPrefetched.data();
+   }
+   return cache.GetFloats(start, len, mMayThrow);
+}
+
 static void MixBuffers(unsigned numChannels, int *channelFlags, float *gains,
                 const float *src, Floats *dests,
                 int len, bool interleaved)
@@ -286,7 +300,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, SampleTrackCache &cache,
          if (getLen > 0) {
             if (backwards) {
                auto results =
-                  cache.GetFloats(*pos - (getLen - 1), getLen, mMayThrow);
+                  GetFloats(cache, *pos - (getLen - 1), getLen);
                if (results)
                   memcpy(&queue[*queueLen], results, sizeof(float) * getLen);
                else
@@ -298,7 +312,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, SampleTrackCache &cache,
                *pos -= getLen;
             }
             else {
-               auto results = cache.GetFloats(*pos, getLen, mMayThrow);
+               auto results = GetFloats(cache, *pos, getLen);
                if (results)
                   memcpy(&queue[*queueLen], results, sizeof(float) * getLen);
                else
@@ -415,7 +429,7 @@ size_t Mixer::MixSameRate(int *channelFlags, SampleTrackCache &cache,
    );
 
    if (backwards) {
-      auto results = cache.GetFloats(*pos - (slen - 1), slen, mMayThrow);
+      auto results = GetFloats(cache, *pos - (slen - 1), slen);
       if (results)
          memcpy(mFloatBuffer.get(), results, sizeof(float) * slen);
       else
@@ -428,7 +442,7 @@ size_t Mixer::MixSameRate(int *channelFlags, SampleTrackCache &cache,
       *pos -= slen;
    }
    else {
-      auto results = cache.GetFloats(*pos, slen, mMayThrow);
+      auto results = GetFloats(cache, *pos, slen);
       if (results)
          memcpy(mFloatBuffer.get(), results, sizeof(float) * slen);
       else
@@ -453,6 +467,18 @@ size_t Mixer::MixSameRate(int *channelFlags, SampleTrackCache &cache,
 }
 
 size_t Mixer::Process(size_t maxToProcess)
+{
+   if (mLoopState == LoopState::Replaying)
+      return Replay(maxToProcess);
+
+   const auto maxOut = Mix(maxToProcess);
+   if (mLoopState == LoopState::Recording)
+      Record(maxOut);
+   ConvertOutput(maxOut);
+   return maxOut;
+}
+
+size_t Mixer::Mix(size_t maxToProcess)
 {
    // MB: this is wrong! mT represented warped time, and mTime is too inaccurate to use
    // it here. It's also unnecessary I think.
@@ -510,6 +536,17 @@ size_t Mixer::Process(size_t maxToProcess)
          // forwards (the usual)
          mTime = std::min(std::max(t, mTime), mT1);
    }
+   if (mFadePos < mFadeLen)
+      ApplyCrossfade(maxOut);
+
+   // MB: this doesn't take warping into account, replaced with code based on mSamplePos
+   //mT += (maxOut / mRate);
+
+   return maxOut;
+}
+
+void Mixer::ConvertOutput(size_t maxOut)
+{
    if(mInterleaved) {
       for(size_t c=0; c<mNumChannels; c++) {
          CopySamples((constSamplePtr)(mTemp[0].get() + c),
@@ -532,10 +569,6 @@ size_t Mixer::Process(size_t maxToProcess)
             mHighQuality ? gHighQualityDither : gLowQualityDither);
       }
    }
-   // MB: this doesn't take warping into account, replaced with code based on mSamplePos
-   //mT += (maxOut / mRate);
-
-   return maxOut;
 }
 
 constSamplePtr Mixer::GetBuffer()
@@ -554,6 +587,14 @@ double Mixer::MixGetCurrentTime()
 }
 
 void Mixer::Restart()
+{
+   mLoopState = LoopState::None;
+   mLoopCache.clear();
+
+   Rewind();
+}
+
+void Mixer::Rewind()
 {
    mTime = mT0;
 
@@ -573,6 +614,11 @@ void Mixer::Restart()
 
 void Mixer::Reposition(double t, bool bSkipping)
 {
+   // A seek breaks the recording or replaying of a loop; the next return to
+   // the start of the loop records again
+   mLoopState = LoopState::None;
+   mLoopCache.clear();
+
    mTime = t;
    const bool backwards = (mT1 < mT0);
    if (backwards)
@@ -633,6 +679,221 @@ void Mixer::SetSpeedForKeyboardScrubbing(double speed, double startTime)
    mSpeed = fabs(speed);
 }
 
+namespace {
+//! Length of the crossfade into the start of a loop replayed from memory
+constexpr double LoopCrossfade = 0.01;
+}
+
+void Mixer::RestartLoop(size_t maxFrames)
+{
+   if ((mLoopState == LoopState::Recording ||
+        mLoopState == LoopState::Replaying) && LoopEdited()) {
+      // Mix the edited tracks, and record them again
+      for (size_t i = 0; i < mNumInputTracks; i++)
+         mInputTrack[i].Invalidate();
+      mLoopState = LoopState::None;
+      mLoopCache.clear();
+   }
+
+   switch (mLoopState) {
+   case LoopState::None:
+      Rewind();
+      if (maxFrames > 0) {
+         // Record the pass that begins now
+         const auto channels = mInterleaved ? mNumChannels : 1;
+         mLoopCache.resize(mNumBuffers);
+         for (auto &cache : mLoopCache) {
+            cache.clear();
+            cache.reserve(maxFrames * channels);
+         }
+         mLoopFrames = maxFrames;
+         mLoopHashes.resize(mNumInputTracks);
+         for (size_t i = 0; i < mNumInputTracks; i++)
+            mLoopHashes[i] = mInputTrack[i].GetTrack()->GetContentHash();
+         mLoopState = LoopState::Recording;
+      }
+      break;
+   case LoopState::Recording:
+      // The whole pass is recorded
+      CrossfadeLoop();
+      mLoopState = LoopState::Replaying;
+      mLoopPos = 0;
+      break;
+   case LoopState::Replaying:
+      mLoopPos = 0;
+      break;
+   case LoopState::TooLong:
+      Rewind();
+      break;
+   }
+}
+
+bool Mixer::LoopEdited() const
+{
+   for (size_t i = 0; i < mNumInputTracks; i++)
+      if (mInputTrack[i].GetTrack()->GetContentHash() != mLoopHashes[i])
+         return true;
+   return false;
+}
+
+void Mixer::Record(size_t len)
+{
+   const auto channels = mInterleaved ? mNumChannels : 1;
+   if (mLoopCache[0].size() / channels + len > mLoopFrames) {
+      // Mix every pass as usual
+      mLoopState = LoopState::TooLong;
+      mLoopCache.clear();
+      return;
+   }
+   for (unsigned int c = 0; c < mNumBuffers; c++)
+      mLoopCache[c].insert(mLoopCache[c].end(),
+         mTemp[c].get(), mTemp[c].get() + len * channels);
+}
+
+size_t Mixer::Replay(size_t maxToProcess)
+{
+   const auto channels = mInterleaved ? mNumChannels : 1;
+   const auto frames = mLoopCache[0].size() / channels;
+   const auto len = std::min({ maxToProcess, mBufferSize, frames - mLoopPos });
+   for (unsigned int c = 0; c < mNumBuffers; c++)
+      std::copy_n(mLoopCache[c].data() + mLoopPos * channels,
+         len * channels, mTemp[c].get());
+   mLoopPos += len;
+   ConvertOutput(len);
+   return len;
+}
+
+void Mixer::CrossfadeLoop()
+{
+   // Blend the end of the pass into what precedes the start of the loop,
+   // which then continues seamlessly into the start
+   const auto channels = mInterleaved ? mNumChannels : 1;
+   const auto frames = mLoopCache[0].size() / channels;
+   const auto len = std::min({ frames, mBufferSize,
+      std::max<size_t>(1, lrint(mRate * LoopCrossfade)) });
+   const bool backwards = (mT1 < mT0);
+   const double start = backwards
+      ? mT0 + len / mRate
+      : mT0 - len / mRate;
+   if (start < 0)
+      return;
+
+   mTime = start;
+   for (size_t i = 0; i < mNumInputTracks; i++) {
+      mSamplePos[i] = mInputTrack[i].GetTrack()->TimeToLongSamples(start);
+      mQueueStart[i] = 0;
+      mQueueLen[i] = 0;
+   }
+   MakeResamplers();
+   mFadeLen = mFadePos = 0;
+   const auto produced = Mix(len);
+
+   for (unsigned int c = 0; c < mNumBuffers; c++) {
+      const auto dest = mLoopCache[c].data() + (frames - produced) * channels;
+      const auto lead = mTemp[c].get();
+      for (size_t i = 0; i < produced; i++) {
+         const float in = (i + 0.5f) / produced;
+         for (unsigned int j = 0; j < channels; j++) {
+            auto &sample = dest[i * channels + j];
+            sample = sample * (1.0f - in) + lead[i * channels + j] * in;
+         }
+      }
+   }
+}
+
+namespace {
+//! Drift of scrubbing from where the mixer got to, that is played through
+//! rather than jumped over
+constexpr double MaxScrubDrift = 0.01;
+//! Length of the crossfade when scrubbing jumps
+constexpr double ScrubCrossfade = 0.005;
+}
+
+void Mixer::ContinueTimesAndSpeed(double t0, double t1, double speed)
+{
+   wxASSERT(std::isfinite(speed));
+   const bool backwards = (t1 < t0);
+
+   // Where the resamplers got to is behind the queued samples
+   bool contiguous = (backwards == (mT1 < mT0));
+   for (size_t i = 0; contiguous && i < mNumInputTracks; i++) {
+      const auto rate = mInputTrack[i].GetTrack()->GetRate();
+      const auto position = backwards
+         ? mSamplePos[i] + mQueueLen[i]
+         : mSamplePos[i] - mQueueLen[i];
+      contiguous = fabs(position.as_double() / rate - t0) <= MaxScrubDrift;
+   }
+
+   if (!contiguous)
+      RenderFadeOut();
+
+   // Don't stop reading at t1, which would flush the resamplers at the end
+   // of each scrub interval
+   mT0 = t0;
+   mT1 = backwards ? 0 : std::numeric_limits<double>::max();
+   mSpeed = fabs(speed);
+
+   if (!contiguous) {
+      Reposition(t0);
+      // Reuse the resamplers, rather than make new ones
+      for (size_t i = 0; i < mNumInputTracks; i++)
+         mResample[i]->Reset();
+   }
+}
+
+void Mixer::RenderFadeOut()
+{
+   // Continue the old segment a little, into a buffer of the crossfade
+   const auto len = std::min(mBufferSize,
+      std::max<size_t>(1, lrint(mRate * ScrubCrossfade)));
+   const auto produced = Process(len);
+
+   const auto samples = mInterleaved ? produced * mNumChannels : produced;
+   mFadeOut.resize(mNumBuffers);
+   for (unsigned int c = 0; c < mNumBuffers; c++)
+      mFadeOut[c].assign(mTemp[c].get(), mTemp[c].get() + samples);
+   mFadeLen = produced;
+   mFadePos = 0;
+}
+
+void Mixer::ApplyCrossfade(size_t len)
+{
+   const auto count = std::min(len, mFadeLen - mFadePos);
+   const auto channels = mInterleaved ? mNumChannels : 1;
+   for (unsigned int c = 0; c < mNumBuffers; c++) {
+      const auto fadeOut = mFadeOut[c].data() + mFadePos * channels;
+      const auto dest = mTemp[c].get();
+      for (size_t i = 0; i < count; i++) {
+         const float in = (mFadePos + i + 0.5f) / mFadeLen;
+         for (unsigned int j = 0; j < channels; j++) {
+            auto &sample = dest[i * channels + j];
+            sample = sample * in + fadeOut[i * channels + j] * (1.0f - in);
+         }
+      }
+   }
+   mFadePos += count;
+}
+
+void Mixer::SetPrefetch(std::shared_ptr<SampleTrackPrefetch> prefetch)
+{
+   mPrefetch = std::move(prefetch);
+   mPrefetchIndices.clear();
+   if (mPrefetch) {
+      for (size_t i = 0; i < mNumInputTracks; i++)
+         mPrefetchIndices.push_back(
+            mPrefetch->Find(*mInputTrack[i].GetTrack()));
+      mPrefetched.resize(std::max(mQueueMaxLen, mInterleavedBufferSize));
+   }
+}
+
+SampleTrackConstArray Mixer::GetInputTracks() const
+{
+   SampleTrackConstArray tracks;
+   for (size_t i = 0; i < mNumInputTracks; i++)
+      tracks.push_back(mInputTrack[i].GetTrack());
+   return tracks;
+}
+
 MixerSpec::MixerSpec( unsigned numTracks, unsigned maxNumChannels )
 {
    mNumTracks = mNumChannels = numTracks;
@@ -23,6 +23,7 @@
 #include "GlobalVariable.h"
 #include "SampleFormat.h"
 #include <functional>
+#include <memory>
 #include <vector>
 
 class sampleCount;
@@ -32,6 +33,7 @@ class TrackList;
 class SampleTrack;
 using SampleTrackConstArray = std::vector < std::shared_ptr < const SampleTrack > >;
 class SampleTrackCache;
+class SampleTrackPrefetch;
 
 class SAMPLE_TRACK_API MixerSpec
 {
@@ -110,6 +112,14 @@ class SAMPLE_TRACK_API Mixer {
    /// Process() is called.
    void Restart();
 
+   /// For looping, instead of Restart() at each return to the start.
+   /// The first time, restarts and keeps the output of the pass that
+   /// follows in memory, if it is no more than maxFrames; later passes are
+   /// replayed from there, with the end crossfaded into what precedes the
+   /// start, instead of being mixed again.  If the tracks were edited since
+   /// the pass was kept, it is mixed and kept again.
+   void RestartLoop(size_t maxFrames);
+
    /// Reposition processing to absolute time next time
    /// Process() is called.
    void Reposition(double t, bool bSkipping = false);
@@ -119,6 +129,19 @@ class SAMPLE_TRACK_API Mixer {
    void SetSpeedForPlayAtSpeed(double speed);
    void SetSpeedForKeyboardScrubbing(double speed, double startTime);
 
+   /// Used in scrubbing instead of SetTimesAndSpeed(), when playback of t0
+   /// to t1 may continue what was played before.  If t0 is where the mixer
+   /// got to, in the same direction, its queued samples and resampler state
+   /// are kept; otherwise it jumps to t0, crossfading from where it was.
+   /// Processing doesn't stop at t1: the caller limits the output.
+   void ContinueTimesAndSpeed(double t0, double t1, double speed);
+
+   /// Read the input tracks from the windows of prefetch when they hold the
+   /// samples; pass null to stop
+   void SetPrefetch(std::shared_ptr<SampleTrackPrefetch> prefetch);
+
+   SampleTrackConstArray GetInputTracks() const;
+
    /// Current time in seconds (unwarped, i.e. always between startTime and stopTime)
    /// This value is not accurate, it's useful for progress bars and indicators, but nothing else.
    double MixGetCurrentTime();
@@ -132,6 +155,18 @@ class SAMPLE_TRACK_API Mixer {
  private:
 
    void Clear();
+   void Rewind();
+   size_t Mix(size_t maxToProcess);
+   void ConvertOutput(size_t maxOut);
+   //! Whether the content of the tracks changed since the loop was recorded
+   bool LoopEdited() const;
+   void Record(size_t len);
+   size_t Replay(size_t maxToProcess);
+   void CrossfadeLoop();
+   const float *GetFloats(SampleTrackCache &cache,
+                          sampleCount start, size_t len);
+   void RenderFadeOut();
+   void ApplyCrossfade(size_t len);
    size_t MixSameRate(int *channelFlags, SampleTrackCache &cache,
                            sampleCount *pos);
 
@@ -180,6 +215,26 @@ class SAMPLE_TRACK_API Mixer {
    bool             mHighQuality;
    std::vector<double> mMinFactor, mMaxFactor;
 
+   // Scrubbing
+   std::shared_ptr<SampleTrackPrefetch> mPrefetch;
+   std::vector<int> mPrefetchIndices;
+   std::vector<float> mPrefetched;
+   //! Continuation of the segment before a jump, faded out under the
+   //! start of the next
+   std::vector<std::vector<float>> mFadeOut;
+   size_t           mFadeLen{ 0 };
+   size_t           mFadePos{ 0 };
+
+   // Looping
+   enum class LoopState { None, Recording, Replaying, TooLong };
+   LoopState        mLoopState{ LoopState::None };
+   //! Output of one pass of the loop, for each buffer
+   std::vector<std::vector<float>> mLoopCache;
+   //! SampleTrack::GetContentHash() of each track, when recording began
+   std::vector<size_t> mLoopHashes;
+   size_t           mLoopFrames{ 0 };
+   size_t           mLoopPos{ 0 };
+
    const bool       mMayThrow;
 };
 
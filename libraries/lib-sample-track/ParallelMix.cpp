@@ -0,0 +1,228 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file ParallelMix.cpp
+
+**********************************************************************/
+
+#include "ParallelMix.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include "MemoryX.h"
+#include "SampleTrack.h"
+
+namespace {
+
+//! Frames mixed before each segment but the first, and after each but the
+//! last, then dropped, so that the resamplers have the input around the
+//! boundary that they have in one pass
+constexpr size_t WarmUpFrames = 1 << 12;
+//! Segments that may be mixed ahead of the one being appended, per thread
+constexpr size_t SegmentsPerThread = 2;
+
+struct Segment
+{
+   std::vector<SampleBuffer> buffers;
+   size_t length{ 0 };
+   bool done{ false };
+   std::exception_ptr error;
+};
+
+//! Output frames between the frames that are at whole samples of every
+//! track, or 1 if they are too far apart or the rates are not whole
+/*!
+ A resampler that starts between two samples of its track would produce the
+ whole segment shifted by a fraction of a sample, compared with one pass.
+ */
+size_t AlignmentFrames(const SampleTrackConstArray &tracks, double rate)
+{
+   const auto outRate = std::llround(rate);
+   if (outRate <= 0 || outRate != rate)
+      return 1;
+   long long result = 1;
+   for (const auto &pTrack : tracks) {
+      const auto trackRate = pTrack->GetRate();
+      const auto inRate = std::llround(trackRate);
+      if (inRate <= 0 || inRate != trackRate)
+         return 1;
+      result = std::lcm(result, outRate / std::gcd(outRate, inRate));
+      if (result > static_cast<long long>(ParallelMixSegmentFrames))
+         return 1;
+   }
+   return result;
+}
+
+//! Mix from t0 to t1 into the float buffers of a segment, dropping the
+//! first warmUp frames, and keeping no more than capacity frames
+/*!
+ The mixer doesn't convert to the output format, because dithering uses
+ state shared by all threads
+ */
+void MixSegment(const SampleTrackConstArray &tracks, double rate,
+   unsigned numChannels, size_t blockLen,
+   double t0, double t1, size_t warmUp, size_t capacity, bool last,
+   Segment &segment)
+{
+   constexpr auto format = floatSample;
+   Mixer mixer(tracks, true, Mixer::WarpOptions{ 0.0, 0.0 }, t0, t1,
+      numChannels, blockLen, false, rate, format);
+
+   const auto size = SAMPLE_SIZE(format);
+   for (auto &buffer : segment.buffers)
+      buffer.Allocate(capacity, format);
+   size_t skipped = 0, filled = 0;
+   while (filled < capacity) {
+      const auto produced = mixer.Process(blockLen);
+      if (produced == 0)
+         break;
+      const auto skip = std::min(produced, warmUp - skipped);
+      skipped += skip;
+      const auto count = std::min(produced - skip, capacity - filled);
+      for (unsigned c = 0; c < numChannels; ++c)
+         CopySamples(mixer.GetBuffer(c) + skip * size, format,
+            segment.buffers[c].ptr() + filled * size, format, count,
+            DitherType::none);
+      filled += count;
+   }
+   if (!last) {
+      // Rounding of the end time may leave the mixer a frame short; the
+      // next segment starts at a fixed frame, so fill the gap
+      for (auto &buffer : segment.buffers)
+         ClearSamples(buffer.ptr(), format, filled, capacity - filled);
+      filled = capacity;
+   }
+   segment.length = filled;
+}
+
+}
+
+bool MixInParallel(const SampleTrackConstArray &tracks,
+   double rate, sampleFormat format, double startTime, double endTime,
+   unsigned numThreads, size_t blockLen, unsigned numChannels,
+   const std::function<
+      void(unsigned channel, constSamplePtr buffer, size_t len)> &append,
+   const std::function<bool(double done)> &poll)
+{
+   const auto totalFrames = static_cast<size_t>(
+      std::max(0.0, std::round((endTime - startTime) * rate)));
+   const auto numSegments =
+      (totalFrames + ParallelMixSegmentFrames - 1) / ParallelMixSegmentFrames;
+   const auto maxAhead = SegmentsPerThread * numThreads;
+   const auto alignment = AlignmentFrames(tracks, rate);
+
+   std::vector<Segment> segments(numSegments);
+   std::mutex mutex;
+   std::condition_variable segmentDone, segmentTaken;
+   size_t next = 0, appended = 0;
+   bool stopping = false;
+
+   const auto work = [&]{
+      while (true) {
+         size_t iSegment;
+         {
+            std::unique_lock<std::mutex> lock{ mutex };
+            // Don't mix too far ahead, which would only use memory
+            segmentTaken.wait(lock, [&]{ return stopping ||
+               next >= numSegments || next < appended + maxAhead; });
+            if (stopping || next >= numSegments)
+               return;
+            iSegment = next++;
+         }
+         auto &segment = segments[iSegment];
+         const bool last = (iSegment + 1 == numSegments);
+         const auto first = iSegment * ParallelMixSegmentFrames;
+         // Start at least WarmUpFrames early, where the tracks have whole
+         // samples, and not before the start
+         const auto warmUp = first < WarmUpFrames
+            ? first
+            : WarmUpFrames + (first - WarmUpFrames) % alignment;
+         // The last segment mixes until the mixer stops, as when mixing
+         // in one pass; the others mix on past their end, as far as that
+         const auto capacity = last
+            ? totalFrames - first + blockLen
+            : ParallelMixSegmentFrames;
+         const auto t0 = startTime + (first - warmUp) / rate;
+         const auto t1 = last
+            ? endTime
+            : std::min(endTime, startTime +
+               (first + ParallelMixSegmentFrames + WarmUpFrames) / rate);
+         segment.buffers.resize(numChannels);
+         std::exception_ptr error;
+         try {
+            MixSegment(tracks, rate, numChannels,
+               blockLen, t0, t1, warmUp, capacity, last, segment);
+         }
+         catch (...) {
+            error = std::current_exception();
+         }
+         {
+            std::lock_guard<std::mutex> lock{ mutex };
+            segment.error = error;
+            segment.done = true;
+         }
+         segmentDone.notify_all();
+      }
+   };
+
+   std::vector<std::thread> threads;
+   const auto stop = finally([&]{
+      {
+         std::lock_guard<std::mutex> lock{ mutex };
+         stopping = true;
+      }
+      segmentTaken.notify_all();
+      for (auto &thread : threads)
+         thread.join();
+   });
+   for (unsigned ii = 0; ii < std::min<size_t>(numThreads, numSegments); ++ii)
+      threads.emplace_back(work);
+
+   // Converted, with dither, on this thread, one segment after another
+   SampleBuffer converted;
+   if (format != floatSample)
+      converted.Allocate(ParallelMixSegmentFrames + blockLen, format);
+
+   bool going = true;
+   size_t framesAppended = 0;
+   while (going && appended < numSegments) {
+      auto &segment = segments[appended];
+      bool done;
+      {
+         std::unique_lock<std::mutex> lock{ mutex };
+         // Wake up now and then to keep the progress dialog responsive
+         done = segmentDone.wait_for(lock, std::chrono::milliseconds(100),
+            [&]{ return segment.done; });
+      }
+      if (done) {
+         if (segment.error)
+            std::rethrow_exception(segment.error);
+         for (unsigned c = 0; c < numChannels; ++c) {
+            if (format == floatSample)
+               append(c, segment.buffers[c].ptr(), segment.length);
+            else {
+               CopySamples(segment.buffers[c].ptr(), floatSample,
+                  converted.ptr(), format, segment.length);
+               append(c, converted.ptr(), segment.length);
+            }
+         }
+         framesAppended += segment.length;
+         segment.buffers.clear();
+         {
+            std::lock_guard<std::mutex> lock{ mutex };
+            ++appended;
+         }
+         segmentTaken.notify_all();
+      }
+      going = poll(framesAppended / rate);
+   }
+   return going;
+}
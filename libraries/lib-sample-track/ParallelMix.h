@@ -0,0 +1,47 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file ParallelMix.h
+  @brief Mixing of long spans of tracks by several threads
+
+**********************************************************************/
+
+#ifndef __TENACITY_PARALLEL_MIX__
+#define __TENACITY_PARALLEL_MIX__
+
+#include <functional>
+
+#include "Mix.h"
+
+//! Output frames in each part of the timeline that one thread mixes
+constexpr size_t ParallelMixSegmentFrames = 1 << 18;
+
+//! Mix from startTime to endTime with several threads, each mixing its own
+//! segments of the timeline with its own Mixer
+/*!
+ The result is that of one Mixer over the whole span, to within rounding,
+ also when resampling.  Every segment but the first is mixed from a little
+ before it, and every one but the last until a little after it, so that the
+ resamplers at the boundaries have the same input as in one pass.
+
+ The threads mix in float.  This thread converts to format, with the high
+ quality dither, as it appends.
+
+ The time must not be warped.
+
+ @param append called on this thread for each channel of each segment, in
+ order
+ @param poll called on this thread now and then with the seconds of output
+ appended; returns false to stop mixing
+ @return false if poll stopped mixing
+ Rethrows any exception from mixing.
+ */
+SAMPLE_TRACK_API bool MixInParallel(const SampleTrackConstArray &tracks,
+   double rate, sampleFormat format, double startTime, double endTime,
+   unsigned numThreads, size_t blockLen, unsigned numChannels,
+   const std::function<
+      void(unsigned channel, constSamplePtr buffer, size_t len)> &append,
+   const std::function<bool(double done)> &poll);
+
+#endif
@@ -0,0 +1,112 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file PlaybackHistory.cpp
+
+**********************************************************************/
+
+#include "PlaybackHistory.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "SampleTrack.h"
+
+void PlaybackHistory::Reset(
+   const SampleTrackConstArray &tracks, double rate, size_t capacity)
+{
+   // In case allocation throws
+   Invalidate();
+   mEntries.resize(tracks.size());
+   for (size_t ii = 0; ii < tracks.size(); ++ii) {
+      auto &entry = mEntries[ii];
+      entry.track = tracks[ii];
+      entry.hash = tracks[ii]->GetContentHash();
+      entry.samples.resize(capacity);
+      entry.kept = 0;
+   }
+   mRate = rate;
+   mCapacity = capacity;
+   mEnd = 0;
+   mEndTime = 0;
+   mInvalid.store(capacity == 0, std::memory_order_relaxed);
+}
+
+void PlaybackHistory::Invalidate()
+{
+   mInvalid.store(true, std::memory_order_relaxed);
+}
+
+void PlaybackHistory::BeginSlice(double t0, double t1, size_t frames)
+{
+   // Allow for rounding in the accumulation of times
+   const double tolerance = 0.5 / mRate;
+   const bool follows = mEnd == 0 || std::fabs(t0 - mEndTime) < tolerance;
+   mSliceAtSpeed = mCapacity > 0 &&
+      std::fabs((t1 - t0) - frames / mRate) < tolerance;
+   if (!follows || !mSliceAtSpeed)
+      for (auto &entry : mEntries)
+         entry.kept = 0;
+   mSliceFrames = frames;
+   mEndTime = t1;
+}
+
+void PlaybackHistory::Put(
+   size_t iTrack, const float *samples, size_t produced)
+{
+   if (iTrack >= mEntries.size())
+      return;
+   auto &entry = mEntries[iTrack];
+   if (!mSliceAtSpeed || produced < mSliceFrames) {
+      entry.kept = 0;
+      return;
+   }
+
+   // Only the last mCapacity frames of a long slice are kept
+   const auto skip = mSliceFrames - std::min(mSliceFrames, mCapacity);
+   samples += skip;
+   auto position = static_cast<size_t>((mEnd + skip) % mCapacity);
+   for (auto remaining = mSliceFrames - skip; remaining > 0;) {
+      const auto count = std::min(remaining, mCapacity - position);
+      std::copy_n(samples, count, entry.samples.data() + position);
+      samples += count;
+      remaining -= count;
+      position = 0;
+   }
+   entry.kept = std::min(mCapacity, entry.kept + mSliceFrames);
+}
+
+void PlaybackHistory::EndSlice()
+{
+   mEnd += mSliceFrames;
+   mSliceFrames = 0;
+}
+
+bool PlaybackHistory::Get(
+   const SampleTrack &track, double t0, size_t len, float *buffer) const
+{
+   if (mInvalid.load(std::memory_order_relaxed))
+      return false;
+   const auto pEntry = std::find_if(mEntries.begin(), mEntries.end(),
+      [&](const Entry &entry){ return entry.track.lock().get() == &track; });
+   // The samples kept are those of the track as it was when playback began
+   if (pEntry == mEntries.end() || pEntry->hash != track.GetContentHash())
+      return false;
+
+   // Frames back from the end to t0
+   const auto back = std::llround((mEndTime - t0) * mRate);
+   if (back < static_cast<long long>(len) ||
+       back > static_cast<long long>(pEntry->kept))
+      return false;
+
+   auto position = static_cast<size_t>((mEnd - back) % mCapacity);
+   while (len > 0) {
+      const auto count = std::min(len, mCapacity - position);
+      std::copy_n(pEntry->samples.data() + position, count, buffer);
+      buffer += count;
+      len -= count;
+      position = 0;
+   }
+   return true;
+}
@@ -0,0 +1,93 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file PlaybackHistory.h
+  @brief The last samples produced for playback of tracks, kept in memory
+
+**********************************************************************/
+
+#ifndef __TENACITY_PLAYBACK_HISTORY__
+#define __TENACITY_PLAYBACK_HISTORY__
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class SampleTrack;
+using SampleTrackConstArray =
+   std::vector < std::shared_ptr < const SampleTrack > >;
+
+//! Keeps the last samples produced for playback of each of some tracks, and
+//! the track times they were produced for
+/*!
+ A later playback of the same tracks, from a time that is still kept, can
+ take samples from memory instead of reading and mixing the tracks again, as
+ for the pre-roll of punch and roll recording.
+
+ Slices are kept while they follow one another in track time, at the speed
+ of the sample rate.  A jump, as for looping or seeking, begins the run again
+ from the slice; another speed, as for time warping, begins it after the
+ slice.
+
+ Samples of a track are not given again once its content changes, as
+ found by SampleTrack::GetContentHash().  Other changes to the project, as of
+ the selection, leave them valid.
+
+ Only one thread at a time calls the methods, except Invalidate().
+ */
+class SAMPLE_TRACK_API PlaybackHistory
+{
+public:
+   //! Forget what is kept, and keep up to capacity frames of each track from
+   //! now on.  Allocates.  Call from the thread that edits the tracks
+   void Reset(
+      const SampleTrackConstArray &tracks, double rate, size_t capacity);
+
+   //! Forget what is kept until the next Reset(), because the tracks may
+   //! have changed.  Called from any thread
+   void Invalidate();
+
+   //! Begin a slice of frames, produced for track times from t0 to t1
+   void BeginSlice(double t0, double t1, size_t frames);
+   //! Samples of the iTrack-th track for the slice, to be given for each
+   //! track in each slice.  If fewer than the frames of the slice, the rest
+   //! are silence, and the track's run begins again after the slice
+   void Put(size_t iTrack, const float *samples, size_t produced);
+   void EndSlice();
+
+   //! Sample rate of the frames kept
+   double GetRate() const { return mRate; }
+
+   //! Copy len frames of track from time t0, if they are all kept, and the
+   //! track is unchanged since Reset().  Call from the thread that edits the
+   //! tracks
+   bool Get(const SampleTrack &track, double t0, size_t len, float *buffer)
+      const;
+
+private:
+   struct Entry
+   {
+      std::weak_ptr<const SampleTrack> track;
+      //! The track's content hash at Reset()
+      size_t hash{ 0 };
+      //! A ring of mCapacity frames
+      std::vector<float> samples;
+      //! How many of the frames before mEnd are a run
+      size_t kept{ 0 };
+   };
+
+   std::vector<Entry> mEntries;
+   double mRate{ 0 };
+   size_t mCapacity{ 0 };
+   //! Frames of all slices since Reset()
+   long long mEnd{ 0 };
+   //! Track time at mEnd
+   double mEndTime{ 0 };
+   size_t mSliceFrames{ 0 };
+   //! Whether the slice is at the speed of the sample rate
+   bool mSliceAtSpeed{ false };
+   std::atomic<bool> mInvalid{ true };
+};
+
+#endif
@@ -0,0 +1,87 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file PlaybackSlots.cpp
+
+**********************************************************************/
+
+#include "PlaybackSlots.h"
+
+#include <algorithm>
+
+void PlaybackSlots::Reset(size_t nSlots)
+{
+   mSize = std::min(nSlots, MaxSlots);
+   mReserved = mRetired = mProducing = 0;
+   mAdded.store(0, std::memory_order_relaxed);
+   mRetiring.store(0, std::memory_order_relaxed);
+   mPlaying.store(0, std::memory_order_relaxed);
+   mDraining.store(0, std::memory_order_relaxed);
+   mFreed.store(0, std::memory_order_relaxed);
+}
+
+size_t PlaybackSlots::Reserve(size_t count)
+{
+   // Take back the slots that the consumer emptied
+   const auto freed = mFreed.exchange(0, std::memory_order_acquire);
+   mReserved &= ~freed;
+   mRetired &= ~freed;
+
+   if (count == 0 || count > mSize)
+      return mSize;
+   const auto bits = (count == MaxSlots) ? ~Mask{ 0 } : Bit(count) - 1;
+   for (size_t first = 0; first + count <= mSize; ++first)
+      if (!(mReserved & (bits << first))) {
+         mReserved |= bits << first;
+         return first;
+      }
+   return mSize;
+}
+
+void PlaybackSlots::Add(size_t first, size_t count)
+{
+   Mask bits = 0;
+   for (auto slot = first; slot < first + count; ++slot)
+      bits |= Bit(slot);
+   // Release what the main thread put in the slots
+   mAdded.fetch_or(bits & mReserved, std::memory_order_release);
+}
+
+void PlaybackSlots::Retire(size_t slot)
+{
+   if (slot >= mSize || !(Active() & Bit(slot)))
+      return;
+   mRetired |= Bit(slot);
+   mRetiring.fetch_or(Bit(slot), std::memory_order_release);
+}
+
+auto PlaybackSlots::Take() -> Changes
+{
+   return {
+      mAdded.exchange(0, std::memory_order_acquire),
+      mRetiring.exchange(0, std::memory_order_acquire)
+   };
+}
+
+void PlaybackSlots::Publish(const Changes &changes)
+{
+   // A slot may have been added and retired before it was taken; it is
+   // freed without having been played
+   const auto draining = (mProducing | changes.added) & changes.retired;
+   mProducing = (mProducing | changes.added) & ~changes.retired;
+   // Store the slots to play before those to drain, so that the consumer,
+   // loading them in the other order, never plays a slot it drains
+   mPlaying.store(mProducing, std::memory_order_release);
+   if (draining)
+      mDraining.fetch_or(draining, std::memory_order_release);
+}
+
+void PlaybackSlots::Free(Mask slots)
+{
+   if (!slots)
+      return;
+   mDraining.fetch_and(~slots, std::memory_order_relaxed);
+   // Release the emptying of the buffers to the main thread
+   mFreed.fetch_or(slots, std::memory_order_release);
+}
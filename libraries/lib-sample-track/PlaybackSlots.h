@@ -0,0 +1,99 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file PlaybackSlots.h
+  @brief Hand-over of spare playback slots among the main thread, the
+  thread that fills playback buffers, and the thread that empties them
+
+**********************************************************************/
+
+#ifndef __TENACITY_PLAYBACK_SLOTS__
+#define __TENACITY_PLAYBACK_SLOTS__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//! Lock-free states of a fixed number of spare playback slots, shared by
+//! three threads
+/*!
+ Each slot stands for a track and a ring buffer that the caller keeps in
+ fixed-size arrays.  A slot goes around these states:
+
+ - The main thread reserves it while free, fills it, and adds it.
+ - The producer takes it, prepares to fill its buffer, and publishes it.  The
+   consumer then plays it.
+ - The main thread retires it.  The producer stops filling its buffer, and
+   the consumer discards what the buffer still holds and frees it.  The main
+   thread may then reserve it again, with an empty buffer.
+
+ The slots that change together are published in one mask, so the channels
+ of a track begin and end together.
+ */
+class SAMPLE_TRACK_API PlaybackSlots
+{
+public:
+   using Mask = std::uint32_t;
+   static constexpr size_t MaxSlots = 32;
+
+   static constexpr Mask Bit(size_t slot) { return Mask{ 1 } << slot; }
+
+   //! Make the slots free.  Call while the other threads don't use them
+   void Reset(size_t nSlots);
+   size_t Size() const { return mSize; }
+
+   // Main thread
+
+   //! @return the first of count consecutive free slots, now reserved, or
+   //! Size() if there are none
+   size_t Reserve(size_t count);
+   //! Hand reserved slots to the producer
+   void Add(size_t first, size_t count);
+   //! Have an added slot freed, if not yet retired
+   void Retire(size_t slot);
+   //! Slots reserved and not yet retired
+   Mask Active() const { return mReserved & ~mRetired; }
+
+   // Producer thread
+
+   struct Changes
+   {
+      Mask added{ 0 };
+      Mask retired{ 0 };
+   };
+   //! Slots added and retired since the last call.  Prepare the added ones,
+   //! then Publish() the changes
+   Changes Take();
+   void Publish(const Changes &changes);
+   //! Slots whose buffers the producer fills
+   Mask Producing() const { return mProducing; }
+
+   // Consumer thread
+
+   //! Slots whose buffers to empty and then Free().  Call before Playing()
+   Mask Draining() const { return mDraining.load(std::memory_order_acquire); }
+   void Free(Mask slots);
+   Mask Playing() const { return mPlaying.load(std::memory_order_acquire); }
+
+private:
+   size_t mSize{ 0 };
+
+   // Only for the main thread
+   Mask mReserved{ 0 };
+   Mask mRetired{ 0 };
+
+   // Only for the producer
+   Mask mProducing{ 0 };
+
+   //! From the main thread to the producer
+   std::atomic<Mask> mAdded{ 0 };
+   std::atomic<Mask> mRetiring{ 0 };
+   //! From the producer to the consumer
+   std::atomic<Mask> mPlaying{ 0 };
+   std::atomic<Mask> mDraining{ 0 };
+   //! From the consumer to the main thread
+   std::atomic<Mask> mFreed{ 0 };
+};
+
+#endif
@@ -42,6 +42,11 @@ public:
    //! Takes gain and pan into account
    virtual float GetChannelGain(int channel) const = 0;
 
+   //! Changes when what the mixer reads may have changed: samples, clips,
+   //! their times, or envelopes, but not selection, name, gain or pan.
+   //! Cheap enough to compare at each return to the start of a loop
+   virtual size_t GetContentHash() const = 0;
+
    //! This returns a nonnegative number of samples meant to size a memory buffer
    virtual size_t GetBestBlockSize(sampleCount t) const = 0;
 
@@ -42,6 +42,9 @@ public:
    const std::shared_ptr<const SampleTrack>& GetTrack() const { return mPTrack; }
    void SetTrack(const std::shared_ptr<const SampleTrack> &pTrack);
 
+   //! Forget the samples held, after an edit of the track
+   void Invalidate() { mNValidBuffers = 0; }
+
    //! Retrieve samples as floats from the track or from the memory cache
    /*! Uses fillZero always
     @return null on failure; this object owns the memory; may be invalidated if GetFloats() is called again
@@ -0,0 +1,137 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file SampleTrackPrefetch.cpp
+
+**********************************************************************/
+
+#include "SampleTrackPrefetch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "SampleTrack.h"
+
+SampleTrackPrefetch::SampleTrackPrefetch(
+   const SampleTrackConstArray &tracks, double duration)
+   : mDuration{ duration }
+   , mEntries(tracks.size())
+{
+   for (size_t ii = 0; ii < tracks.size(); ++ii)
+      mEntries[ii].track = tracks[ii];
+   mWorker = std::thread{ [this]{ Run(); } };
+}
+
+SampleTrackPrefetch::~SampleTrackPrefetch()
+{
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mStopping = true;
+   }
+   mCondition.notify_one();
+   mWorker.join();
+}
+
+int SampleTrackPrefetch::Find(const SampleTrack &track) const
+{
+   for (size_t ii = 0; ii < mEntries.size(); ++ii)
+      if (mEntries[ii].track.get() == &track)
+         return int(ii);
+   return -1;
+}
+
+void SampleTrackPrefetch::SetTarget(double t, bool backwards)
+{
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mTarget = t;
+      mBackwards = backwards;
+      mPending = true;
+   }
+   mCondition.notify_one();
+}
+
+bool SampleTrackPrefetch::Get(
+   int iTrack, sampleCount start, size_t len, float *buffer)
+{
+   if (iTrack < 0 || iTrack >= int(mEntries.size()))
+      return false;
+   std::unique_lock<std::mutex> lock{ mMutex, std::try_to_lock };
+   if (!lock.owns_lock())
+      return false;
+   const auto &window = mEntries[iTrack].front;
+   if (start < window.start || start + len > window.end())
+      return false;
+   std::copy_n(
+      window.samples.data() + (start - window.start).as_size_t(),
+      len, buffer);
+   return true;
+}
+
+void SampleTrackPrefetch::Run()
+{
+   std::unique_lock<std::mutex> lock{ mMutex };
+   while (true) {
+      mCondition.wait(lock, [this]{ return mStopping || mPending; });
+      if (mStopping)
+         break;
+      mPending = false;
+      const auto t = mTarget;
+      const auto backwards = mBackwards;
+      lock.unlock();
+      for (auto &entry : mEntries)
+         Fill(entry, t, backwards);
+      lock.lock();
+   }
+}
+
+void SampleTrackPrefetch::Fill(Entry &entry, double t, bool backwards)
+{
+   const auto &track = *entry.track;
+   const auto rate = track.GetRate();
+   const size_t len = std::max(1.0, std::round(mDuration * rate));
+   // Three quarters of the window lie ahead of the target
+   const sampleCount behind = len / 4;
+   const sampleCount ahead = len - behind.as_size_t();
+   const sampleCount center = std::llround(t * rate);
+   const sampleCount start = std::max(
+      sampleCount{ 0 }, backwards ? center - ahead : center - behind);
+   const auto end = start + len;
+
+   auto &back = entry.back;
+   sampleCount overlapStart, overlapEnd;
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      const auto &front = entry.front;
+      overlapStart = std::max(start, front.start);
+      overlapEnd = std::min(end, front.end());
+      // Don't bother for a small move
+      if (overlapEnd > overlapStart &&
+          (overlapEnd - overlapStart).as_size_t() >= len - len / 8)
+         return;
+      back.start = start;
+      back.samples.resize(len);
+      if (overlapEnd > overlapStart)
+         std::copy_n(
+            front.samples.data() + (overlapStart - front.start).as_size_t(),
+            (overlapEnd - overlapStart).as_size_t(),
+            back.samples.data() + (overlapStart - start).as_size_t());
+      else
+         overlapStart = overlapEnd = end;
+   }
+
+   // Read what the old window didn't hold, before and after the overlap.
+   // Failure to read gives zeroes, as when playing
+   if (overlapStart > start)
+      track.GetFloats(back.samples.data(), start,
+         (overlapStart - start).as_size_t(), fillZero, false);
+   if (end > overlapEnd)
+      track.GetFloats(
+         back.samples.data() + (overlapEnd - start).as_size_t(), overlapEnd,
+         (end - overlapEnd).as_size_t(), fillZero, false);
+
+   std::lock_guard<std::mutex> lock{ mMutex };
+   std::swap(entry.front, back);
+}
@@ -0,0 +1,90 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file SampleTrackPrefetch.h
+  @brief Windows of track samples kept in memory around a moving position
+
+**********************************************************************/
+
+#ifndef __TENACITY_SAMPLE_TRACK_PREFETCH__
+#define __TENACITY_SAMPLE_TRACK_PREFETCH__
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SampleCount.h"
+
+class SampleTrack;
+using SampleTrackConstArray =
+   std::vector < std::shared_ptr < const SampleTrack > >;
+
+//! Keeps a window of the samples of each of some tracks in memory, around a
+//! position that may jump, such as the cursor when scrubbing
+/*!
+ A worker thread reads the tracks, so that a reader that follows the
+ position rarely waits for the samples to be fetched from storage.  When the
+ position moves, what the windows already hold is kept, and only the rest is
+ read.
+
+ The tracks must not change while this object lives.
+ */
+class SAMPLE_TRACK_API SampleTrackPrefetch
+{
+public:
+   //! @param duration seconds of each track to keep
+   SampleTrackPrefetch(const SampleTrackConstArray &tracks, double duration);
+   ~SampleTrackPrefetch();
+
+   SampleTrackPrefetch(const SampleTrackPrefetch&) = delete;
+   SampleTrackPrefetch &operator=(const SampleTrackPrefetch&) = delete;
+
+   //! @return the index of the track for Get(), or -1 if it is not one of
+   //! the tracks
+   int Find(const SampleTrack &track) const;
+
+   //! Move the windows to hold time t, and more of what follows it in the
+   //! direction of movement.  Returns at once
+   void SetTarget(double t, bool backwards);
+
+   //! Copy samples of a track if its window holds all of them
+   /*! Never waits for the worker thread: returns false if it is busy, or if
+    the samples are not held, and then the caller reads the track instead */
+   bool Get(int iTrack, sampleCount start, size_t len, float *buffer);
+
+private:
+   struct Window
+   {
+      sampleCount start{ 0 };
+      std::vector<float> samples;
+      sampleCount end() const { return start + samples.size(); }
+   };
+   struct Entry
+   {
+      std::shared_ptr<const SampleTrack> track;
+      //! Read by Get(); guarded by mMutex
+      Window front;
+      //! Filled by the worker, then swapped with front
+      Window back;
+   };
+
+   void Run();
+   void Fill(Entry &entry, double t, bool backwards);
+
+   const double mDuration;
+   std::vector<Entry> mEntries;
+
+   std::mutex mMutex;
+   std::condition_variable mCondition;
+   double mTarget{ 0 };
+   bool mBackwards{ false };
+   bool mPending{ false };
+   bool mStopping{ false };
+
+   std::thread mWorker;
+};
+
+#endif
@@ -0,0 +1,120 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file EnvelopeTest.cpp
+
+ Envelope belongs to lib-track; the mixer applies it to every sample, so it
+ is tested and timed with the mixer
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <cmath>
+
+#include "Envelope.h"
+
+namespace {
+
+//! Points at times 1 and 3, with values 0.5 and 1.5
+Envelope MakeEnvelope(bool exponential)
+{
+   Envelope envelope{ exponential, 0.01, 2.0, 1.0 };
+   envelope.InsertOrReplace(1.0, 0.5);
+   envelope.InsertOrReplace(3.0, 1.5);
+   return envelope;
+}
+
+}
+
+LIBRARY_TEST(EnvelopeDefaultValue)
+{
+   Envelope envelope{ false, 0.0, 2.0, 0.75 };
+   CHECK(envelope.GetValue(-1.0) == 0.75);
+   CHECK(envelope.GetValue(100.0) == 0.75);
+}
+
+LIBRARY_TEST(EnvelopeLinear)
+{
+   const auto envelope = MakeEnvelope(false);
+   // Constant outside of the points
+   CHECK_NEAR(envelope.GetValue(0.0), 0.5, 1e-12);
+   CHECK_NEAR(envelope.GetValue(5.0), 1.5, 1e-12);
+   CHECK_NEAR(envelope.GetValue(1.5), 0.75, 1e-12);
+   CHECK_NEAR(envelope.GetValue(2.0), 1.0, 1e-12);
+}
+
+LIBRARY_TEST(EnvelopeExponential)
+{
+   const auto envelope = MakeEnvelope(true);
+   // Interpolation is linear in the logarithm
+   CHECK_NEAR(envelope.GetValue(2.0), std::sqrt(0.5 * 1.5), 1e-12);
+}
+
+LIBRARY_TEST(EnvelopeGetValues)
+{
+   for (bool exponential : { false, true }) {
+      const auto envelope = MakeEnvelope(exponential);
+      constexpr int Count = 4000;
+      constexpr double Step = 0.001;
+      std::vector<double> values(Count);
+      envelope.GetValues(values.data(), Count, 0.0, Step);
+      for (int ii = 0; ii < Count; ++ii)
+         CHECK_NEAR(values[ii], envelope.GetValue(ii * Step), 1e-9);
+
+      const std::vector<float> floats(values.begin(), values.end());
+      CHECK_REFERENCE(exponential
+         ? "EnvelopeGetValuesExponential" : "EnvelopeGetValuesLinear",
+         floats.data(), floats.size(), 0);
+   }
+}
+
+LIBRARY_TEST(EnvelopeIntegrals)
+{
+   const auto envelope = MakeEnvelope(false);
+   CHECK_NEAR(envelope.Integral(0.0, 1.0), 0.5, 1e-12);
+   CHECK_NEAR(envelope.Integral(1.0, 3.0), 2.0, 1e-12);
+   CHECK_NEAR(envelope.Integral(3.0, 4.0), 1.5, 1e-12);
+
+   // Solving for the time reverses integration of the inverse
+   for (double t = 0.25; t < 4.0; t += 0.25) {
+      const auto area = envelope.IntegralOfInverse(0.0, t);
+      CHECK_NEAR(envelope.SolveIntegralOfInverse(0.0, area), t, 1e-9);
+   }
+}
+
+LIBRARY_TEST(EnvelopeInsertOrReplaceMany)
+{
+   // Unsorted, with repeated times, existing times and the ends of the track
+   const std::vector<EnvPoint> points{
+      { 2.0, 0.7 }, { 0.5, 1.2 }, { 1.0, 0.9 }, { 2.0, 1.1 },
+      { 4.0, 0.3 }, { 0.0, 1.4 }, { 2.5, 0.6 },
+   };
+
+   auto one = MakeEnvelope(false);
+   one.SetTrackLen(4.0);
+   auto many = one;
+   for (const auto &point : points)
+      one.InsertOrReplace(point.GetT(), point.GetVal());
+   many.InsertOrReplaceMany(points);
+
+   CHECK(many.GetNumberOfPoints() == one.GetNumberOfPoints());
+   for (size_t ii = 0; ii < one.GetNumberOfPoints(); ++ii) {
+      CHECK(many[ii].GetT() == one[ii].GetT());
+      CHECK(many[ii].GetVal() == one[ii].GetVal());
+   }
+}
+
+LIBRARY_BENCHMARK(EnvelopeGetValues100Points)
+{
+   constexpr int Count = 1 << 16, Repeats = 256;
+   Envelope envelope{ true, 0.01, 2.0, 1.0 };
+   for (int ii = 0; ii < 100; ++ii)
+      envelope.InsertOrReplace(ii * 0.01, 0.5 + (ii % 7) * 0.2);
+   std::vector<double> values(Count);
+   LibraryTest::StartTiming();
+   for (int ii = 0; ii < Repeats; ++ii)
+      envelope.GetValues(values.data(), Count, 0.0, 1.0 / 44100);
+   return size_t(Count) * Repeats;
+}
@@ -0,0 +1,645 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file MixerTest.cpp
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "Mix.h"
+#include "ParallelMix.h"
+#include "PlaybackHistory.h"
+#include "PlaybackSlots.h"
+#include "SampleTrack.h"
+#include "SampleTrackPrefetch.h"
+
+namespace {
+
+//! A track holding its samples in memory, as one clip starting at time zero
+class MemoryTrack final : public SampleTrack
+{
+public:
+   static constexpr size_t BlockSize = 4096;
+
+   MemoryTrack(std::vector<float> samples, double rate,
+      ChannelType channel = MonoChannel)
+      : mSamples{ std::move(samples) }
+      , mRate{ rate }
+   {
+      SetChannel(channel);
+   }
+
+   sampleFormat GetSampleFormat() const override { return floatSample; }
+   ChannelType GetChannelIgnoringPan() const override { return GetChannel(); }
+   float GetOldChannelGain(int) const override { return 1.0f; }
+   float GetChannelGain(int) const override { return 1.0f; }
+   double GetRate() const override { return mRate; }
+
+   void GetEnvelopeValues(double *buffer, size_t bufferLen, double) const
+      override
+   {
+      std::fill(buffer, buffer + bufferLen, 1.0);
+   }
+
+   size_t GetContentHash() const override { return mEdits; }
+
+   //! An edit of one sample
+   void SetSample(size_t ii, float value)
+   {
+      mSamples.at(ii) = value;
+      ++mEdits;
+   }
+
+   size_t GetBestBlockSize(sampleCount t) const override
+   {
+      return BlockSize - (t - GetBlockStart(t)).as_size_t();
+   }
+
+   size_t GetMaxBlockSize() const override { return BlockSize; }
+
+   sampleCount GetBlockStart(sampleCount t) const override
+   {
+      const auto pos = t.as_long_long();
+      return pos - ((pos % BlockSize) + BlockSize) % BlockSize;
+   }
+
+   bool Get(samplePtr buffer, sampleFormat format, sampleCount start,
+      size_t len, fillFormat, bool, sampleCount *pNumWithinClips) const
+      override
+   {
+      ClearSamples(buffer, format, 0, len);
+      const auto first = std::max(0LL, start.as_long_long());
+      const auto last = std::min<long long>(
+         start.as_long_long() + len, mSamples.size());
+      if (first < last)
+         CopySamples(
+            reinterpret_cast<constSamplePtr>(mSamples.data() + first),
+            floatSample,
+            buffer + (first - start.as_long_long()) * SAMPLE_SIZE(format),
+            format, last - first, DitherType::none);
+      if (pNumWithinClips)
+         *pNumWithinClips = std::max(0LL, last - first);
+      return true;
+   }
+
+   double GetOffset() const override { return 0; }
+   double GetStartTime() const override { return 0; }
+   double GetEndTime() const override { return mSamples.size() / mRate; }
+
+   // Editing and persistence are not needed by the tests
+   Holder PasteInto(TenacityProject &) const override { return {}; }
+   Holder Cut(double, double) override { return {}; }
+   Holder Copy(double, double, bool) const override { return {}; }
+   void Clear(double, double) override {}
+   void Paste(double, const Track *) override {}
+   void Silence(double, double) override {}
+   void InsertSilence(double, double) override {}
+   Holder Clone() const override { return {}; }
+   void WriteXML(XMLWriter &) const override {}
+   bool HandleXMLTag(const std::string_view &, const AttributesList &)
+      override { return false; }
+   XMLTagHandler *HandleXMLChild(const std::string_view &) override
+      { return nullptr; }
+
+private:
+   std::vector<float> mSamples;
+   const double mRate;
+   size_t mEdits{ 0 };
+};
+
+//! Mix the tracks from time zero to the end of the longest, returning the
+//! output, interleaved if there are several channels
+std::vector<float> MixTracks(const SampleTrackConstArray &tracks,
+   unsigned channels, double rate)
+{
+   constexpr size_t BufferSize = 1024;
+   double endTime = 0;
+   for (const auto &track : tracks)
+      endTime = std::max(endTime, track->GetEndTime());
+
+   Mixer mixer{ tracks, true, Mixer::WarpOptions{ 0.0, 0.0 },
+      0.0, endTime, channels, BufferSize, true, rate, floatSample };
+
+   std::vector<float> result;
+   while (const auto count = mixer.Process(BufferSize)) {
+      const auto data = reinterpret_cast<const float*>(mixer.GetBuffer());
+      result.insert(result.end(), data, data + count * channels);
+   }
+   return result;
+}
+
+std::shared_ptr<const SampleTrack> MakeTrack(std::vector<float> samples,
+   double rate, Track::ChannelType channel = Track::MonoChannel)
+{
+   return std::make_shared<MemoryTrack>(std::move(samples), rate, channel);
+}
+
+constexpr double Rate = 44100;
+constexpr size_t Length = 100000;
+
+}
+
+LIBRARY_TEST(MixerSumsMonoTracks)
+{
+   const auto a = LibraryTest::Noise(Length, 11, 0.4f);
+   const auto b = LibraryTest::Sine(Length, 440, Rate, 0.4f);
+   const auto output =
+      MixTracks({ MakeTrack(a, Rate), MakeTrack(b, Rate) }, 1, Rate);
+
+   CHECK(output.size() == Length);
+   for (size_t ii = 0; ii < Length; ++ii)
+      CHECK(output[ii] == a[ii] + b[ii]);
+   CHECK_REFERENCE("MixerSumsMonoTracks", output.data(), output.size(), 0);
+}
+
+LIBRARY_TEST(MixerInterleavesChannels)
+{
+   const auto left = LibraryTest::Noise(Length, 12, 0.5f);
+   const auto right = LibraryTest::Noise(Length / 2, 13, 0.5f);
+   const auto output = MixTracks({
+      MakeTrack(left, Rate, Track::LeftChannel),
+      MakeTrack(right, Rate, Track::RightChannel) }, 2, Rate);
+
+   // The shorter track is padded with silence
+   CHECK(output.size() == 2 * Length);
+   for (size_t ii = 0; ii < Length; ++ii) {
+      CHECK(output[2 * ii] == left[ii]);
+      CHECK(output[2 * ii + 1] == (ii < right.size() ? right[ii] : 0.0f));
+   }
+}
+
+LIBRARY_TEST(MixerResamples)
+{
+   constexpr double OutRate = 48000;
+   const auto input = LibraryTest::Sine(Length, 1000, Rate, 0.5f);
+   const auto output = MixTracks({ MakeTrack(input, Rate) }, 1, OutRate);
+
+   const auto expected = Length * OutRate / Rate;
+   CHECK_NEAR(output.size(), expected, 64);
+
+   // Away from the ends, the level is that of the input
+   const auto skip = output.size() / 10;
+   double sum = 0;
+   for (size_t ii = skip; ii < output.size() - skip; ++ii)
+      sum += double(output[ii]) * output[ii];
+   CHECK_NEAR(std::sqrt(sum / (output.size() - 2 * skip)),
+      0.5 / std::sqrt(2.0), 0.01);
+
+   CHECK_REFERENCE("MixerResamples", output.data(), output.size(), 0);
+}
+
+LIBRARY_TEST(ParallelMixMatchesOnePassWhenResampling)
+{
+   // Tracks at rates whose samples rarely fall on those of the output, long
+   // enough for two segments
+   const SampleTrackConstArray tracks{
+      MakeTrack(LibraryTest::Noise(300000, 17, 0.4f), 48000),
+      MakeTrack(LibraryTest::Noise(150000, 18, 0.4f), 22050) };
+   double endTime = 0;
+   for (const auto &track : tracks)
+      endTime = std::max(endTime, track->GetEndTime());
+   const auto serial = MixTracks(tracks, 1, Rate);
+   CHECK(serial.size() > ParallelMixSegmentFrames);
+
+   std::vector<float> parallel;
+   const bool finished = MixInParallel(tracks, Rate, floatSample,
+      0.0, endTime, 4, 1024, 1,
+      [&](unsigned, constSamplePtr buffer, size_t len){
+         const auto data = reinterpret_cast<const float*>(buffer);
+         parallel.insert(parallel.end(), data, data + len);
+      },
+      [](double){ return true; });
+   CHECK(finished);
+
+   CHECK(parallel.size() == serial.size());
+   float maxError = 0;
+   for (size_t ii = 0; ii < std::min(parallel.size(), serial.size()); ++ii)
+      maxError = std::max(maxError, std::fabs(parallel[ii] - serial[ii]));
+   CHECK(maxError < 1e-4f);
+}
+
+LIBRARY_TEST(ParallelMixDithersToInt16)
+{
+   // Long enough for several segments, mixed by more threads than one
+   const SampleTrackConstArray tracks{
+      MakeTrack(LibraryTest::Noise(600000, 19, 0.4f), Rate,
+         Track::LeftChannel),
+      MakeTrack(LibraryTest::Sine(600000, 440, Rate, 0.4f), Rate,
+         Track::RightChannel) };
+   const auto endTime = tracks[0]->GetEndTime();
+   const auto serial = MixTracks(tracks, 2, Rate);
+
+   std::vector<short> parallel[2];
+   const bool finished = MixInParallel(tracks, Rate, int16Sample,
+      0.0, endTime, 4, 1024, 2,
+      [&](unsigned channel, constSamplePtr buffer, size_t len){
+         const auto data = reinterpret_cast<const short*>(buffer);
+         parallel[channel].insert(parallel[channel].end(), data, data + len);
+      },
+      [](double){ return true; });
+   CHECK(finished);
+
+   // Each sample is the float mix, give or take the dither
+   for (unsigned channel = 0; channel < 2; ++channel) {
+      CHECK(parallel[channel].size() == serial.size() / 2);
+      float maxError = 0;
+      for (size_t ii = 0;
+           ii < std::min(parallel[channel].size(), serial.size() / 2); ++ii)
+         maxError = std::max(maxError, std::fabs(
+            parallel[channel][ii] / 32768.0f - serial[2 * ii + channel]));
+      CHECK(maxError < 8 / 32768.0f);
+   }
+}
+
+LIBRARY_TEST(MixerScrubsContinuously)
+{
+   constexpr size_t Interval = 2048;
+   const auto input = LibraryTest::Sine(Length, 1000, Rate, 0.5f);
+   Mixer mixer{ { MakeTrack(input, Rate) }, true,
+      Mixer::WarpOptions{ 0.01, 32.0 },
+      0.0, Length / Rate, 1, Interval, false, Rate, floatSample };
+
+   // Intervals that each begin where the last ended play on without gaps
+   double t = 0;
+   for (size_t ii = 0; ii < 20; ++ii) {
+      const auto speed = ii % 2 ? 1.5 : 0.75;
+      const auto t1 = t + speed * Interval / Rate;
+      mixer.ContinueTimesAndSpeed(t, t1, speed);
+      const auto count = mixer.Process(Interval);
+      if (ii > 2) {
+         CHECK(count == Interval);
+         const auto data = reinterpret_cast<const float*>(mixer.GetBuffer());
+         size_t silent = 0, longest = 0;
+         for (size_t jj = 0; jj < count; ++jj) {
+            silent = std::fabs(data[jj]) < 1e-4f ? silent + 1 : 0;
+            longest = std::max(longest, silent);
+         }
+         CHECK(longest < 8);
+      }
+      t = t1;
+   }
+}
+
+LIBRARY_TEST(MixerReplaysLoop)
+{
+   constexpr size_t BufferSize = 1000;
+   constexpr double T0 = 0.5, T1 = 1.0;
+   const auto input = LibraryTest::Noise(Length, 15, 0.5f);
+   Mixer mixer{ { MakeTrack(input, Rate) }, true,
+      Mixer::WarpOptions{ 0.0, 0.0 },
+      T0, T1, 1, BufferSize, true, Rate, floatSample };
+   const auto first = static_cast<size_t>(std::llround(T0 * Rate));
+   const auto frames = static_cast<size_t>(std::llround((T1 - T0) * Rate));
+   const auto fade = static_cast<size_t>(std::llround(0.01 * Rate));
+
+   const auto pass = [&]{
+      std::vector<float> result;
+      while (const auto count = mixer.Process(BufferSize)) {
+         const auto data = reinterpret_cast<const float*>(mixer.GetBuffer());
+         result.insert(result.end(), data, data + count);
+      }
+      return result;
+   };
+
+   // The first pass is mixed, and kept
+   mixer.RestartLoop(frames + 64);
+   const auto recorded = pass();
+   CHECK(recorded.size() == frames);
+   for (size_t ii = 0; ii < frames; ++ii)
+      CHECK(recorded[ii] == input[first + ii]);
+
+   // Later passes are replayed, ending with a crossfade into what leads up
+   // to the start
+   for (int repeat = 0; repeat < 2; ++repeat) {
+      mixer.RestartLoop(frames + 64);
+      const auto replayed = pass();
+      CHECK(replayed.size() == frames);
+      for (size_t ii = 0; ii < frames - fade; ++ii)
+         CHECK(replayed[ii] == recorded[ii]);
+      for (size_t ii = 0; ii < fade; ++ii) {
+         const float in = (ii + 0.5f) / fade;
+         CHECK_NEAR(replayed[frames - fade + ii],
+            recorded[frames - fade + ii] * (1.0f - in) +
+               input[first - fade + ii] * in, 1e-6);
+      }
+   }
+
+   // A seek returns to mixing
+   mixer.Reposition(T0);
+   CHECK(pass() == recorded);
+}
+
+LIBRARY_TEST(MixerMixesLoopAgainAfterEdit)
+{
+   constexpr size_t BufferSize = 1000;
+   constexpr double T0 = 0.5, T1 = 1.0;
+   const auto track = std::make_shared<MemoryTrack>(
+      LibraryTest::Noise(Length, 16, 0.5f), Rate);
+   Mixer mixer{ { track }, true,
+      Mixer::WarpOptions{ 0.0, 0.0 },
+      T0, T1, 1, BufferSize, true, Rate, floatSample };
+   const auto first = static_cast<size_t>(std::llround(T0 * Rate));
+   const auto frames = static_cast<size_t>(std::llround((T1 - T0) * Rate));
+
+   const auto pass = [&]{
+      std::vector<float> result;
+      while (const auto count = mixer.Process(BufferSize)) {
+         const auto data = reinterpret_cast<const float*>(mixer.GetBuffer());
+         result.insert(result.end(), data, data + count);
+      }
+      return result;
+   };
+
+   // Mixed and kept, then replayed
+   mixer.RestartLoop(frames + 64);
+   pass();
+   mixer.RestartLoop(frames + 64);
+   pass();
+
+   // An edit between passes is heard in the next pass, which is kept and
+   // replayed in turn
+   track->SetSample(first + 10, 0.9f);
+   for (int repeat = 0; repeat < 3; ++repeat) {
+      mixer.RestartLoop(frames + 64);
+      const auto result = pass();
+      CHECK(result.size() == frames);
+      CHECK(result[10] == 0.9f);
+   }
+
+   // So is an edit during a replayed pass, from the pass after it
+   mixer.RestartLoop(frames + 64);
+   track->SetSample(first + 20, -0.9f);
+   pass();
+   mixer.RestartLoop(frames + 64);
+   CHECK(pass()[20] == -0.9f);
+}
+
+LIBRARY_TEST(PrefetchHoldsSamplesAroundTarget)
+{
+   const auto input = LibraryTest::Noise(Length, 14);
+   const auto track = MakeTrack(input, Rate);
+   SampleTrackPrefetch prefetch{ { track }, 1.0 };
+   const auto iTrack = prefetch.Find(*track);
+   CHECK(iTrack == 0);
+
+   std::vector<float> buffer(1000);
+   for (const double target : { 0.5, 1.8, 0.1 }) {
+      const bool backwards = (target == 0.1);
+      prefetch.SetTarget(target, backwards);
+      const sampleCount start = std::llround(target * Rate);
+      // The worker thread fills the window soon
+      bool held = false;
+      for (int tries = 0; !held && tries < 1000; ++tries) {
+         held = prefetch.Get(iTrack, start, buffer.size(), buffer.data());
+         if (!held)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      CHECK(held);
+      for (size_t ii = 0; ii < buffer.size(); ++ii)
+         CHECK(buffer[ii] == input[start.as_size_t() + ii]);
+   }
+
+   // Far from the target, the caller must read the track
+   CHECK(!prefetch.Get(iTrack, Length - 1000, 1000, buffer.data()));
+}
+
+LIBRARY_TEST(PlaybackHistoryKeepsLastRun)
+{
+   constexpr size_t Capacity = 30000, Slice = 4410;
+   const auto input = LibraryTest::Noise(Length, 15);
+   const auto track = MakeTrack(input, Rate);
+   const auto other = MakeTrack(input, Rate);
+   PlaybackHistory history;
+   history.Reset({ track }, Rate, Capacity);
+
+   // Play from time zero, in slices
+   const auto play = [&](size_t from, size_t to, double speed = 1.0) {
+      for (auto start = from; start < to; start += Slice) {
+         history.BeginSlice(
+            start / Rate, (start + Slice * speed) / Rate, Slice);
+         history.Put(0, input.data() + start, Slice);
+         history.EndSlice();
+      }
+   };
+   play(0, 10 * Slice);
+
+   std::vector<float> buffer(10000);
+   const auto check = [&](size_t start) {
+      if (!history.Get(*track, start / Rate, buffer.size(), buffer.data()))
+         return false;
+      for (size_t ii = 0; ii < buffer.size(); ++ii)
+         CHECK(buffer[ii] == input[start + ii]);
+      return true;
+   };
+   // The last frames are kept, across the end of the ring
+   CHECK(check(10 * Slice - 10000));
+   CHECK(check(10 * Slice - Capacity));
+   CHECK(!check(10 * Slice - Capacity - 1));
+   CHECK(!check(10 * Slice - 9999));
+   CHECK(!history.Get(*other, 10 * Slice / Rate - 1, 1, buffer.data()));
+
+   // A jump begins the run again
+   play(15 * Slice, 18 * Slice);
+   CHECK(check(18 * Slice - 10000));
+   CHECK(!check(15 * Slice - 10000));
+
+   // So does a short slice, at the end of play
+   history.BeginSlice(18 * Slice / Rate, 19 * Slice / Rate, Slice);
+   history.Put(0, input.data() + 18 * Slice, Slice / 2);
+   history.EndSlice();
+   CHECK(!check(19 * Slice - 10000));
+
+   // And another speed
+   play(19 * Slice, 22 * Slice);
+   CHECK(check(22 * Slice - 10000));
+   play(22 * Slice, 23 * Slice, 1.5);
+   CHECK(!check(22 * Slice - 10000));
+
+   play(0, 5 * Slice);
+   CHECK(check(5 * Slice - 10000));
+   history.Invalidate();
+   CHECK(!check(5 * Slice - 10000));
+}
+
+LIBRARY_TEST(PlaybackHistoryOutlivesSelectionButNotEdits)
+{
+   constexpr size_t Slice = 4410, Frames = 10 * Slice;
+   auto input = LibraryTest::Noise(Length, 19);
+   const auto track = std::make_shared<MemoryTrack>(input, Rate);
+   PlaybackHistory history;
+   history.Reset({ track }, Rate, Frames);
+   for (size_t start = 0; start < Frames; start += Slice) {
+      history.BeginSlice(start / Rate, (start + Slice) / Rate, Slice);
+      history.Put(0, input.data() + start, Slice);
+      history.EndSlice();
+   }
+
+   std::vector<float> buffer(Slice);
+   const auto kept = [&]{
+      return history.Get(*track, (Frames - Slice) / Rate, Slice,
+         buffer.data());
+   };
+   CHECK(kept());
+
+   // Clicking in the track to start a selection, as for punch and roll,
+   // changes no samples
+   track->SetSelected(true);
+   CHECK(kept());
+   CHECK(buffer[0] == input[Frames - Slice]);
+
+   // Any edit does, even where nothing was kept
+   track->SetSample(Length - 1, 0.5f);
+   CHECK(!kept());
+}
+
+LIBRARY_TEST(PlaybackSlotsAreReusedAfterDraining)
+{
+   PlaybackSlots slots;
+   slots.Reset(4);
+   const auto exchange = [&]{ slots.Publish(slots.Take()); };
+
+   // Two stereo tracks fill the slots
+   CHECK(slots.Reserve(2) == 0);
+   slots.Add(0, 2);
+   CHECK(slots.Playing() == 0);
+   exchange();
+   CHECK(slots.Playing() == 0b0011);
+   CHECK(slots.Reserve(2) == 2);
+   slots.Add(2, 2);
+   CHECK(slots.Reserve(1) == slots.Size());
+
+   // Retired slots play no more, but are reused only once drained
+   slots.Retire(0);
+   slots.Retire(1);
+   CHECK(slots.Active() == 0b1100);
+   CHECK(slots.Reserve(2) == slots.Size());
+   exchange();
+   CHECK(slots.Producing() == 0b1100);
+   CHECK(slots.Draining() == 0b0011);
+   CHECK(slots.Playing() == 0b1100);
+   CHECK(slots.Reserve(2) == slots.Size());
+   slots.Free(slots.Draining());
+   CHECK(slots.Draining() == 0);
+   CHECK(slots.Reserve(2) == 0);
+
+   // A slot retired before the producer takes it is drained too
+   slots.Add(0, 2);
+   slots.Retire(0);
+   slots.Retire(1);
+   exchange();
+   CHECK(slots.Playing() == 0b1100);
+   CHECK(slots.Draining() == 0b0011);
+   slots.Free(slots.Draining());
+   CHECK(slots.Reserve(1) == 0);
+}
+
+LIBRARY_TEST(PlaybackSlotsHandOverAmongThreads)
+{
+   constexpr size_t NSlots = 8, NTracks = 500;
+   PlaybackSlots slots;
+   slots.Reset(NSlots);
+
+   // What the caller keeps in fixed-size arrays: the track of each slot,
+   // written by the main thread, what the producer took, and a count of
+   // frames for a ring buffer
+   std::vector<size_t> tracks(NSlots), taken(NSlots);
+   std::vector<std::atomic<size_t>> frames(NSlots);
+   std::atomic<bool> stop{ false };
+   std::atomic<size_t> mismatches{ 0 }, played{ 0 };
+
+   std::thread producer{ [&]{
+      while (!stop.load(std::memory_order_relaxed)) {
+         const auto changes = slots.Take();
+         for (size_t slot = 0; slot < NSlots; ++slot)
+            if (changes.added & PlaybackSlots::Bit(slot))
+               taken[slot] = tracks[slot];
+         slots.Publish(changes);
+         for (size_t slot = 0; slot < NSlots; ++slot)
+            if (slots.Producing() & PlaybackSlots::Bit(slot))
+               frames[slot].fetch_add(1, std::memory_order_relaxed);
+         std::this_thread::yield();
+      }
+   } };
+   std::thread consumer{ [&]{
+      while (!stop.load(std::memory_order_relaxed)) {
+         const auto draining = slots.Draining();
+         for (size_t slot = 0; slot < NSlots; ++slot)
+            if (draining & PlaybackSlots::Bit(slot))
+               frames[slot].store(0, std::memory_order_relaxed);
+         slots.Free(draining);
+         const auto playing = slots.Playing();
+         for (size_t slot = 0; slot < NSlots; ++slot)
+            if (playing & PlaybackSlots::Bit(slot)) {
+               if (tracks[slot] != taken[slot])
+                  ++mismatches;
+               ++played;
+            }
+         std::this_thread::yield();
+      }
+   } };
+
+   // Add mono and stereo tracks, and retire the oldest, many times over
+   std::vector<std::pair<size_t, size_t>> active;
+   size_t reusedWithFrames = 0;
+   for (size_t track = 1; track <= NTracks; ++track) {
+      const size_t count = 1 + track % 2;
+      size_t first;
+      while ((first = slots.Reserve(count)) == slots.Size()) {
+         if (!active.empty()) {
+            for (auto slot = active.front().first;
+                 slot < active.front().first + active.front().second; ++slot)
+               slots.Retire(slot);
+            active.erase(active.begin());
+         }
+         std::this_thread::yield();
+      }
+      for (auto slot = first; slot < first + count; ++slot) {
+         if (frames[slot].load(std::memory_order_relaxed) != 0)
+            ++reusedWithFrames;
+         tracks[slot] = track;
+      }
+      slots.Add(first, count);
+      active.emplace_back(first, count);
+   }
+
+   stop.store(true, std::memory_order_relaxed);
+   producer.join();
+   consumer.join();
+   CHECK(mismatches == 0);
+   CHECK(reusedWithFrames == 0);
+   CHECK(played > 0);
+}
+
+namespace {
+
+size_t BenchmarkMix(double outRate)
+{
+   constexpr size_t Tracks = 8, Samples = 10 * 44100;
+   SampleTrackConstArray tracks;
+   for (size_t ii = 0; ii < Tracks; ++ii)
+      tracks.push_back(MakeTrack(LibraryTest::Noise(Samples, ii, 0.1f), Rate,
+         ii % 2 ? Track::RightChannel : Track::LeftChannel));
+   LibraryTest::StartTiming();
+   MixTracks(tracks, 2, outRate);
+   return Tracks * Samples;
+}
+
+}
+
+LIBRARY_BENCHMARK(MixEightTracks)
+{
+   return BenchmarkMix(Rate);
+}
+
+LIBRARY_BENCHMARK(MixEightTracksResampled)
+{
+   return BenchmarkMix(48000);
+}
@@ -755,6 +755,38 @@ int Envelope::InsertOrReplaceRelative(double when, double value)
    return index;
 }
 
+void Envelope::InsertOrReplaceMany(std::vector<EnvPoint> points)
+{
+   for (auto &point : points)
+      point.SetT( std::max( 0.0, std::min( mTrackLen, point.GetT() - mOffset ) ) );
+
+   // Stable, so that of several points at one time, the last one given wins
+   std::stable_sort( points.begin(), points.end(),
+      []( const EnvPoint &point1, const EnvPoint &point2 )
+         { return point1.GetT() < point2.GetT(); } );
+
+   EnvArray merged;
+   merged.reserve( mEnv.size() + points.size() );
+   auto old = mEnv.begin(), oldEnd = mEnv.end();
+   for (size_t ii = 0, nn = points.size(); ii < nn; ++ii) {
+      const auto when = points[ii].GetT();
+      if ( ii + 1 < nn && points[ii + 1].GetT() == when )
+         continue;
+      while ( old != oldEnd && old->GetT() < when )
+         merged.push_back( *old++ );
+      if ( old != oldEnd && old->GetT() == when ) {
+         // modify existing
+         // In case of a discontinuity, ALWAYS CHANGING LEFT LIMIT ONLY!
+         merged.push_back( *old++ );
+         merged.back().SetVal( this, points[ii].GetVal() );
+      }
+      else
+         merged.push_back( points[ii] );
+   }
+   merged.insert( merged.end(), old, oldEnd );
+   mEnv.swap( merged );
+}
+
 std::pair<int, int> Envelope::EqualRange( double when, double sampleDur ) const
 {
    // Find range of envelope points matching the given time coordinate
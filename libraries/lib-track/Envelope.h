@@ -173,6 +173,13 @@ public:
    int InsertOrReplace(double when, double value)
    { return InsertOrReplaceRelative( when - mOffset, value ); }
 
+   /** \brief Add points at absolute time coordinates, or replace those
+    * already there, with the same result as InsertOrReplace for each in turn
+    *
+    * Sorts the points in together, so many are added much faster than one at
+    * a time. */
+   void InsertOrReplaceMany(std::vector<EnvPoint> points);
+
    /** \brief Move a point at when to value
     *
     * Returns 0 if point moved, -1 if not found.*/
@@ -4,11 +4,12 @@
 #include <windows.h>
 #include <stdio.h>
 #include <tchar.h>
+#include <functional>
 
 const int nBuff = 1024;
 
-extern "C" int DoSrv( char * pIn );
-extern "C" int DoSrvMore( char * pOut, size_t nMax );
+extern void DoSrvStreamed( char * pIn,
+   const std::function< void( const char *, size_t ) > &write );
 
 void PipeServer()
 {
@@ -48,7 +49,6 @@ void PipeServer()
    DWORD cbBytesRead;
    DWORD cbBytesWritten;
    CHAR chRequest[ nBuff ];
-   CHAR chResponse[ nBuff ];
 
    int jj=0;
 
@@ -79,15 +79,18 @@ void PipeServer()
 
             printf( "Rxd %s\n", chRequest );
 
-            DoSrv( chRequest );
+            // Send the response while it is being made
+            DoSrvStreamed( chRequest, [&]( const char *data, size_t len ){
+               // In messages no longer than the buffer of the pipe
+               while( len > 0 )
+               {
+                  DWORD nToWrite = (DWORD)( len < nBuff - 1 ? len : nBuff - 1 );
+                  WriteFile( hPipeFromSrv, data, nToWrite, &cbBytesWritten, NULL);
+                  data += nToWrite;
+                  len -= nToWrite;
+               }
+            } );
             jj++;
-            while( true )
-            {
-               int nWritten = DoSrvMore( chResponse, nBuff );
-               if( nWritten <= 1 )
-                  break;
-               WriteFile( hPipeFromSrv, chResponse, nWritten-1, &cbBytesWritten, NULL);
-            }
             //FlushFileBuffers( hPipeFromSrv );
          }
          FlushFileBuffers( hPipeToSrv );
@@ -113,13 +116,14 @@ void PipeServer()
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
+#include <functional>
 
 const char fifotmpl[] = "/tmp/tenacity_script_pipe.%s.%d";
 
 const int nBuff = 1024;
 
-extern "C" int DoSrv( char * pIn );
-extern "C" int DoSrvMore( char * pOut, size_t nMax );
+extern void DoSrvStreamed( char * pIn,
+   const std::function< void( const char *, size_t ) > &write );
 
 void PipeServer()
 {
@@ -175,21 +179,13 @@ void PipeServer()
       buf[len - 1] = '\0';
 
       printf("Server received %s\n", buf);
-      DoSrv(buf);
-
-      while (true)
+      // Send the response while it is being made, so that the script can
+      // read a long one as it arrives
+      DoSrvStreamed(buf, [&](const char *data, size_t size)
       {
-         len = DoSrvMore(buf, nBuff);
-         if (len <= 1)
-         {
-            break;
-         }
-         printf("Server sending %s",buf);
-
-         // len - 1 because we do not send the null character
-         fwrite(buf, 1, len - 1, fromFifo);
-      }
-      fflush(fromFifo);
+         fwrite(data, 1, size, fromFifo);
+         fflush(fromFifo);
+      });
    }
 
    printf("Read failed on fifo, quitting\n");
@@ -0,0 +1,67 @@
+// ScriptSocketProtocol.h :
+//
+// Framing of the binary scripting channel served by mod-script-pipe on a
+// Unix domain socket, alongside the text pipes.  Clients may include this
+// header.
+//
+// Every message, in either direction, is a ScriptFrameHeader in host byte
+// order followed by 'length' bytes of payload.  The client chooses the 'id'
+// of each request and the server echoes it in the reply.  Requests are
+// handled in the order received, so a client may send many of them before
+// reading any replies.
+//
+// Enabling other programs to connect to Tenacity via a socket is a
+// potential security risk.  Use at your own risk.
+
+#ifndef __SCRIPT_SOCKET_PROTOCOL__
+#define __SCRIPT_SOCKET_PROTOCOL__
+
+#include <cstdint>
+
+// Path of the listening socket; %d is the user id
+#define SCRIPT_SOCKET_TEMPLATE "/tmp/tenacity_script_socket.%d"
+
+enum ScriptFrameType : uint32_t
+{
+   // Client to server
+
+   // Payload: a UTF-8 command, as written to the text pipe, without newline
+   ScriptFrameCommand = 1,
+   // Payload: ScriptSampleRange
+   ScriptFrameGetSamples = 2,
+   // Payload: ScriptSampleRange, then 'count' float32 samples
+   ScriptFrameSetSamples = 3,
+
+   // Server to client
+
+   // Payload: the UTF-8 response, as read from the text pipe
+   ScriptFrameResponse = 101,
+   // Payload: 'count' float32 samples
+   ScriptFrameSamples = 102,
+   // Empty payload; acknowledges ScriptFrameSetSamples
+   ScriptFrameDone = 103,
+   // Payload: a UTF-8 message
+   ScriptFrameError = 104,
+};
+
+struct ScriptFrameHeader
+{
+   uint32_t type;
+   uint32_t id;
+   uint64_t length;
+};
+
+struct ScriptSampleRange
+{
+   // Counts the channels of all tracks, like the Channel parameter of
+   // scripting commands
+   int64_t channel;
+   // In samples, from time zero of the track
+   int64_t start;
+   uint64_t count;
+};
+
+// Largest sample count accepted in one frame
+static const uint64_t ScriptMaxSamplesPerFrame = 1 << 24;
+
+#endif
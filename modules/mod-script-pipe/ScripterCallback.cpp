@@ -24,8 +24,14 @@ See the example in this file.  It has several cases/options in it.
 
 #include "ModuleConstants.h"
 
+#include <functional>
+#include <thread>
+
 extern void PipeServer();
 typedef DLL_IMPORT int (*tpExecScriptServerFunc)( wxString * pIn, wxString * pOut);
+#if !defined(WIN32)
+extern void SocketServer(tpExecScriptServerFunc pFn);
+#endif
 static tpExecScriptServerFunc pScriptServerFn=NULL;
 
 
@@ -37,6 +43,16 @@ int DLL_API RegScriptServerFunc( tpExecScriptServerFunc pFn )
    if( pFn )
    {
       pScriptServerFn = pFn;
+#if !defined(WIN32)
+      // This function is called again each time a pipe client goes away,
+      // but the socket server accepts clients for itself
+      static bool socketStarted = false;
+      if( !socketStarted )
+      {
+         socketStarted = true;
+         std::thread(SocketServer, pFn).detach();
+      }
+#endif
       PipeServer();
    }
 
@@ -56,87 +72,47 @@ extern "C" DLL_API int ModuleDispatch(ModuleDispatchTypes type)
    return 1;
 }
 
-wxString Str2;
-wxArrayString aStr;
-unsigned int currentLine;
-size_t currentPosition;
+} // End extern "C"
 
-// Send the received command to Audacity and build an array of response lines.
-// The response lines can be retrieved by calling DoSrvMore repeatedly.
-int DoSrv(char *pIn)
+// Send the received command to Audacity, and pass the response to write, as
+// UTF-8, in pieces while the command produces it.
+void DoSrvStreamed(char *pIn,
+   const std::function<void(const char *, size_t)> &write)
 {
    // Interpret string as unicode.
    // wxWidgets (now) uses unicode internally.
    // Scripts must send unicode strings (if going beyond 7-bit ASCII).
    // Important for filenames in commands.
-   wxString Str1(pIn, wxConvUTF8); 
+   wxString Str1(pIn, wxConvUTF8);
    Str1.Replace( wxT("\r"), wxT(""));
    Str1.Replace( wxT("\n"), wxT(""));
-   Str2 = wxEmptyString;
-   (*pScriptServerFn)( &Str1 , &Str2);
 
-   Str2 += wxT('\n');
-   size_t outputLength = Str2.Length();
-   aStr.Clear();
-   size_t iStart = 0;
-   size_t i;
-   for(i = 0; i < outputLength; ++i)
+   // Where wxString holds UTF-16, a chunk might end between the two halves
+   // of a surrogate pair, which can't be converted apart.  Convert whole
+   // code points only, and carry a trailing high surrogate to the next chunk.
+   wxString carry;
+   const auto convert = [&](const wxString &text)
    {
-      if( Str2[i] == wxT('\n') )
-      {
-         aStr.Add( Str2.Mid( iStart, i-iStart) + wxT("\n") );
-         iStart = i+1;
-      }
-   }
-
-   currentLine     = 0;
-   currentPosition = 0;
-
-   return 1;
-}
-
-size_t smin(size_t a, size_t b) { return a < b ? a : b; }
-
-// Write up to nMax characters of the prepared (by DoSrv) response lines.
-// Returns the number of characters sent, including null.
-// Zero returned if and only if there's nothing else to send.
-int DoSrvMore(char *pOut, size_t nMax)
-{
-   wxASSERT(currentLine >= 0);
-   wxASSERT(currentPosition >= 0);
-
-   size_t totalLines = aStr.GetCount();
-   while (currentLine < totalLines)
+      const auto utf8 = text.ToUTF8();
+      write(utf8.data(), utf8.length());
+   };
+   ScriptCommandRelay::ExecStreaming(Str1, [&](const wxString &chunk)
    {
-      wxCharBuffer lineString    = aStr[currentLine].ToUTF8();
-      size_t lineLength      = lineString.length();
-      size_t charsLeftInLine = lineLength - currentPosition;
-
-      wxASSERT(charsLeftInLine >= 0);
-
-      if (charsLeftInLine == 0)
-      {
-         // Move to next line
-         ++currentLine;
-         currentPosition = 0;
-      }
-      else
-      {
-         // Write as much of the rest of the line as will fit in the buffer
-         size_t charsToWrite = smin(charsLeftInLine, nMax - 1);
-         memcpy(pOut, 
-                &(lineString.data()[currentPosition]),
-                charsToWrite);
-         pOut[charsToWrite] = '\0';
-         currentPosition    += charsToWrite;
-         // Need to cast to prevent compiler warnings
-         int charsWritten = static_cast<int>(charsToWrite + 1);
-         // (Check cast was safe)
-         wxASSERT(static_cast<size_t>(charsWritten) == charsToWrite + 1);
-         return charsWritten;
+      wxString text;
+      text.swap(carry);
+      text += chunk;
+      if (sizeof(wxChar) == 2 && !text.empty()) {
+         const auto last = static_cast<wxUint32>(text.Last().GetValue());
+         if (last >= 0xD800 && last <= 0xDBFF) {
+            carry = text.Last();
+            text.RemoveLast();
+         }
       }
-   }
-   return 0;
+      convert(text);
+   });
+   if (!carry.empty())
+      convert(carry);
+   // Terminate the response with an empty line
+   write("\n", 1);
 }
 
-} // End extern "C"
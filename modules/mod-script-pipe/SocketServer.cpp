@@ -0,0 +1,220 @@
+// SocketServer.cpp :
+//
+// Serves the binary framed scripting protocol of ScriptSocketProtocol.h
+// on a Unix domain socket.  Commands are forwarded to the same service
+// function as the text pipes; sample frames move float32 audio to and from
+// wave track channels without going through files.
+
+#if !defined(WIN32)
+
+#include <wx/string.h>
+#include "commands/ScriptCommandRelay.h"
+#include "ScriptSocketProtocol.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+bool ReadAll(int fd, void *buffer, size_t size)
+{
+   auto pos = static_cast<char *>(buffer);
+   while (size > 0)
+   {
+      auto got = read(fd, pos, size);
+      if (got < 0 && errno == EINTR)
+         continue;
+      if (got <= 0)
+         return false;
+      pos += got;
+      size -= got;
+   }
+   return true;
+}
+
+bool WriteAll(int fd, const void *buffer, size_t size)
+{
+   auto pos = static_cast<const char *>(buffer);
+   while (size > 0)
+   {
+      auto put = write(fd, pos, size);
+      if (put < 0 && errno == EINTR)
+         continue;
+      if (put <= 0)
+         return false;
+      pos += put;
+      size -= put;
+   }
+   return true;
+}
+
+bool WriteFrame(int fd, uint32_t type, uint32_t id,
+   const void *payload, uint64_t length)
+{
+   ScriptFrameHeader header{ type, id, length };
+   return WriteAll(fd, &header, sizeof(header)) &&
+      WriteAll(fd, payload, length);
+}
+
+bool WriteError(int fd, uint32_t id, const char *message)
+{
+   return WriteFrame(fd, ScriptFrameError, id, message, strlen(message));
+}
+
+// Handle frames from one client until it disconnects or breaks the protocol
+void ServeClient(int fd, tpExecScriptServerFunc pFn)
+{
+   std::vector<char> payload;
+   std::vector<float> samples;
+
+   ScriptFrameHeader header;
+   while (ReadAll(fd, &header, sizeof(header)))
+   {
+      // Refuse anything larger than the largest sample frame
+      if (header.length >
+          sizeof(ScriptSampleRange) + ScriptMaxSamplesPerFrame * sizeof(float))
+      {
+         WriteError(fd, header.id, "Frame too long");
+         return;
+      }
+
+      payload.resize(header.length);
+      if (!ReadAll(fd, payload.data(), payload.size()))
+         return;
+
+      bool ok = true;
+      switch (header.type)
+      {
+      case ScriptFrameCommand:
+      {
+         wxString in = wxString::FromUTF8(payload.data(), payload.size());
+         wxString out;
+         (*pFn)(&in, &out);
+         auto utf8 = out.ToUTF8();
+         ok = WriteFrame(fd, ScriptFrameResponse, header.id,
+            utf8.data(), utf8.length());
+         break;
+      }
+      case ScriptFrameGetSamples:
+      case ScriptFrameSetSamples:
+      {
+         ScriptSampleRange range;
+         if (payload.size() < sizeof(range))
+         {
+            ok = WriteError(fd, header.id, "Missing sample range");
+            break;
+         }
+         memcpy(&range, payload.data(), sizeof(range));
+
+         const bool isSet = (header.type == ScriptFrameSetSamples);
+         const auto expected = sizeof(range) +
+            (isSet ? range.count * sizeof(float) : 0);
+         if (range.count > ScriptMaxSamplesPerFrame ||
+             payload.size() != expected)
+         {
+            ok = WriteError(fd, header.id, "Bad sample range");
+            break;
+         }
+
+         samples.resize(range.count);
+         if (isSet)
+            memcpy(samples.data(), payload.data() + sizeof(range),
+               range.count * sizeof(float));
+
+         bool done = false;
+         std::string error = isSet
+            ? "Could not set samples" : "Could not get samples";
+         try
+         {
+            done = isSet
+               ? ScriptCommandRelay::SetSamples(
+                  range.channel, range.start, range.count, samples.data())
+               : ScriptCommandRelay::GetSamples(
+                  range.channel, range.start, range.count, samples.data());
+         }
+         catch (const std::exception &e)
+         {
+            // Such as a full disk; tell the client why
+            (error += ": ") += e.what();
+         }
+
+         if (!done)
+            ok = WriteError(fd, header.id, error.c_str());
+         else if (isSet)
+            ok = WriteFrame(fd, ScriptFrameDone, header.id, nullptr, 0);
+         else
+            ok = WriteFrame(fd, ScriptFrameSamples, header.id,
+               samples.data(), range.count * sizeof(float));
+         break;
+      }
+      default:
+         ok = WriteError(fd, header.id, "Unknown frame type");
+         break;
+      }
+
+      if (!ok)
+         return;
+   }
+}
+
+}
+
+void SocketServer(tpExecScriptServerFunc pFn)
+{
+   sockaddr_un address{};
+   address.sun_family = AF_UNIX;
+   snprintf(address.sun_path, sizeof(address.sun_path),
+      SCRIPT_SOCKET_TEMPLATE, (int) getuid());
+
+   int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (listener < 0)
+   {
+      perror("Unable to create script socket");
+      return;
+   }
+
+   unlink(address.sun_path);
+
+   // Only the owner may connect.  Permissions are set on the bound path
+   // rather than with umask(), which would affect files created by all
+   // threads; nobody can connect before listen(), so there is no window.
+   if (bind(listener,
+          reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+       chmod(address.sun_path, S_IRUSR | S_IWUSR) < 0 ||
+       listen(listener, 1) < 0)
+   {
+      perror("Unable to listen on script socket");
+      close(listener);
+      return;
+   }
+
+   while (true)
+   {
+      int fd = accept(listener, nullptr, nullptr);
+      if (fd < 0)
+      {
+         if (errno == EINTR)
+            continue;
+         perror("Unable to accept on script socket");
+         break;
+      }
+
+      ServeClient(fd, pFn);
+      close(fd);
+   }
+
+   close(listener);
+   unlink(address.sun_path);
+}
+
+#endif
@@ -63,16 +63,21 @@ time warp info and AudioIOListener and whether the playback is looped.
 #include "AudioIO.h"
 #include "AudioIOExt.h"
 #include "AudioIOListener.h"
+#include "CaptureJournal.h"
 
 #include "DeviceManager.h"
 
 #include <string>
 #include <cmath>
+#include <limits>
 #include <cstdlib>
 #include <stdexcept>
 #include <thread>
 #include <optional>
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <numeric>
 #include <optional>
 
@@ -94,6 +99,7 @@ time warp info and AudioIOListener and whether the playback is looped.
 #include <lib-basic-ui/BasicUI.h>
 #include <lib-exceptions/TenacityException.h>
 #include <lib-math/Resample.h>
+#include <lib-math/SignalFeatures.h>
 #include <lib-preferences/Prefs.h>
 #include <lib-transactions/TransactionScope.h>
 #include <lib-utility/MessageBuffer.h>
@@ -106,9 +112,11 @@ time warp info and AudioIOListener and whether the playback is looped.
 #include "ScrubState.h"
 #include "ProjectWindows.h"
 #include "WaveTrack.h"
+#include "WorkerPool.h"
 #include "TransactionScope.h"
 
 #include "effects/RealtimeEffectManager.h"
+#include "prefs/RecordingPrefs.h"
 #include "widgets/AudacityMessageBox.h"
 #include "QualitySettings.h"
 
@@ -310,7 +318,7 @@ AudioIO::AudioIO()
    }
 #endif
 
-   PaError err = Pa_Initialize();
+   PaError err = DeviceManager::Instance()->InitializePortAudio();
 
    if (err != paNoError) {
       auto errStr = XO("Could not find any audio devices.\n");
@@ -334,9 +342,7 @@ AudioIO::AudioIO()
 
 AudioIO::~AudioIO()
 {
-
-   // FIXME: ? TRAP_ERR.  Pa_Terminate probably OK if err without reporting.
-   Pa_Terminate();
+   DeviceManager::Instance()->TerminatePortAudio();
 
    // This causes reentrancy issues during application shutdown
    // wxTheApp->Yield();
@@ -578,11 +584,16 @@ void AudioIO::StartMonitoring( const AudioIOStartStreamOptions &options )
    }
 }
 
+// Fewest capture channels worth a thread of their own when draining
+static constexpr size_t MinCaptureChannelsPerThread = 4;
+
 int AudioIO::StartStream(const TransportTracks &tracks,
                          double t0, double t1,
                          const AudioIOStartStreamOptions &options)
 {
    mLostSamples = 0;
+   mLeastCaptureHeadroom = 1.0;
+   mLongestCaptureDrain = 0.0;
    mLostCaptureIntervals.clear();
    mDetectDropouts =
       gPrefs->Read( WarningDialogKey(wxT("DropoutDetected")), true ) != 0;
@@ -770,6 +781,19 @@ int AudioIO::StartStream(const TransportTracks &tracks,
          mPlaybackSchedule.mTimeQueue.mLastTime;
    // else recording only without overdub
 
+   // Few channels are not worth the threads
+   const auto nCaptureThreads = std::min<size_t>(
+      mCaptureTracks.size() / MinCaptureChannelsPerThread,
+      std::max(1u, std::thread::hardware_concurrency()));
+   if (nCaptureThreads > 1)
+      mCaptureWorkers = std::make_unique<WorkerPool>(nCaptureThreads - 1);
+
+   // Keep a raw copy of the recording, until it is safely in the project
+   mKeepCaptureJournal = false;
+   if (!mCaptureTracks.empty() && CaptureJournalEnabled.Read())
+      mCaptureJournal = std::make_unique<CaptureJournal>(
+         mCaptureTracks.size(), mCaptureTracks[0]->GetRate(), t0);
+
    // We signal the audio thread to call TrackBufferExchange, to prime the RingBuffers
    // so that they will have data in them when the stream starts.  Having the
    // audio thread call TrackBufferExchange here makes the code more predictable, since
@@ -891,6 +915,13 @@ void AudioIO::CallAfterRecording(PostRecordingAction action)
    wxTheApp->CallAfter(std::move(action));
 }
 
+// Playback channels that may be added while playing
+static constexpr size_t SparePlaybackChannels = 8;
+// Index in mPlaybackMixers of a spare slot never yet played
+static constexpr size_t NoPlaybackMixer = std::numeric_limits<size_t>::max();
+// Samples of all tracks kept from the last playback: 32 MiB of floats
+static constexpr size_t MaxPlaybackHistorySamples = 1 << 23;
+
 bool AudioIO::AllocateBuffers(
    const AudioIOStartStreamOptions &options,
    const TransportTracks &tracks, double t0, double t1, double sampleRate )
@@ -948,9 +979,12 @@ bool AudioIO::AllocateBuffers(
             auto playbackBufferSize =
                (size_t)lrint(mRate * mPlaybackRingBufferSecs);
 
-            // Always make at least one playback buffer
-            mPlaybackBuffers.reinit(
-               std::max<size_t>(1, mPlaybackTracks.size()));
+            // Always make at least one playback buffer, and spares for
+            // tracks added while playing
+            const auto numSpares =
+               mPlaybackTracks.empty() ? 0 : SparePlaybackChannels;
+            const auto numSlots = mPlaybackTracks.size() + numSpares;
+            mPlaybackBuffers.reinit(std::max<size_t>(1, numSlots));
             // Number of scratch buffers depends on device playback channels
             if (mNumPlaybackChannels > 0) {
                mScratchBuffers.resize(mNumPlaybackChannels * 2);
@@ -962,10 +996,28 @@ bool AudioIO::AllocateBuffers(
                }
             }
             mPlaybackMixers.clear();
+            // So that the audio thread can add mixers without allocating
+            mPlaybackMixers.reserve(numSlots);
             mPlaybackMixers.resize(mPlaybackTracks.size());
-
-            const auto &warpOptions =
-               policy.MixerWarpOptions(mPlaybackSchedule);
+            mPlaybackSlots.Reset(numSpares);
+            mAddedPlaybackTracks.clear();
+            mAddedPlaybackTracks.resize(numSpares);
+            mPendingPlaybackMixers.clear();
+            mPendingPlaybackMixers.resize(numSpares);
+            mAddedPlaybackMixerIndices.assign(numSpares, NoPlaybackMixer);
+            // Lists of slots, changed by the audio threads without
+            // allocating; at first, the leading slots
+            for (auto pSlots : { &mProducingSlots, &mPlayingSlots }) {
+               pSlots->clear();
+               pSlots->reserve(numSlots);
+               for (size_t i = 0; i < mPlaybackTracks.size(); ++i)
+                  pSlots->push_back(i);
+            }
+            mPlaybackStartFrames.assign(numSlots, 0);
+            mPlaybackRetired.reinit(numSlots, true);
+            mPlaybackFramesProduced = 0;
+            mPlaybackFramesConsumed.store(0, std::memory_order_relaxed);
+            mPlaybackMixersEndTime = t1;
 
             mPlaybackQueueMinimum = lrint( mRate * times.latency );
             mPlaybackQueueMinimum =
@@ -982,13 +1034,6 @@ bool AudioIO::AllocateBuffers(
                mPlaybackTracks[i]->SetOldChannelGain(0, 0.0);
                mPlaybackTracks[i]->SetOldChannelGain(1, 0.0);
 
-               mPlaybackBuffers[i] =
-                  std::make_unique<RingBuffer>(floatSample, playbackBufferSize);
-
-               // use track time for the end time, not real time!
-               SampleTrackConstArray mixTracks;
-               mixTracks.push_back(mPlaybackTracks[i]);
-
                double endTime;
                if (make_iterator_range(tracks.prerollTracks)
                       .contains(mPlaybackTracks[i]))
@@ -1000,23 +1045,58 @@ bool AudioIO::AllocateBuffers(
                   // at the right time, though transport may continue to record
                   endTime = t1;
 
-               mPlaybackMixers[i] = std::make_unique<Mixer>
-                  (mixTracks,
-                  // Don't throw for read errors, just play silence:
-                  false,
-                  warpOptions,
-                  mPlaybackSchedule.mT0,
-                  endTime,
-                  1,
-                  std::max( mPlaybackSamplesToCopy, mPlaybackQueueMinimum ),
-                  false,
-                  mRate, floatSample,
-                  false, // low quality dithering and resampling
-                  nullptr,
-                  false // don't apply track gains
-               );
+               mPlaybackMixers[i] =
+                  MakePlaybackMixer(mPlaybackTracks[i], endTime);
+            }
+
+            // Take the pre-roll of a recording from the last playback, if
+            // it played all the same tracks through that time unchanged, and
+            // begin mixing after it.  Not with a time track:  the history
+            // keeps only unwarped samples, and the pre-roll must be warped
+            mPreRollSamples.clear();
+            mPreRollFrames = 0;
+            mPreRollTaken = 0;
+            const auto preRollFrames = static_cast<size_t>(
+               lrint(mRecordingSchedule.mPreRoll * mRate));
+            if (!mCaptureTracks.empty() && !mPlaybackTracks.empty() &&
+                preRollFrames > 0 && !options.pStartTime &&
+                !mPlaybackSchedule.mEnvelope &&
+                mPlaybackHistory.GetRate() == mRate) {
+               mPreRollSamples.resize(mPlaybackTracks.size());
+               bool kept = true;
+               for (size_t i = 0; kept && i < mPlaybackTracks.size(); ++i) {
+                  mPreRollSamples[i].resize(preRollFrames);
+                  kept = mPlaybackHistory.Get(*mPlaybackTracks[i],
+                     mPlaybackSchedule.mT0, preRollFrames,
+                     mPreRollSamples[i].data());
+               }
+               if (kept) {
+                  mPreRollFrames = preRollFrames;
+                  for (auto &pMixer : mPlaybackMixers)
+                     pMixer->Reposition(
+                        mPlaybackSchedule.mT0 + preRollFrames / mRate, true);
+               }
+               else
+                  mPreRollSamples.clear();
             }
 
+            // Keep enough of this playback for the pre-roll of a recording
+            // from where it stops, though the buffers ran ahead of that
+            double preRoll;
+            gPrefs->Read(AUDIO_PRE_ROLL_KEY, &preRoll, DEFAULT_PRE_ROLL_SECONDS);
+            const auto historySize = std::min<size_t>(
+               lrint(mRate * (std::max(0.0, preRoll) + mPlaybackRingBufferSecs)),
+               MaxPlaybackHistorySamples /
+                  std::max<size_t>(1, mPlaybackTracks.size()));
+            mPlaybackHistory.Reset(
+               SampleTrackConstArray(
+                  mPlaybackTracks.begin(), mPlaybackTracks.end()),
+               mRate, historySize);
+
+            for (unsigned int i = 0; i < numSlots; i++)
+               mPlaybackBuffers[i] =
+                  std::make_unique<RingBuffer>(floatSample, playbackBufferSize);
+
             const auto timeQueueSize = 1 +
                (playbackBufferSize + TimeQueueGrainSize - 1)
                   / TimeQueueGrainSize;
@@ -1078,6 +1158,30 @@ bool AudioIO::AllocateBuffers(
    return true;
 }
 
+std::unique_ptr<Mixer> AudioIO::MakePlaybackMixer(
+   const std::shared_ptr<WaveTrack> &track, double endTime)
+{
+   // use track time for the end time, not real time!
+   SampleTrackConstArray mixTracks;
+   mixTracks.push_back(track);
+
+   return std::make_unique<Mixer>
+      (mixTracks,
+      // Don't throw for read errors, just play silence:
+      false,
+      mPlaybackSchedule.GetPolicy().MixerWarpOptions(mPlaybackSchedule),
+      mPlaybackSchedule.mT0,
+      endTime,
+      1,
+      std::max( mPlaybackSamplesToCopy, mPlaybackQueueMinimum ),
+      false,
+      mRate, floatSample,
+      false, // low quality dithering and resampling
+      nullptr,
+      false // don't apply track gains
+   );
+}
+
 void AudioIO::StartStreamCleanup(bool bOnlyBuffers)
 {
    mpTransportState.reset();
@@ -1086,9 +1190,22 @@ void AudioIO::StartStreamCleanup(bool bOnlyBuffers)
    mScratchBuffers.clear();
    mScratchPointers.clear();
    mPlaybackMixers.clear();
+   mPendingPlaybackMixers.clear();
+   mPreRollSamples.clear();
+   mPreRollFrames = 0;
+   mPreRollTaken = 0;
+   mPlaybackSlots.Reset(0);
+   mAddedPlaybackTracks.clear();
+   mProducingSlots.clear();
+   mPlayingSlots.clear();
    mCaptureBuffers.reset();
    mResample.reset();
+   mCaptureWorkers.reset();
    mPlaybackSchedule.mTimeQueue.mData.reset();
+   if (mCaptureJournal) {
+      mCaptureJournal->Discard();
+      mCaptureJournal.reset();
+   }
 
    if(!bOnlyBuffers)
    {
@@ -1235,6 +1352,10 @@ void AudioIO::StopStream()
          mScratchBuffers.clear();
          mScratchPointers.clear();
          mPlaybackMixers.clear();
+         mPendingPlaybackMixers.clear();
+         mPreRollSamples.clear();
+         mPreRollFrames = 0;
+         mPreRollTaken = 0;
          mPlaybackSchedule.mTimeQueue.mData.reset();
       }
 
@@ -1243,8 +1364,19 @@ void AudioIO::StopStream()
       //
       if (mCaptureTracks.size() > 0)
       {
+#if defined(_DEBUG)
+         // How near the recording came to losing samples
+         std::cout << "Recorded " << mCaptureTracks.size() << " channels"
+            << ", least capture buffer headroom "
+            << std::lround(100 * mLeastCaptureHeadroom) << "%"
+            << ", longest drain " << std::lround(1000 * mLongestCaptureDrain)
+            << " ms of " << std::lround(1000 * mCaptureRingBufferSecs)
+            << " ms buffered, lost " << mLostSamples << " samples" << std::endl;
+#endif
+
          mCaptureBuffers.reset();
          mResample.reset();
+         mCaptureWorkers.reset();
 
          //
          // We only apply latency correction when we actually played back
@@ -1299,6 +1431,14 @@ void AudioIO::StopStream()
 
          if (pListener)
             pListener->OnCommitRecording();
+
+         // Now the recording is in the project, unless the listener said
+         // otherwise
+         if (mCaptureJournal) {
+            if (!mKeepCaptureJournal)
+               mCaptureJournal->Discard();
+            mCaptureJournal.reset();
+         }
       }
    }
 
@@ -1351,6 +1491,10 @@ void AudioIO::StopStream()
    mNumCaptureChannels = 0;
    mNumPlaybackChannels = 0;
 
+   mPlaybackSlots.Reset(0);
+   mAddedPlaybackTracks.clear();
+   mProducingSlots.clear();
+   mPlayingSlots.clear();
    mPlaybackTracks.clear();
    mCaptureTracks.clear();
 
@@ -1471,8 +1615,9 @@ double AudioIO::GetStreamTime()
 
 size_t AudioIO::GetCommonlyFreePlayback()
 {
+   // Added tracks hold fewer frames than the others, so they have more space
    auto commonlyAvail = mPlaybackBuffers[0]->AvailForPut();
-   for (unsigned i = 1; i < mPlaybackTracks.size(); ++i)
+   for (auto i : mProducingSlots)
       commonlyAvail = std::min(commonlyAvail,
          mPlaybackBuffers[i]->AvailForPut());
    // MB: subtract a few samples because the code in TrackBufferExchange has rounding
@@ -1480,15 +1625,59 @@ size_t AudioIO::GetCommonlyFreePlayback()
    return commonlyAvail - std::min(size_t(10), commonlyAvail);
 }
 
-size_t AudioIoCallback::GetCommonlyReadyPlayback()
+size_t AudioIoCallback::GetCommonlyReadyPlayback(
+   const std::vector<size_t> &slots)
 {
    auto commonlyAvail = mPlaybackBuffers[0]->AvailForGet();
-   for (unsigned i = 1; i < mPlaybackTracks.size(); ++i)
+   for (auto i : slots) {
+      // Count the zeroes before the first frame of an added track as ready
+      const auto avail = mPlaybackBuffers[i]->AvailForGet();
       commonlyAvail = std::min(commonlyAvail,
-         mPlaybackBuffers[i]->AvailForGet());
+         avail + PlaybackLead(i, commonlyAvail));
+   }
    return commonlyAvail;
 }
 
+size_t AudioIoCallback::PlaybackLead(size_t iSlot, size_t len) const
+{
+   const auto consumed =
+      mPlaybackFramesConsumed.load(std::memory_order_relaxed);
+   const auto start = mPlaybackStartFrames[iSlot];
+   return start > consumed
+      ? std::min<long long>(len, start - consumed)
+      : 0;
+}
+
+WaveTrack *AudioIoCallback::GetPlaybackSlotTrack(size_t iSlot) const
+{
+   const auto numPlaybackTracks = mPlaybackTracks.size();
+   return iSlot < numPlaybackTracks
+      ? mPlaybackTracks[iSlot].get()
+      : mAddedPlaybackTracks[iSlot - numPlaybackTracks].get();
+}
+
+void AudioIoCallback::UpdatePlayingSlots()
+{
+   const auto numPlaybackTracks = mPlaybackTracks.size();
+
+   // Nothing more is put to the buffers of removed tracks.  Empty them, so
+   // that their slots begin again with empty buffers when reused
+   const auto draining = mPlaybackSlots.Draining();
+   for (size_t k = 0; k < mPlaybackSlots.Size(); ++k)
+      if (draining & PlaybackSlots::Bit(k)) {
+         auto &pBuffer = mPlaybackBuffers[numPlaybackTracks + k];
+         pBuffer->Discard(pBuffer->AvailForGet());
+      }
+   mPlaybackSlots.Free(draining);
+
+   // Within the reserved capacity, so this doesn't allocate
+   const auto playing = mPlaybackSlots.Playing();
+   mPlayingSlots.resize(numPlaybackTracks);
+   for (size_t k = 0; k < mPlaybackSlots.Size(); ++k)
+      if (playing & PlaybackSlots::Bit(k))
+         mPlayingSlots.push_back(numPlaybackTracks + k);
+}
+
 size_t AudioIO::GetCommonlyAvailCapture()
 {
    auto commonlyAvail = mCaptureBuffers[0]->AvailForGet();
@@ -1512,6 +1701,8 @@ void AudioIO::FillPlayBuffers()
    if (mNumPlaybackChannels == 0)
       return;
 
+   TakePlaybackSlotChanges();
+
    // Though extremely unlikely, it is possible that some buffers
    // will have more samples available than others.  This could happen
    // if we hit this code during the PortAudio callback.  To keep
@@ -1532,7 +1723,7 @@ void AudioIO::FillPlayBuffers()
    // May produce a larger amount when initially priming the buffer, or
    // perhaps again later in play to avoid underfilling the queue and falling
    // behind the real-time demand on the consumer side in the callback.
-   auto nReady = GetCommonlyReadyPlayback();
+   auto nReady = GetCommonlyReadyPlayback(mProducingSlots);
    auto nNeeded =
       mPlaybackQueueMinimum - std::min(mPlaybackQueueMinimum, nReady);
 
@@ -1550,18 +1741,25 @@ void AudioIO::FillPlayBuffers()
    // user interface.
    bool done = false;
    do {
-      const auto [frames, toProduce] =
-         policy.GetPlaybackSlice(mPlaybackSchedule, available);
+      // The pre-roll taken from memory comes in slices of its own
+      const bool preRolling = mPreRollTaken < mPreRollFrames;
+      const auto [frames, toProduce] = policy.GetPlaybackSlice(
+         mPlaybackSchedule, preRolling
+            ? std::min(available, mPreRollFrames - mPreRollTaken)
+            : available);
 
       // Update the time queue.  This must be done before writing to the
       // ring buffers of samples, for proper synchronization with the
       // consumer side in the PortAudio thread, which reads the time
       // queue after reading the sample queues.  The sample queues use
       // atomic variables, the time queue doesn't.
+      const auto sliceTime = mPlaybackSchedule.mTimeQueue.mLastTime;
       mPlaybackSchedule.mTimeQueue.Producer( mPlaybackSchedule, mRate,
          frames);
+      mPlaybackHistory.BeginSlice(
+         sliceTime, mPlaybackSchedule.mTimeQueue.mLastTime, frames);
 
-      for (size_t i = 0; i < mPlaybackTracks.size(); i++)
+      for (auto i : mProducingSlots)
       {
          // The mixer here isn't actually mixing: it's just doing
          // resampling, format conversion, and possibly time track
@@ -1569,21 +1767,40 @@ void AudioIO::FillPlayBuffers()
          if (frames > 0)
          {
             size_t produced = 0;
-            if ( toProduce )
-               produced = mPlaybackMixers[i]->Process( toProduce );
-            //wxASSERT(produced <= toProduce);
-            auto warpedSamples = mPlaybackMixers[i]->GetBuffer();
+            constSamplePtr warpedSamples;
+            if (preRolling && i < mPreRollSamples.size()) {
+               if ( !mPlaybackRetired[i] )
+                  produced = toProduce;
+               warpedSamples = reinterpret_cast<constSamplePtr>(
+                  mPreRollSamples[i].data() + mPreRollTaken);
+            }
+            else {
+               auto &mixer = GetPlaybackSlotMixer(i);
+               // Removed tracks are silent; don't bother mixing them
+               if ( toProduce && !mPlaybackRetired[i] )
+                  produced = mixer.Process( toProduce );
+               //wxASSERT(produced <= toProduce);
+               warpedSamples = mixer.GetBuffer();
+            }
             /* const auto put = */ mPlaybackBuffers[i]->Put(
                warpedSamples, floatSample, produced, frames - produced);
             // wxASSERT(put == frames);
             // but we can't assert in this thread
+            mPlaybackHistory.Put(i,
+               reinterpret_cast<const float*>(warpedSamples), produced);
          }
       }
+      mPlaybackHistory.EndSlice();
 
-      if (mPlaybackTracks.empty())
+      // The pre-roll is freed on the main thread when the stream stops
+      if (preRolling)
+         mPreRollTaken += frames;
+
+      if (mProducingSlots.empty())
          // Produce silence in the single ring buffer
          mPlaybackBuffers[0]->Put(nullptr, floatSample, 0, frames);
 
+      mPlaybackFramesProduced += frames;
       available -= frames;
       // wxASSERT(available >= 0); // don't assert on this thread
 
@@ -1603,10 +1820,115 @@ void AudioIO::FillPlayBuffers()
    indicates the readiness of sample data to the consumer.  That atomic
    also sychronizes the use of the TimeQueue.
    */
-   for (size_t i = 0; i < std::max(size_t{1}, mPlaybackTracks.size()); ++i)
+   if (mProducingSlots.empty())
+      mPlaybackBuffers[0]->Flush();
+   for (auto i : mProducingSlots)
       mPlaybackBuffers[i]->Flush();
 }
 
+Mixer &AudioIO::GetPlaybackSlotMixer(size_t iSlot)
+{
+   const auto numPlaybackTracks = mPlaybackTracks.size();
+   return iSlot < numPlaybackTracks
+      ? *mPlaybackMixers[iSlot]
+      : *mPlaybackMixers[
+         mAddedPlaybackMixerIndices[iSlot - numPlaybackTracks]];
+}
+
+void AudioIO::TakePlaybackSlotChanges()
+{
+   const auto changes = mPlaybackSlots.Take();
+   if (!changes.added && !changes.retired)
+      return;
+
+   // Start the new mixers where the others have got to.  The new ring
+   // buffers are empty, so their first frames follow the frames already put
+   // to the others.
+   const auto numPlaybackTracks = mPlaybackTracks.size();
+   const auto time = mPlaybackSchedule.mTimeQueue.mLastTime;
+   for (size_t k = 0; k < mPlaybackSlots.Size(); ++k) {
+      if (!(changes.added & PlaybackSlots::Bit(k)))
+         continue;
+      auto &pMixer = mPendingPlaybackMixers[k];
+      pMixer->Reposition(time, true);
+      mPlaybackStartFrames[numPlaybackTracks + k] = mPlaybackFramesProduced;
+      auto &index = mAddedPlaybackMixerIndices[k];
+      if (index == NoPlaybackMixer) {
+         // Within the reserved capacity, so this doesn't allocate
+         index = mPlaybackMixers.size();
+         mPlaybackMixers.push_back(std::move(pMixer));
+      }
+      else
+         // Leave the mixer of the slot's previous track for the main thread
+         // to destroy
+         mPlaybackMixers[index].swap(pMixer);
+   }
+   mPlaybackSlots.Publish(changes);
+
+   // Within the reserved capacity, so this doesn't allocate
+   const auto producing = mPlaybackSlots.Producing();
+   mProducingSlots.resize(numPlaybackTracks);
+   for (size_t k = 0; k < mPlaybackSlots.Size(); ++k)
+      if (producing & PlaybackSlots::Bit(k))
+         mProducingSlots.push_back(numPlaybackTracks + k);
+}
+
+bool AudioIO::AddPlaybackTracks(const WaveTrackArray &tracks)
+{
+   if (!IsStreamActive() || mNumCaptureChannels > 0)
+      return false;
+
+   const auto active = mPlaybackSlots.Active();
+   const auto playing = [&](const std::shared_ptr<WaveTrack> &track) {
+      if (make_iterator_range(mPlaybackTracks).contains(track))
+         return true;
+      for (size_t k = 0; k < mPlaybackSlots.Size(); ++k)
+         if ((active & PlaybackSlots::Bit(k)) &&
+             mAddedPlaybackTracks[k] == track)
+            return true;
+      return false;
+   };
+   WaveTrackArray newTracks;
+   for (const auto &track : tracks)
+      if (!playing(track))
+         newTracks.push_back(track);
+   if (newTracks.empty())
+      return true;
+
+   // The channels take consecutive slots, and are handed over together
+   const auto first = mPlaybackSlots.Reserve(newTracks.size());
+   if (first == mPlaybackSlots.Size())
+      return false;
+   for (size_t ii = 0; ii < newTracks.size(); ++ii) {
+      const auto k = first + ii;
+      const auto &track = newTracks[ii];
+      // Fade in from zero, as when starting
+      track->SetOldChannelGain(0, 0.0);
+      track->SetOldChannelGain(1, 0.0);
+      // The slot is free, so the audio threads don't use what it held; the
+      // previous track and mixer are destroyed here
+      mAddedPlaybackTracks[k] = track;
+      mPendingPlaybackMixers[k] =
+         MakePlaybackMixer(track, mPlaybackMixersEndTime);
+   }
+   mPlaybackSlots.Add(first, newTracks.size());
+   return true;
+}
+
+void AudioIO::RemovePlaybackTracks(
+   const std::function<bool(const WaveTrack &)> &pred)
+{
+   if (!IsStreamActive())
+      return;
+   for (size_t i = 0; i < mPlaybackTracks.size(); ++i)
+      if (pred(*mPlaybackTracks[i]))
+         mPlaybackRetired[i] = true;
+   const auto active = mPlaybackSlots.Active();
+   for (size_t k = 0; k < mPlaybackSlots.Size(); ++k)
+      if ((active & PlaybackSlots::Bit(k)) && pred(*mAddedPlaybackTracks[k]))
+         mPlaybackSlots.Retire(k);
+}
+
 void AudioIO::TransformPlayBuffers()
 {
    // Transform written but un-flushed samples in the RingBuffers in-place.
@@ -1619,6 +1941,7 @@ void AudioIO::TransformPlayBuffers()
    if (mpTransportState && mpTransportState->mpRealtimeInitialization)
       pScope.emplace(
          *mpTransportState->mpRealtimeInitialization, mOwningProject);
+   // Tracks added while playing are not known to realtime effects
    const auto numPlaybackTracks = mPlaybackTracks.size();
    for (unsigned t = 0; t < numPlaybackTracks; ++t) {
       const auto vt = mPlaybackTracks[t].get();
@@ -1698,6 +2021,10 @@ void AudioIO::DrainRecordBuffers()
       if (mAudioThreadShouldCallTrackBufferExchangeOnce ||
           deltat >= mMinCaptureSecsToCopy)
       {
+         const auto drainStart = std::chrono::steady_clock::now();
+         mLeastCaptureHeadroom = std::min(mLeastCaptureHeadroom,
+            1.0 - avail / (mRate * mCaptureRingBufferSecs));
+
          // This scope may combine many appendings of wave tracks,
          // and also an autosave, into one transaction,
          // lessening the number of checkpoints
@@ -1711,8 +2038,21 @@ void AudioIO::DrainRecordBuffers()
          // The WaveTracks have their own buffering for efficiency.
          auto numChannels = mCaptureTracks.size();
 
-         for( size_t i = 0; i < numChannels; i++ )
-         {
+         // Reading, resampling and crossfading are independent for each
+         // channel, and can happen in parallel; so can appending to the
+         // tracks, afterwards
+         struct Captured {
+            size_t silence = 0;
+            SampleBuffer temp;
+            size_t size = 0;
+            sampleFormat format = floatSample;
+            bool latencyCorrected = true;
+         };
+         std::vector<Captured> captured(numChannels);
+         const bool streamActive = IsStreamActive();
+
+         auto capture = [&]( size_t i ) {
+            auto &result = captured[i];
             sampleFormat trackFormat = mCaptureTracks[i]->GetSampleFormat();
 
             size_t discarded = 0;
@@ -1723,10 +2063,7 @@ void AudioIO::DrainRecordBuffers()
                   // Rightward shift
                   // Once only (per track per recording), insert some initial
                   // silence.
-                  size_t size = floor( correction * mRate * mFactor);
-                  SampleBuffer temp(size, trackFormat);
-                  ClearSamples(temp.ptr(), trackFormat, 0, size);
-                  mCaptureTracks[i]->Append(temp.ptr(), trackFormat, size, 1);
+                  result.silence = floor( correction * mRate * mFactor);
                }
                else {
                   // Leftward shift
@@ -1741,7 +2078,7 @@ void AudioIO::DrainRecordBuffers()
                   if (discarded < size)
                      // We need to visit this again to complete the
                      // discarding.
-                     latencyCorrected = false;
+                     result.latencyCorrected = false;
                }
             }
 
@@ -1763,7 +2100,7 @@ void AudioIO::DrainRecordBuffers()
 
             wxASSERT(discarded <= avail);
             size_t toGet = avail - discarded;
-            SampleBuffer temp;
+            auto &temp = result.temp;
             size_t size;
             sampleFormat format;
             if( mFactor == 1.0 )
@@ -1802,7 +2139,7 @@ void AudioIO::DrainRecordBuffers()
                      toGet = floor(remainingSamples);
                   const auto results =
                   mResample[i]->Process(mFactor, (float *)temp1.ptr(), toGet,
-                                        !IsStreamActive(), (float *)temp.ptr(), size);
+                                        !streamActive, (float *)temp.ptr(), size);
                   size = results.second;
                }
             }
@@ -1824,10 +2161,67 @@ void AudioIO::DrainRecordBuffers()
                }
             }
 
-            // Now append
+            result.size = size;
+            result.format = format;
+         };
+
+         const auto forEachChannel =
+            [&](const std::function<void(size_t)> &body) {
+               if (mCaptureWorkers)
+                  mCaptureWorkers->ForEach(numChannels, body);
+               else
+                  for (size_t i = 0; i < numChannels; ++i)
+                     body(i);
+            };
+         forEachChannel(capture);
+
+         // Conversion to the format of the track may dither, and the state
+         // of dithering is shared, so convert here, one channel at a time
+         for (size_t i = 0; i < numChannels; ++i) {
+            auto &result = captured[i];
+            const auto trackFormat = mCaptureTracks[i]->GetSampleFormat();
+            if (result.format != trackFormat && result.size > 0) {
+               SampleBuffer converted(result.size, trackFormat);
+               CopySamples(result.temp.ptr(), result.format,
+                  converted.ptr(), trackFormat, result.size);
+               result.temp = std::move(converted);
+               result.format = trackFormat;
+            }
+         }
+
+         // Each channel appends to its own track.  The blocks' summaries are
+         // computed in parallel; the sample block factory writes the blocks
+         // to the database one at a time, inside the transaction
+         std::vector<char> appended(numChannels, 0);
+         forEachChannel([&](size_t i) {
+            auto &result = captured[i];
+            auto &track = *mCaptureTracks[i];
+            bool newTrackBlocks = false;
+            if (result.silence > 0) {
+               sampleFormat trackFormat = track.GetSampleFormat();
+               SampleBuffer temp(result.silence, trackFormat);
+               ClearSamples(temp.ptr(), trackFormat, 0, result.silence);
+               newTrackBlocks =
+                  track.Append(temp.ptr(), trackFormat, result.silence, 1);
+            }
             // see comment in second handler about guarantee
-            newBlocks = mCaptureTracks[i]->Append(temp.ptr(), format, size, 1)
-               || newBlocks;
+            newTrackBlocks = track.Append(
+               result.temp.ptr(), result.format, result.size, 1)
+               || newTrackBlocks;
+            appended[i] = newTrackBlocks;
+         });
+
+         for( size_t i = 0; i < numChannels; i++ )
+         {
+            auto &result = captured[i];
+            latencyCorrected = latencyCorrected && result.latencyCorrected;
+            newBlocks = newBlocks || appended[i];
+            if (mCaptureJournal) {
+               if (result.silence > 0)
+                  mCaptureJournal->AppendSilence(i, result.silence);
+               mCaptureJournal->Append(
+                  i, result.temp.ptr(), result.format, result.size);
+            }
          } // end loop over capture channels
 
          // Now update the recording schedule position
@@ -1840,6 +2234,10 @@ void AudioIO::DrainRecordBuffers()
 
          if (pScope)
             pScope->Commit();
+
+         mLongestCaptureDrain = std::max(mLongestCaptureDrain,
+            std::chrono::duration<double>(
+               std::chrono::steady_clock::now() - drainStart).count());
       }
       // end of record buffering
    },
@@ -1916,13 +2314,8 @@ void AudioIoCallback::CheckSoundActivatedRecordingLevel(
    if( !mPauseRec )
       return;
 
-   float maxPeak = 0.;
-   for( unsigned long i = 0, cnt = framesPerBuffer * mNumCaptureChannels; i < cnt; ++i ) {
-      float sample = fabs(*(inputSamples++));
-      if (sample > maxPeak) {
-         maxPeak = sample;
-      }
-   }
+   const float maxPeak = SignalFeatures::Peak(
+      inputSamples, framesPerBuffer * mNumCaptureChannels);
 
    bool bShouldBePaused = maxPeak < mSilenceLevel;
    if( bShouldBePaused != IsPaused() )
@@ -2029,7 +2422,7 @@ bool AudioIoCallback::FillOutputBuffers(
    // Debug
    assert(mBuffersPrepared);
 
-   const auto numPlaybackTracks = mPlaybackTracks.size();
+   const auto numPlaybackTracks = mPlayingSlots.size();
    const auto numPlaybackChannels = mNumPlaybackChannels;
    const auto numCaptureChannels = mNumCaptureChannels;
 
@@ -2064,7 +2457,8 @@ bool AudioIoCallback::FillOutputBuffers(
 
       // Choose a common size to take from all ring buffers
       const auto toGet =
-         std::min<size_t>(framesPerBuffer, GetCommonlyReadyPlayback());
+         std::min<size_t>(framesPerBuffer,
+            GetCommonlyReadyPlayback(mPlayingSlots));
 
       // The drop and dropQuickly booleans are so named for historical reasons.
       // JKC: The original code attempted to be faster by doing nothing on silenced audio.
@@ -2081,15 +2475,16 @@ bool AudioIoCallback::FillOutputBuffers(
 
       bool drop = false;        // Track should become silent.
       bool dropQuickly = false; // Track has already been faded to silence.
-      for (unsigned t = 0; t < numPlaybackTracks; t++)
+      for (unsigned i = 0; i < numPlaybackTracks; i++)
       {
-         WaveTrack* vt = mPlaybackTracks[t].get();
+         const auto t = mPlayingSlots[i];
+         WaveTrack* vt = GetPlaybackSlotTrack(t);
          mTrackChannelsBuffer[chanCnt] = vt;
 
          // TODO: more-than-two-channels
          auto nextTrack =
-            t + 1 < numPlaybackTracks
-               ? mPlaybackTracks[t + 1].get()
+            i + 1 < numPlaybackTracks
+               ? GetPlaybackSlotTrack(mPlayingSlots[i + 1])
                : nullptr;
 
          // First and last channel in this group (for example left and right
@@ -2106,7 +2501,7 @@ bool AudioIoCallback::FillOutputBuffers(
                // TODO: more-than-two-channels
                memset(mAudioScratchBuffers[1], 0, framesPerBuffer * sizeof(float));
             }
-            drop = TrackShouldBeSilent( *vt );
+            drop = TrackShouldBeSilent( *vt ) || mPlaybackRetired[t];
             dropQuickly = drop;
          }
 
@@ -2115,17 +2510,21 @@ bool AudioIoCallback::FillOutputBuffers(
             
          decltype(framesPerBuffer) len = 0;
 
+         // A track added while playing begins later than the others
+         const auto lead = PlaybackLead(t, toGet);
+
          if (dropQuickly)
          {
-            len = mPlaybackBuffers[t]->Discard(toGet);
+            len = lead + mPlaybackBuffers[t]->Discard(toGet - lead);
             // keep going here.  
             // we may still need to issue a paComplete.
          }
          else
          {
-            len = mPlaybackBuffers[t]->Get((samplePtr)mAudioScratchBuffers[chanCnt],
-                                                      floatSample,
-                                                      toGet);
+            memset(mAudioScratchBuffers[chanCnt], 0, lead * sizeof(float));
+            len = lead + mPlaybackBuffers[t]->Get(
+               (samplePtr)(mAudioScratchBuffers[chanCnt] + lead),
+               floatSample, toGet - lead);
             // assert( len == toGet );
             if (len < framesPerBuffer)
             {
@@ -2202,6 +2601,8 @@ bool AudioIoCallback::FillOutputBuffers(
          mMaxFramesOutput = mPlaybackBuffers[0]->Discard(toGet);
          CallbackCheckCompletion(mCallbackReturn, 0);
       }
+      else
+         mPlaybackFramesConsumed.fetch_add(toGet, std::memory_order_relaxed);
 
       // assert( maxLen == toGet );
    }
@@ -2504,12 +2905,10 @@ void AudioIoCallback::SendVuOutputMeterData(
 }
 
 unsigned AudioIoCallback::CountSoloingTracks(){
-   const auto numPlaybackTracks = mPlaybackTracks.size();
-
    // MOVE_TO: CountSoloedTracks() function
    unsigned numSolo = 0;
-   for(unsigned t = 0; t < numPlaybackTracks; t++ )
-      if( mPlaybackTracks[t]->GetSolo() )
+   for (auto t : mPlayingSlots)
+      if( GetPlaybackSlotTrack(t)->GetSolo() )
          numSolo++;
    auto range = Extensions();
    numSolo += std::accumulate(range.begin(), range.end(), 0,
@@ -2550,9 +2949,9 @@ bool AudioIoCallback::TrackHasBeenFadedOut( const WaveTrack &wt )
 bool AudioIoCallback::AllTracksAlreadySilent()
 {
    const bool dropAllQuickly = std::all_of(
-      mPlaybackTracks.begin(), mPlaybackTracks.end(),
-      [&]( const std::shared_ptr< WaveTrack > &vt )
-         { return 
+      mPlayingSlots.begin(), mPlayingSlots.end(),
+      [&]( size_t t )
+         { const auto vt = GetPlaybackSlotTrack(t); return 
       TrackShouldBeSilent( *vt ) && 
       TrackHasBeenFadedOut( *vt ); }
    );
@@ -2579,6 +2978,9 @@ int AudioIoCallback::AudioCallback(
    const PaStreamCallbackTimeInfo *timeInfo,
    const PaStreamCallbackFlags statusFlags, void * /* userData */ )
 {
+   // Take the tracks added to and removed from playback
+   UpdatePlayingSlots();
+
    // Poll tracks for change of state.  User might click mute and solo buttons.
    mbHasSoloTracks = CountSoloingTracks() > 0 ;
    mCallbackReturn = paContinue;
@@ -2682,14 +3084,14 @@ int AudioIoCallback::CallbackDoSeek()
       // This stream got destroyed while we waited for it
       return paAbort;
 
-   const auto numPlaybackTracks = mPlaybackTracks.size();
-
    // Pause audio thread and wait for it to finish
    mAudioThreadTrackBufferExchangeLoopRunning = false;
    while( mAudioThreadTrackBufferExchangeLoopActive )
    {
       std::this_thread::sleep_for(std::chrono::milliseconds( 50 ));
    }
+   // Include tracks that it added meanwhile
+   UpdatePlayingSlots();
 
    // Calculate the NEW time position, in the PortAudio callback
    const auto time = mPlaybackSchedule.ClampTrackTime(
@@ -2700,17 +3102,22 @@ int AudioIoCallback::CallbackDoSeek()
    mPlaybackSchedule.RealTimeInit( time );
 
    // Reset mixer positions and flush buffers for all tracks
-   for (size_t i = 0; i < numPlaybackTracks; i++)
+   const bool skipping = true;
+   for (auto &pMixer : mPlaybackMixers)
+      pMixer->Reposition( time, skipping );
+   for (auto i : mPlayingSlots)
    {
-      const bool skipping = true;
-      mPlaybackMixers[i]->Reposition( time, skipping );
       const auto toDiscard =
          mPlaybackBuffers[i]->AvailForGet();
       const auto discarded =
          mPlaybackBuffers[i]->Discard( toDiscard );
       // assert( discarded == toDiscard );
       // but we can't assert in this thread
+      mPlaybackStartFrames[i] = 0;
    }
+   // All buffers are empty and begin together again
+   mPlaybackFramesProduced = 0;
+   mPlaybackFramesConsumed.store(0, std::memory_order_relaxed);
 
    mPlaybackSchedule.mTimeQueue.Prime(time);
 
@@ -2758,3 +3165,8 @@ bool AudioIO::IsCapturing() const
       mPlaybackSchedule.GetTrackTime() >=
          mPlaybackSchedule.mT0 + mRecordingSchedule.mPreRoll;
 }
+
+bool AudioIO::IsCaptureJournaling() const
+{
+   return mCaptureJournal && mCaptureJournal->IsGood();
+}
@@ -29,11 +29,14 @@
 #include <lib-components/ModuleInterface.h>
 #include <lib-math/SampleCount.h>
 #include <lib-math/SampleFormat.h>
+#include <lib-sample-track/PlaybackHistory.h>
+#include <lib-sample-track/PlaybackSlots.h>
 #include <lib-utility/MessageBuffer.h>
 #include <lib-utility/Observer.h>
 
 class AudioIOBase;
 class AudioIO;
+class CaptureJournal;
 class RingBuffer;
 class Mixer;
 class RealtimeEffectState;
@@ -41,6 +44,7 @@ class Resample;
 class SelectedRegion;
 
 class TenacityProject;
+class WorkerPool;
 
 class PlayableTrack;
 using PlayableTrackConstArray =
@@ -253,7 +257,7 @@ public:
    *
    * Returns the smallest of the buffer ready space values in the event that
    * they are different. */
-   size_t GetCommonlyReadyPlayback();
+   size_t GetCommonlyReadyPlayback(const std::vector<size_t> &slots);
 
    /// How many frames of zeros were output due to pauses?
    long    mNumPauseFrames;
@@ -268,6 +272,46 @@ public:
    std::vector<float *> mScratchPointers; //!< pointing into mScratchBuffers
 
    std::vector<std::unique_ptr<Mixer>> mPlaybackMixers;
+
+   // Tracks added while playing.  Spare slots follow those of
+   // mPlaybackTracks, each with a ring buffer allocated when the stream
+   // started.  The main thread fills a free slot with a track and a mixer;
+   // mPlaybackSlots hands it to the audio thread, then to the PortAudio
+   // thread, and back to the main thread when the track is removed.
+
+   PlaybackSlots       mPlaybackSlots;
+   //! Track of each spare slot, changed only while the slot is free
+   WaveTrackArray      mAddedPlaybackTracks;
+   //! Mixer made by the main thread for each spare slot.  The audio thread
+   //! swaps it with the mixer of the slot's previous track
+   std::vector<std::unique_ptr<Mixer>> mPendingPlaybackMixers;
+   //! Where the audio thread keeps the mixer of each spare slot in
+   //! mPlaybackMixers
+   std::vector<size_t> mAddedPlaybackMixerIndices;
+   //! Slots that the audio thread fills, the leading ones first
+   std::vector<size_t> mProducingSlots;
+   //! Slots that the PortAudio thread plays, the leading ones first
+   std::vector<size_t> mPlayingSlots;
+   //! For each slot, the count of frames that the other buffers held before
+   //! its first frame
+   std::vector<long long> mPlaybackStartFrames;
+   //! Set by the main thread for tracks that were removed
+   ArrayOf<std::atomic<bool>> mPlaybackRetired;
+   //! Frames put to each playback buffer, by the audio thread
+   long long           mPlaybackFramesProduced{ 0 };
+   //! Frames got from each playback buffer, by the PortAudio thread
+   std::atomic<long long> mPlaybackFramesConsumed{ 0 };
+   //! End time of the playback mixers
+   double              mPlaybackMixersEndTime{ 0 };
+
+   //! Track of a slot, leading or spare
+   WaveTrack *GetPlaybackSlotTrack(size_t iSlot) const;
+   //! Empty the buffers of removed tracks and find the slots to play, at the
+   //! start of each callback
+   void UpdatePlayingSlots();
+   //! Zeroes that a slot begins with, out of the next len frames that the
+   //! PortAudio thread gets
+   size_t PlaybackLead(size_t iSlot, size_t len) const;
    static int          mNextStreamToken;
    double              mFactor;
    unsigned long       mMaxFramesOutput; // The actual number of frames output.
@@ -291,6 +335,10 @@ public:
    unsigned int        mNumPlaybackChannels{ 0 };
    sampleFormat        mCaptureFormat;
    unsigned long long  mLostSamples{ 0 };
+   /// Least fraction of the capture buffers found free when draining them
+   double              mLeastCaptureHeadroom{ 1.0 };
+   /// Longest time that draining the capture buffers took, in seconds
+   double              mLongestCaptureDrain{ 0.0 };
    volatile bool       mAudioThreadShouldCallTrackBufferExchangeOnce;
    volatile bool       mAudioThreadTrackBufferExchangeLoopRunning;
    volatile bool       mAudioThreadTrackBufferExchangeLoopActive;
@@ -456,6 +504,13 @@ public:
    // Meaning really capturing, not just pre-rolling
    bool IsCapturing() const;
 
+   //! Whether the recording in progress is also kept in a capture journal
+   /*! Called from the audio thread, which appends to the journal */
+   bool IsCaptureJournaling() const;
+   //! Don't discard the capture journal when recording stops, because the
+   //! recording could not be saved in the project
+   void KeepCaptureJournal() { mKeepCaptureJournal = true; }
+
    /** \brief Ensure selected device names are valid
     *
     */
@@ -487,6 +542,22 @@ public:
     */
    double GetStreamTime();
 
+   //! Play more tracks, without stopping the stream
+   /*!
+    Call from the main thread, while playing but not recording, with the
+    channels of one track.  They begin playing together and in step with
+    the others, after what is already in the playback buffers, and without
+    realtime effects.
+    @return false if the stream has no free slots for them
+    */
+   bool AddPlaybackTracks(const WaveTrackArray &tracks);
+
+   //! Silence playing tracks that pred accepts, without stopping the stream
+   /*! The slots of added tracks can then be reused.  The stream keeps the
+    tracks it started with until it stops */
+   void RemovePlaybackTracks(
+      const std::function<bool(const WaveTrack &)> &pred);
+
    friend void StartAudioIOThread();
 
    static void Init();
@@ -529,6 +600,13 @@ private:
 
    //! First part of TrackBufferExchange
    void FillPlayBuffers();
+   //! Begin filling the buffers of tracks that the main thread added, and
+   //! stop for those it removed
+   void TakePlaybackSlotChanges();
+   //! Mixer of a slot, leading or spare, for the audio thread
+   Mixer &GetPlaybackSlotMixer(size_t iSlot);
+   std::unique_ptr<Mixer> MakePlaybackMixer(
+      const std::shared_ptr<WaveTrack> &track, double endTime);
    void TransformPlayBuffers();
 
    //! Second part of TrackBufferExchange
@@ -566,6 +644,22 @@ private:
    std::mutex mPostRecordingActionMutex;
    PostRecordingAction mPostRecordingAction;
    bool mDelayingActions{ false };
+
+   std::unique_ptr<CaptureJournal> mCaptureJournal;
+   bool mKeepCaptureJournal{ false };
+
+   //! Threads that help drain the capture buffers of many channels
+   std::unique_ptr<WorkerPool> mCaptureWorkers;
+
+   //! What the audio thread last produced for playback, kept for the
+   //! pre-roll of a following recording
+   PlaybackHistory mPlaybackHistory;
+   //! Pre-roll taken from mPlaybackHistory, for each of the first playback
+   //! tracks, and put to the playback buffers instead of mixing
+   std::vector<std::vector<float>> mPreRollSamples;
+   size_t mPreRollFrames{ 0 };
+   //! Frames of mPreRollSamples already put, by the audio thread
+   size_t mPreRollTaken{ 0 };
 };
 
 #endif
@@ -11,6 +11,8 @@ Paul Licameli split from AutoRecovery.cpp
 #include "AutoRecoveryDialog.h"
 
 #include "ActiveProjects.h"
+#include "CaptureJournal.h"
+#include "ProjectHistory.h"
 #include "ProjectManager.h"
 #include "ProjectFileIO.h"
 #include "ProjectFileManager.h"
@@ -25,6 +27,9 @@ Paul Licameli split from AutoRecovery.cpp
 #include <wx/filename.h>
 #include <wx/dataview.h>
 
+// Tenacity libraries
+#include <lib-exceptions/TenacityException.h>
+
 enum {
    ID_QUIT_AUDACITY = 10000,
    ID_DISCARD_SELECTED,
@@ -366,6 +371,46 @@ static void DiscardAllProjects(const FilePaths &files)
       ProjectFileManager::DiscardAutosave(file);
 }
 
+//! Offer to make tracks of recordings whose capture journals were left
+//! behind, when recording was interrupted by a crash
+static bool RecoverCaptureJournals(TenacityProject *&pproj)
+{
+   const auto leftovers = CaptureJournal::FindLeftovers();
+   if (leftovers.empty())
+      return false;
+
+   const auto ret = AudacityMessageBox(
+      XO("Tenacity found %d recording(s) that were interrupted.\n\n"
+         "Choose \"Yes\" to recover them as tracks of a project, "
+         "\"No\" to discard them, or \"Cancel\" to decide later.")
+         .Format(static_cast<int>(leftovers.size())),
+      XO("Automatic Crash Recovery"),
+      wxICON_QUESTION | wxYES_NO | wxCANCEL);
+   if (ret == wxCANCEL)
+      return false;
+   if (ret == wxNO) {
+      for (const auto &leftover : leftovers)
+         CaptureJournal::Remove(leftover);
+      return false;
+   }
+
+   // Reuse the empty project created at application startup, if it remains
+   auto project = pproj ? pproj : ProjectManager::New();
+   pproj = nullptr;
+   bool recovered = false;
+   for (const auto &leftover : leftovers)
+      GuardedCall([&]{
+         if (CaptureJournal::Recover(*project, leftover)) {
+            CaptureJournal::Remove(leftover);
+            recovered = true;
+         }
+      });
+   if (recovered)
+      ProjectHistory::Get(*project).PushState(
+         XO("Recovered interrupted recordings"), XO("Recover"));
+   return recovered;
+}
+
 bool ShowAutoRecoveryDialogIfNeeded(TenacityProject *&pproj, bool *didRecoverAnything)
 {
    if (didRecoverAnything)
@@ -422,6 +467,9 @@ bool ShowAutoRecoveryDialogIfNeeded(TenacityProject *&pproj, bool *didRecoverAny
          return false;
       }
    }
-   
+
+   if (success && RecoverCaptureJournals(pproj) && didRecoverAnything)
+      *didRecoverAnything = true;
+
    return success;
 }
@@ -32,6 +32,7 @@ using namespace std::chrono;
 #include <lib-files/FileNames.h>
 #include <lib-preferences/Prefs.h>
 
+#include "HeadlessMode.h"
 #include "Project.h"
 #include "ProjectAudioManager.h"
 #include "ProjectHistory.h"
@@ -501,7 +502,8 @@ bool MacroCommands::DoAudacityCommand(
    const PluginID & ID, const CommandContext & context, unsigned flags )
 {
    auto &project = context.project;
-   auto &window = ProjectWindow::Get( project );
+   // Null in headless mode
+   auto pWindow = ProjectWindow::Find( &project );
    const PluginDescriptor *plug = PluginManager::Get().GetPlugin(ID);
    if (!plug)
       return false;
@@ -515,7 +517,7 @@ bool MacroCommands::DoAudacityCommand(
    EffectManager & em = EffectManager::Get();
    bool success = em.DoAudacityCommand(ID, 
       context,
-      &window,
+      pWindow,
       (flags & EffectManager::kConfigured) == 0);
 
    if (!success)
@@ -532,7 +534,8 @@ bool MacroCommands::DoAudacityCommand(
       PushState(longDesc, shortDesc);
    }
 */
-   window.RedrawProject();
+   if (pWindow)
+      pWindow->RedrawProject();
    return true;
 }
 
@@ -644,8 +647,13 @@ bool MacroCommands::ApplyCommand( const TranslatableString &friendlyCommand,
       if( HandleTextualCommand(
          manager, command, *pContext, AlwaysEnabledFlag, true ) )
          return true;
-      pContext->Status( wxString::Format(
-         _("Your batch command of %s was not recognized."), friendlyCommand.Translation() ));
+      // Menu commands are not even registered in headless mode
+      if (HeadlessMode::IsEnabled())
+         pContext->Error(
+            HeadlessMode::Unsupported( friendlyCommand ).Translation() );
+      else
+         pContext->Status( wxString::Format(
+            _("Your batch command of %s was not recognized."), friendlyCommand.Translation() ));
       return false;
    }
    else
@@ -671,7 +679,9 @@ bool MacroCommands::ApplyCommandInBatchMode(
    TenacityProject *project = &mProject;
    auto &settings = ProjectSettings::Get( *project );
    // Recalc flags and enable items that may have become enabled.
-   MenuManager::Get(*project).UpdateMenus(false);
+   // There are no menus or toolbars in headless mode.
+   if (!HeadlessMode::IsEnabled())
+      MenuManager::Get(*project).UpdateMenus(false);
    // enter batch mode...
    bool prevShowMode = settings.GetShowId3Dialog();
    project->mBatchMode++;
@@ -814,6 +824,28 @@ bool MacroCommands::ApplyMacro(
    return true;
 }
 
+size_t MacroCommands::ApplyMacroToProjects(
+   const wxString & macro, const Projects & projects )
+{
+   // The projects take turns on the main thread.  They can't run on
+   // threads of their own, because:
+   // - EffectManager keeps one instance of each effect for all projects,
+   //   and SetEffectParameters() writes the macro's parameters into it
+   // - effects and many commands show progress or other dialogs
+   // - undo states are pushed through the project's window and history,
+   //   which belong to the main thread
+   size_t failures = 0;
+   for (const auto &pProject : projects) {
+      MacroCommands commands{ *pProject };
+      commands.ReadMacro( macro );
+      const MacroCommandsCatalog catalog{ pProject.get() };
+      if (!GuardedCall< bool >(
+         [&]{ return commands.ApplyMacro( catalog ); } ))
+         ++failures;
+   }
+   return failures;
+}
+
 // AbortBatch() allows a premature terminatation of a batch.
 void MacroCommands::AbortBatch()
 {
@@ -65,6 +65,13 @@ class MacroCommands final {
  public:
    bool ApplyMacro( const MacroCommandsCatalog &catalog,
       const wxString & filename = {});
+
+   using Projects = std::vector< std::shared_ptr< TenacityProject > >;
+   //! Apply the named macro to each of the projects, each with its own
+   //! commands and context
+   /*! @return how many of the projects the macro failed in */
+   static size_t ApplyMacroToProjects(
+      const wxString & macro, const Projects & projects );
    static bool HandleTextualCommand( CommandManager &commandManager,
       const CommandID & Str,
       const CommandContext & context, CommandFlag flags, bool alwaysEnabled);
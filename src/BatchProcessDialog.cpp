@@ -80,6 +80,7 @@ constexpr int ApplyToProjectID = 7003;
 constexpr int ApplyToFilesID   = 7004;
 constexpr int ExpandID         = 7005;
 constexpr int ShrinkID         = 7006;
+constexpr int ApplyToProjectsID = 7007;
 
 ApplyMacroDialog::ApplyMacroDialog(
    wxWindow * parent, TenacityProject &project, bool bInherited):
@@ -92,6 +93,7 @@ ApplyMacroDialog::ApplyMacroDialog(
 {
    Bind(wxEVT_BUTTON, &ApplyMacroDialog::OnApplyToProject, this, ApplyToProjectID);
    Bind(wxEVT_BUTTON, &ApplyMacroDialog::OnApplyToFiles, this, ApplyToFilesID);
+   Bind(wxEVT_BUTTON, &ApplyMacroDialog::OnApplyToProjects, this, ApplyToProjectsID);
    Bind(wxEVT_BUTTON, &ApplyMacroDialog::OnCancel, this, wxID_CANCEL);
    Bind(wxEVT_BUTTON, &ApplyMacroDialog::OnCancel, this, wxID_CLOSE);
    Bind(wxEVT_BUTTON, &ApplyMacroDialog::OnHelp, this, wxID_HELP);
@@ -162,6 +164,14 @@ void ApplyMacroDialog::PopulateOrExchange(ShuttleGui &S)
       btn->SetAccessible(safenew WindowAccessible(btn));
 #endif
 
+      btn = S.Id(ApplyToProjectsID)
+         .Name(XO("Apply macro to all open projects"))
+         .AddButton(XXO("Open Pro&jects"));
+#if wxUSE_ACCESSIBILITY
+      // so that name can be set on a standard control
+      btn->SetAccessible(safenew WindowAccessible(btn));
+#endif
+
       btn = S.Id(ApplyToFilesID)
          .Name(XO("Apply macro to files..."))
          .AddButton(XXO("&Files..."));
@@ -238,6 +248,33 @@ void ApplyMacroDialog::OnApplyToProject(wxCommandEvent & /* event */)
    ApplyMacroToProject( item );
 }
 
+void ApplyMacroDialog::OnApplyToProjects(wxCommandEvent & /* event */)
+{
+   long item = mMacros->GetNextItem(-1,
+                                    wxLIST_NEXT_ALL,
+                                    wxLIST_STATE_SELECTED);
+
+   if (item == -1) {
+      AudacityMessageBox(XO("No macro selected"));
+      return;
+   }
+
+   wxString name = mMacros->GetItemText(item);
+   gPrefs->Write(wxT("/Batch/ActiveMacro"), name);
+   gPrefs->Flush();
+
+   const MacroCommands::Projects projects{
+      AllProjects{}.begin(), AllProjects{}.end() };
+   const auto failures = MacroCommands::ApplyMacroToProjects(name, projects);
+   if (failures > 0)
+      AudacityMessageBox(
+         XO("The macro failed in %d of %d projects.")
+            .Format( (int)failures, (int)projects.size() ));
+
+   Show();
+   Raise();
+}
+
 CommandID ApplyMacroDialog::MacroIdOfName( const wxString & MacroName )
 {
    wxString Temp = MacroName;
@@ -695,6 +732,14 @@ void MacrosWindow::PopulateOrExchange(ShuttleGui & S)
       btn->SetAccessible(safenew WindowAccessible(btn));
 #endif
 
+      btn = S.Id(ApplyToProjectsID)
+         .Name(XO("Apply macro to all open projects"))
+         .AddButton(XXO("Open Pro&jects"));
+#if wxUSE_ACCESSIBILITY
+      // so that name can be set on a standard control
+      btn->SetAccessible(safenew WindowAccessible(btn));
+#endif
+
       btn = S.Id(ApplyToFilesID)
          .Name(XO("Apply macro to files..."))
          .AddButton(XXO("&Files..."));
@@ -1317,6 +1362,13 @@ void MacrosWindow::OnApplyToFiles(wxCommandEvent & event)
    ApplyMacroDialog::OnApplyToFiles( event );
 }
 
+void MacrosWindow::OnApplyToProjects(wxCommandEvent & event)
+{
+   if( !SaveChanges() )
+      return;
+   ApplyMacroDialog::OnApplyToProjects( event );
+}
+
 bool MacrosWindow::SaveChanges(){
    gPrefs->Write(wxT("/Batch/ActiveMacro"), mActiveMacro);
    gPrefs->Flush();
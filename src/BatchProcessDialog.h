@@ -38,6 +38,7 @@ class ApplyMacroDialog : public wxDialogWrapper {
    void PopulateOrExchange( ShuttleGui & S );
    virtual void OnApplyToProject(wxCommandEvent & event);
    virtual void OnApplyToFiles(wxCommandEvent & event);
+   virtual void OnApplyToProjects(wxCommandEvent & event);
    virtual void OnCancel(wxCommandEvent & event);
    virtual void OnHelp(wxCommandEvent & event);
 
@@ -83,6 +84,7 @@ private:
    void PopulateOrExchange(ShuttleGui &S);
    void OnApplyToProject(wxCommandEvent & event) override;
    void OnApplyToFiles(wxCommandEvent & event) override;
+   void OnApplyToProjects(wxCommandEvent & event) override;
    void OnCancel(wxCommandEvent &event) override;
 
    virtual ManualPageID GetHelpPageName() override {return 
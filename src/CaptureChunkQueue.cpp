@@ -0,0 +1,116 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file CaptureChunkQueue.cpp
+
+**********************************************************************/
+
+#include "CaptureChunkQueue.h"
+
+#include <algorithm>
+
+CaptureChunkQueue::CaptureChunkQueue(
+   unsigned numChannels, size_t chunkSamples, size_t maxChunks)
+   : mChunkSamples{ std::max<size_t>(1, chunkSamples) }
+   , mMaxChunksPerChannel{
+      std::max<size_t>(2, maxChunks / std::max(1u, numChannels)) }
+   , mStaged(numChannels)
+   , mQueued(numChannels)
+{
+   for (auto &staged : mStaged)
+      staged.reserve(mChunkSamples);
+}
+
+bool CaptureChunkQueue::Append(unsigned channel,
+   constSamplePtr buffer, sampleFormat format, size_t len)
+{
+   auto &staged = mStaged[channel];
+   while (len > 0 && !Overflowed()) {
+      const auto size = staged.size();
+      const auto count = std::min(len, mChunkSamples - size);
+      // Within the reserved capacity, so this doesn't allocate
+      staged.resize(size + count);
+      SamplesToFloats(buffer, format, staged.data() + size, count);
+      buffer += count * SAMPLE_SIZE(format);
+      len -= count;
+      if (staged.size() == mChunkSamples)
+         Stage(channel);
+   }
+   return !Overflowed();
+}
+
+bool CaptureChunkQueue::AppendSilence(unsigned channel, size_t len)
+{
+   auto &staged = mStaged[channel];
+   while (len > 0 && !Overflowed()) {
+      const auto count = std::min(len, mChunkSamples - staged.size());
+      staged.resize(staged.size() + count, 0.0f);
+      len -= count;
+      if (staged.size() == mChunkSamples)
+         Stage(channel);
+   }
+   return !Overflowed();
+}
+
+void CaptureChunkQueue::Stage(unsigned channel)
+{
+   auto &staged = mStaged[channel];
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      if (mOverflowed)
+         return;
+      if (mQueued[channel] >= mMaxChunksPerChannel) {
+         // The consumer can't keep up; don't let memory grow without bound
+         mOverflowed = true;
+         staged.clear();
+         return;
+      }
+      ++mQueued[channel];
+      mChunks.push_back({ channel, std::move(staged) });
+      if (!mFree.empty()) {
+         staged = std::move(mFree.back());
+         mFree.pop_back();
+      }
+      else
+         staged = {};
+   }
+   mCondition.notify_one();
+   staged.reserve(mChunkSamples);
+}
+
+void CaptureChunkQueue::Finish()
+{
+   for (unsigned channel = 0; channel < mStaged.size(); ++channel)
+      if (!mStaged[channel].empty())
+         Stage(channel);
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mFinished = true;
+   }
+   mCondition.notify_one();
+}
+
+bool CaptureChunkQueue::Pop(Chunk &chunk)
+{
+   std::unique_lock<std::mutex> lock{ mMutex };
+   mCondition.wait(lock, [this]{ return mFinished || !mChunks.empty(); });
+   if (mChunks.empty())
+      return false;
+   chunk = std::move(mChunks.front());
+   mChunks.pop_front();
+   --mQueued[chunk.channel];
+   return true;
+}
+
+void CaptureChunkQueue::Recycle(std::vector<float> samples)
+{
+   samples.clear();
+   std::lock_guard<std::mutex> lock{ mMutex };
+   mFree.push_back(std::move(samples));
+}
+
+bool CaptureChunkQueue::Overflowed() const
+{
+   return mOverflowed;
+}
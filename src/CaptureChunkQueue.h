@@ -0,0 +1,96 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file CaptureChunkQueue.h
+  @brief Chunks of recorded samples, handed from the recording thread to a
+  thread that writes them, in bounded memory
+
+**********************************************************************/
+
+#ifndef __TENACITY_CAPTURE_CHUNK_QUEUE__
+#define __TENACITY_CAPTURE_CHUNK_QUEUE__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// Tenacity libraries
+#include <lib-math/SampleFormat.h>
+
+//! Stages the samples of each channel of a recording in float chunks of a
+//! fixed size, and queues the full chunks for one consumer
+/*!
+ Memory is bounded by the number of chunks that each channel may have
+ queued.  The channels share a budget of chunks, but each may queue at
+ least two, so that a recording of many channels, which fills one chunk of
+ every channel at about the same time, doesn't exhaust the budget at once.
+
+ When a channel would exceed its bound, the queue overflows: the chunk is
+ dropped, and so is everything appended after it.
+ */
+class CaptureChunkQueue
+{
+public:
+   struct Chunk
+   {
+      unsigned channel{ 0 };
+      std::vector<float> samples;
+   };
+
+   //! @param maxChunks the chunks that may be queued, of all channels
+   CaptureChunkQueue(
+      unsigned numChannels, size_t chunkSamples, size_t maxChunks);
+
+   CaptureChunkQueue(const CaptureChunkQueue&) = delete;
+   CaptureChunkQueue &operator=(const CaptureChunkQueue&) = delete;
+
+   size_t MaxChunksPerChannel() const { return mMaxChunksPerChannel; }
+
+   // Producer thread
+
+   //! @return false if the queue has overflowed
+   bool Append(unsigned channel,
+      constSamplePtr buffer, sampleFormat format, size_t len);
+   //! @return false if the queue has overflowed
+   bool AppendSilence(unsigned channel, size_t len);
+   //! Queue the partly filled chunks, after which Pop() returns false when
+   //! the queue is empty
+   void Finish();
+
+   // Consumer thread
+
+   //! Wait for a chunk
+   /*! @return false, leaving chunk unchanged, once Finish() was called and
+    the queue is empty */
+   bool Pop(Chunk &chunk);
+   //! Give back the samples of a popped chunk, to be reused
+   void Recycle(std::vector<float> samples);
+
+   // Any thread
+
+   bool Overflowed() const;
+
+private:
+   void Stage(unsigned channel);
+
+   const size_t mChunkSamples;
+   const size_t mMaxChunksPerChannel;
+
+   //! Samples not yet queued, for each channel; only for the producer
+   std::vector<std::vector<float>> mStaged;
+
+   std::mutex mMutex;
+   std::condition_variable mCondition;
+   std::deque<Chunk> mChunks;
+   //! Chunks in mChunks, for each channel
+   std::vector<size_t> mQueued;
+   //! Emptied chunks, reused to avoid allocation
+   std::vector<std::vector<float>> mFree;
+   bool mFinished{ false };
+   std::atomic<bool> mOverflowed{ false };
+};
+
+#endif
@@ -0,0 +1,265 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file CaptureJournal.cpp
+
+**********************************************************************/
+
+#include "CaptureJournal.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+
+#include <wx/crt.h>
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+#include <wx/utils.h>
+
+// Tenacity libraries
+#include <lib-files/TempDirectory.h>
+#include <lib-utility/MemoryX.h>
+
+#include "CaptureChunkQueue.h"
+#include "WaveTrack.h"
+
+BoolSetting CaptureJournalEnabled{ L"/AudioIO/CaptureJournal", true };
+
+namespace {
+
+//! Data begins after one page, so that chunks stay aligned
+constexpr size_t HeaderSize = 4096;
+//! Samples per chunk: 1 MiB of floats
+constexpr size_t ChunkSamples = 1 << 18;
+//! Chunks waiting to be written before the journal gives up, shared by
+//! the channels; each channel may have at least two waiting
+constexpr size_t MaxQueuedChunks = 64;
+
+constexpr char Magic[8] = { 'T', 'N', 'C', 'Y', 'C', 'A', 'P', '1' };
+
+//! Native byte order; the journal is only read back on the same machine
+struct Header
+{
+   char magic[8];
+   std::uint32_t channel;
+   std::uint32_t numChannels;
+   double rate;
+   double t0;
+   //! Seconds since the epoch when recording started
+   std::int64_t started;
+};
+
+wxString JournalDir()
+{
+   return wxFileName{ TempDirectory::TempDir(), wxT("CaptureJournal") }
+      .GetFullPath();
+}
+
+const wxString Extension{ wxT("tcj") };
+
+bool ReadHeader(const FilePath &path, Header &header)
+{
+   auto file = wxFopen(path, wxT("rb"));
+   if (!file)
+      return false;
+   auto cleanup = finally([&]{ fclose(file); });
+   return fread(&header, sizeof(header), 1, file) == 1 &&
+      memcmp(header.magic, Magic, sizeof(Magic)) == 0;
+}
+
+}
+
+CaptureJournal::CaptureJournal(unsigned numChannels, double rate, double t0)
+{
+   const auto dir = JournalDir();
+   if (!wxFileName::Mkdir(dir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL))
+      return;
+
+   const auto now = wxDateTime::Now();
+   // The name groups the channels of one recording
+   const auto name = now.Format(wxT("%Y%m%d-%H%M%S-")) +
+      wxString::Format(wxT("%lu"), wxGetProcessId());
+
+   Header header{};
+   memcpy(header.magic, Magic, sizeof(Magic));
+   header.numChannels = numChannels;
+   header.rate = rate;
+   header.t0 = t0;
+   header.started = now.GetTicks();
+   char page[HeaderSize]{};
+
+   for (unsigned channel = 0; channel < numChannels; ++channel) {
+      const auto path = wxFileName{ dir,
+         wxString::Format(wxT("%s-%u"), name, channel), Extension }
+            .GetFullPath();
+      auto file = wxFopen(path, wxT("wb"));
+      if (!file) {
+         mFailed = true;
+         break;
+      }
+      mFiles.push_back(file);
+      mPaths.push_back(path);
+      // Chunks are written whole; don't copy them through a buffer
+      setvbuf(file, nullptr, _IONBF, 0);
+
+      header.channel = channel;
+      memcpy(page, &header, sizeof(header));
+      if (fwrite(page, sizeof(page), 1, file) != 1) {
+         mFailed = true;
+         break;
+      }
+   }
+
+   if (mFailed) {
+      wxLogMessage(wxT("Could not create the capture journal in %s"), dir);
+      Discard();
+      return;
+   }
+
+   mQueue = std::make_unique<CaptureChunkQueue>(
+      numChannels, ChunkSamples, MaxQueuedChunks);
+   mWriter = std::thread{ [this]{ Write(); } };
+}
+
+CaptureJournal::~CaptureJournal()
+{
+   Finish();
+}
+
+bool CaptureJournal::IsGood() const
+{
+   return !mFailed && !mFiles.empty() && mQueue && !mQueue->Overflowed();
+}
+
+void CaptureJournal::Append(unsigned channel,
+   constSamplePtr buffer, sampleFormat format, size_t len)
+{
+   if (IsGood())
+      mQueue->Append(channel, buffer, format, len);
+}
+
+void CaptureJournal::AppendSilence(unsigned channel, size_t len)
+{
+   if (IsGood())
+      mQueue->AppendSilence(channel, len);
+}
+
+void CaptureJournal::Write()
+{
+   CaptureChunkQueue::Chunk chunk;
+   while (mQueue->Pop(chunk)) {
+      const auto file = mFiles[chunk.channel];
+      const auto size = chunk.samples.size();
+      // Flush to the system, so that the samples survive a crash of the
+      // program
+      const bool good =
+         fwrite(chunk.samples.data(), sizeof(float), size, file) == size &&
+         fflush(file) == 0;
+      if (!good)
+         mFailed = true;
+      mQueue->Recycle(std::move(chunk.samples));
+   }
+}
+
+void CaptureJournal::Finish()
+{
+   if (mWriter.joinable()) {
+      mQueue->Finish();
+      mWriter.join();
+   }
+   for (auto file : mFiles)
+      fclose(file);
+   mFiles.clear();
+}
+
+void CaptureJournal::Discard()
+{
+   Finish();
+   for (const auto &path : mPaths)
+      wxRemoveFile(path);
+   mPaths.clear();
+}
+
+auto CaptureJournal::FindLeftovers() -> std::vector<Leftover>
+{
+   std::vector<Leftover> result;
+   const auto dir = JournalDir();
+   if (!wxDirExists(dir))
+      return result;
+
+   FilePaths files;
+   wxDir::GetAllFiles(dir, &files, wxT("*.") + Extension, wxDIR_FILES);
+
+   // Group the channels by the name of the recording
+   std::map<wxString, std::map<unsigned, FilePath>> recordings;
+   std::map<wxString, Header> headers;
+   for (const auto &path : files) {
+      Header header;
+      if (!ReadHeader(path, header))
+         continue;
+      const auto name = wxFileName{ path }.GetName().BeforeLast(wxT('-'));
+      recordings[name][header.channel] = path;
+      headers[name] = header;
+   }
+
+   for (const auto &[name, channels] : recordings) {
+      const auto &header = headers[name];
+      Leftover leftover;
+      for (const auto &pair : channels)
+         leftover.files.push_back(pair.second);
+      leftover.rate = header.rate;
+      leftover.t0 = header.t0;
+      leftover.started = wxDateTime{ static_cast<time_t>(header.started) };
+      result.push_back(std::move(leftover));
+   }
+   return result;
+}
+
+bool CaptureJournal::Recover(
+   TenacityProject &project, const Leftover &leftover)
+{
+   auto &factory = WaveTrackFactory::Get(project);
+   std::vector<std::shared_ptr<WaveTrack>> channels;
+   std::vector<float> buffer(ChunkSamples);
+   /* i18n-hint: The name of a track made from a recording that was
+      interrupted; %s is the date and time that the recording started */
+   const auto name = XO("Recovered %s")
+      .Format(leftover.started.Format()).Translation();
+
+   for (const auto &path : leftover.files) {
+      auto file = wxFopen(path, wxT("rb"));
+      if (!file)
+         return false;
+      auto cleanup = finally([&]{ fclose(file); });
+      if (fseek(file, HeaderSize, SEEK_SET) != 0)
+         return false;
+
+      auto track = factory.NewWaveTrack(floatSample, leftover.rate);
+      track->SetOffset(leftover.t0);
+      track->SetName(name);
+      size_t count;
+      while ((count = fread(buffer.data(), sizeof(float), buffer.size(), file)))
+         track->Append(reinterpret_cast<constSamplePtr>(buffer.data()),
+            floatSample, count);
+      track->Flush();
+      channels.push_back(track);
+   }
+   if (channels.empty())
+      return false;
+
+   auto &tracks = TrackList::Get(project);
+   for (const auto &track : channels)
+      tracks.Add(track);
+   tracks.MakeMultiChannelTrack(*channels.front(), channels.size(), true);
+   return true;
+}
+
+void CaptureJournal::Remove(const Leftover &leftover)
+{
+   for (const auto &path : leftover.files)
+      wxRemoveFile(path);
+}
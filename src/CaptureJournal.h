@@ -0,0 +1,100 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file CaptureJournal.h
+  @brief Append-only files of raw recorded samples, for crash recovery
+
+**********************************************************************/
+
+#ifndef __TENACITY_CAPTURE_JOURNAL__
+#define __TENACITY_CAPTURE_JOURNAL__
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <wx/datetime.h>
+
+// Tenacity libraries
+#include <lib-files/FileNames.h>
+#include <lib-math/SampleFormat.h>
+#include <lib-preferences/Prefs.h>
+
+class CaptureChunkQueue;
+class TenacityProject;
+
+//! Whether recordings are journaled
+extern TENACITY_DLL_API BoolSetting CaptureJournalEnabled;
+
+//! Keeps a lossless copy of a recording in a file per channel
+/*!
+ Samples are converted to float, staged in memory, and handed in large
+ chunks, through a CaptureChunkQueue, to a thread that appends them to the
+ files.  The files have a header
+ of one page, and chunks are multiples of pages, so that writes are large,
+ sequential and aligned.
+
+ The files are in a folder of the temporary directory.  They are meant to
+ be discarded when the recording is safely in the project; those left by a
+ crash can be made into tracks.
+ */
+class TENACITY_DLL_API CaptureJournal
+{
+public:
+   //! Begin a journal of numChannels channels, recorded from time t0
+   /*! Failure to create the files is not an error: the recording then just
+    isn't journaled */
+   CaptureJournal(unsigned numChannels, double rate, double t0);
+   //! Writes what remains, and keeps the files
+   ~CaptureJournal();
+
+   CaptureJournal(const CaptureJournal&) = delete;
+   CaptureJournal &operator=(const CaptureJournal&) = delete;
+
+   //! Whether all samples appended so far are, or will be, written
+   bool IsGood() const;
+
+   //! Append samples of one channel.  Called by one thread only
+   void Append(unsigned channel,
+      constSamplePtr buffer, sampleFormat format, size_t len);
+   //! Append silence to one channel.  Called by one thread only
+   void AppendSilence(unsigned channel, size_t len);
+
+   //! Write what remains, and delete the files
+   void Discard();
+
+   //! A journal left behind, with one file for each channel
+   struct Leftover
+   {
+      FilePaths files;
+      double rate;
+      double t0;
+      //! Wall clock time when the recording started
+      wxDateTime started;
+   };
+
+   //! Find the journals that were not discarded
+   static std::vector<Leftover> FindLeftovers();
+
+   //! Add a new track made from the journal to the project
+   static bool Recover(TenacityProject &project, const Leftover &leftover);
+
+   static void Remove(const Leftover &leftover);
+
+private:
+   void Finish();
+   void Write();
+
+   std::vector<FILE*> mFiles;
+   FilePaths mPaths;
+   std::unique_ptr<CaptureChunkQueue> mQueue;
+   //! Whether creating or writing the files failed
+   std::atomic<bool> mFailed{ false };
+
+   std::thread mWriter;
+};
+
+#endif
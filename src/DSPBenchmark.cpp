@@ -0,0 +1,493 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file DSPBenchmark.cpp
+
+ *********************************************************************/
+
+#include "DSPBenchmark.h"
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Tenacity libraries
+#include <lib-files/TempDirectory.h>
+#include <lib-math/SampleFormat.h>
+#include <lib-sample-track/Mix.h>
+#include <lib-sample-track/SampleTrackCache.h>
+#include <lib-screen-geometry/ViewInfo.h>
+#include <lib-utility/MemoryX.h>
+
+#include "PluginManager.h"
+#include "Project.h"
+#include "SampleBlock.h"
+#include "Tags.h"
+#include "WaveClip.h"
+#include "WaveTrack.h"
+#include "effects/Effect.h"
+#include "effects/EffectManager.h"
+#include "export/Export.h"
+#include "import/Import.h"
+#include "tracks/playabletrack/wavetrack/ui/SpectrumCache.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double Rate = 44100.0;
+constexpr double ResampledRate = 48000.0;
+constexpr double Seconds = 30.0;
+constexpr size_t Length = static_cast<size_t>(Rate * Seconds);
+constexpr size_t EffectBlockSize = 4096;
+constexpr size_t MixerBufferSize = 4096;
+constexpr size_t SampleBlockSize = 256 * 1024;
+constexpr size_t SpectrogramPixels = 4000;
+constexpr int SpectrogramRepeats = 4;
+
+struct Result
+{
+   wxString group;
+   wxString name;
+   wxString status;
+   double seconds;
+   double samples;
+};
+
+double Elapsed(Clock::time_point start)
+{
+   return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+wxString Quote(const wxString &str)
+{
+   wxString result{ wxT("\"") };
+   for (auto ch : str) {
+      const auto c = static_cast<wxChar>(ch);
+      switch (c) {
+      case wxT('"'):  result += wxT("\\\""); break;
+      case wxT('\\'): result += wxT("\\\\"); break;
+      case wxT('\n'): result += wxT("\\n"); break;
+      case wxT('\r'): result += wxT("\\r"); break;
+      case wxT('\t'): result += wxT("\\t"); break;
+      default:
+         if (c < 0x20)
+            result += wxString::Format(wxT("\\u%04x"), (unsigned) c);
+         else
+            result += c;
+      }
+   }
+   return result + wxT("\"");
+}
+
+wxString Number(double value)
+{
+   // JSON has no infinities or NaNs
+   if (!std::isfinite(value))
+      return wxT("null");
+   return wxString::FromCDouble(value, 6);
+}
+
+class Report
+{
+public:
+   void Add(const wxString &group, const wxString &name,
+      double seconds, double samples)
+   {
+      mResults.push_back({ group, name, wxT("ok"), seconds, samples });
+   }
+
+   void Skip(const wxString &group, const wxString &name)
+   {
+      mResults.push_back({ group, name, wxT("skipped"), 0, 0 });
+   }
+
+   void Fail(const wxString &group, const wxString &name)
+   {
+      mResults.push_back({ group, name, wxT("failed"), 0, 0 });
+      mFailed = true;
+   }
+
+   bool Failed() const { return mFailed; }
+
+   bool Write(const wxString &path) const
+   {
+      wxString json;
+      json << wxT("{\n")
+         << wxT("  \"version\": ") << Quote(TENACITY_VERSION_STRING)
+         << wxT(",\n  \"sampleRate\": ") << Number(Rate)
+         << wxT(",\n  \"channels\": 2")
+         << wxT(",\n  \"seconds\": ") << Number(Seconds)
+         << wxT(",\n  \"results\": [");
+
+      const char *separator = "\n";
+      for (const auto &result : mResults) {
+         // Realtime factor: seconds of audio handled per second of wall clock
+         const auto speed = result.seconds > 0
+            ? result.samples / Rate / result.seconds : 0.0;
+         json << separator
+            << wxT("    { \"group\": ") << Quote(result.group)
+            << wxT(", \"name\": ") << Quote(result.name)
+            << wxT(", \"status\": ") << Quote(result.status)
+            << wxT(", \"seconds\": ") << Number(result.seconds)
+            << wxT(", \"samples\": ") << Number(result.samples)
+            << wxT(", \"realtime\": ") << Number(speed)
+            << wxT(" }");
+         separator = ",\n";
+      }
+      json << wxT("\n  ]\n}\n");
+
+      wxFFile file;
+      if (!file.Open(path, wxT("wb")))
+         return false;
+      return file.Write(json, wxConvUTF8) && file.Close();
+   }
+
+private:
+   std::vector<Result> mResults;
+   bool mFailed{ false };
+};
+
+//! Two channels of tones with a little noise, the same on every run
+std::vector<Floats> MakeSignal()
+{
+   std::vector<Floats> signal;
+   std::minstd_rand engine{ 1 };
+   std::uniform_real_distribution<float> noise{ -0.05f, 0.05f };
+   const double frequencies[] = { 440.0, 660.0 };
+   for (auto frequency : frequencies) {
+      Floats channel{ Length };
+      const auto step = 2 * M_PI * frequency / Rate;
+      for (size_t i = 0; i < Length; ++i)
+         channel[i] = 0.5f * std::sin(step * i) + noise(engine);
+      signal.push_back(std::move(channel));
+   }
+   return signal;
+}
+
+void BenchmarkEffects(Report &report, const std::vector<Floats> &signal)
+{
+   const wxString group{ wxT("effect") };
+   auto &em = EffectManager::Get();
+   for (auto &plug : PluginManager::Get().PluginsOfType(PluginTypeEffect)) {
+      if (!plug.GetPath().StartsWith(BUILTIN_EFFECT_PREFIX))
+         continue;
+
+      const auto name = plug.GetSymbol().Internal();
+      auto effect = dynamic_cast<Effect *>(em.GetEffect(plug.GetID()));
+      if (!effect) {
+         report.Fail(group, name);
+         continue;
+      }
+
+      const auto nIn = effect->GetAudioInCount();
+      const auto nOut = effect->GetAudioOutCount();
+      if (nIn > signal.size()) {
+         report.Skip(group, name);
+         continue;
+      }
+
+      try {
+         effect->LoadFactoryDefaults();
+         effect->SetSampleRate(Rate);
+         const auto blockSize = effect->SetBlockSize(EffectBlockSize);
+
+         std::vector<Floats> outBuffers;
+         std::vector<float *> outPointers;
+         for (unsigned ii = 0; ii < std::max(nOut, 1u); ++ii) {
+            outBuffers.emplace_back(blockSize);
+            outPointers.push_back(outBuffers.back().get());
+         }
+         std::vector<const float *> inPointers(std::max(nIn, 1u));
+
+         if (!effect->ProcessInitialize(Length)) {
+            report.Fail(group, name);
+            continue;
+         }
+
+         size_t processed = 0;
+         const auto start = Clock::now();
+         for (size_t pos = 0; pos < Length; pos += blockSize) {
+            const auto len = std::min(blockSize, Length - pos);
+            for (unsigned ii = 0; ii < nIn; ++ii)
+               inPointers[ii] = signal[ii].get() + pos;
+            const auto got = effect->ProcessBlock(
+               inPointers.data(), outPointers.data(), len);
+            // The default ProcessBlock does nothing; such effects override
+            // Process() instead
+            if (got == 0)
+               break;
+            processed += got;
+         }
+         const auto seconds = Elapsed(start);
+         effect->ProcessFinalize();
+
+         if (processed == 0)
+            report.Skip(group, name);
+         else
+            report.Add(group, name, seconds, processed);
+      }
+      catch (...) {
+         report.Fail(group, name);
+      }
+   }
+}
+
+void BenchmarkMixer(Report &report,
+   const WaveTrack &left, const WaveTrack &right)
+{
+   const SampleTrackConstArray tracks{
+      left.SharedPointer<const SampleTrack>(),
+      right.SharedPointer<const SampleTrack>()
+   };
+
+   struct Case { const wxChar *name; double rate; };
+   const Case cases[] = {
+      { wxT("same rate"), Rate },
+      { wxT("resampled"), ResampledRate },
+   };
+
+   for (const auto &aCase : cases) {
+      try {
+         Mixer mixer(tracks, true, Mixer::WarpOptions{ 1.0, 1.0 },
+            0.0, Seconds, 2, MixerBufferSize, true,
+            aCase.rate, floatSample);
+
+         size_t mixed = 0;
+         const auto start = Clock::now();
+         while (auto got = mixer.Process(MixerBufferSize))
+            mixed += got;
+         const auto seconds = Elapsed(start);
+
+         // Report in samples of the input rate, so realtime factors compare
+         report.Add(wxT("mix"), aCase.name, seconds,
+            mixed * Rate / aCase.rate);
+      }
+      catch (...) {
+         report.Fail(wxT("mix"), aCase.name);
+      }
+   }
+}
+
+void BenchmarkSampleBlocks(Report &report, TenacityProject &project,
+   const std::vector<Floats> &signal)
+{
+   const wxString group{ wxT("sample block") };
+   // The case that is running, to report if it throws
+   auto phase = wxT("write");
+   try {
+      auto factory = SampleBlockFactory::New(project);
+      std::vector<SampleBlockPtr> blocks;
+
+      auto start = Clock::now();
+      for (size_t pos = 0; pos < Length; pos += SampleBlockSize) {
+         const auto len = std::min(SampleBlockSize, Length - pos);
+         blocks.push_back(factory->Create(
+            reinterpret_cast<constSamplePtr>(signal[0].get() + pos),
+            len, floatSample));
+      }
+      report.Add(group, wxT("write"), Elapsed(start), Length);
+
+      phase = wxT("read");
+      Floats buffer{ SampleBlockSize };
+      size_t read = 0;
+      start = Clock::now();
+      for (const auto &block : blocks)
+         read += block->GetSamples(reinterpret_cast<samplePtr>(buffer.get()),
+            floatSample, 0, block->GetSampleCount());
+      report.Add(group, wxT("read"), Elapsed(start), read);
+   }
+   catch (...) {
+      report.Fail(group, phase);
+   }
+}
+
+void BenchmarkSpectrogram(Report &report, const WaveTrack &track)
+{
+   try {
+      SampleTrackCache cache{ track.SharedPointer<const SampleTrack>() };
+      const auto pps = SpectrogramPixels / Seconds;
+
+      double seconds = 0;
+      for (int ii = 0; ii < SpectrogramRepeats; ++ii) {
+         for (const auto &clip : track.GetClips()) {
+            auto &spectrumCache = WaveClipSpectrumCache::Get(*clip);
+            spectrumCache.Invalidate();
+
+            const float *spectrogram = nullptr;
+            const sampleCount *where = nullptr;
+            const auto start = Clock::now();
+            spectrumCache.GetSpectrogram(*clip, cache, spectrogram, where,
+               SpectrogramPixels, clip->GetPlayStartTime(), pps);
+            seconds += Elapsed(start);
+         }
+      }
+      report.Add(wxT("spectrogram"), wxT("compute"), seconds,
+         double(SpectrogramRepeats) * Length);
+   }
+   catch (...) {
+      report.Fail(wxT("spectrogram"), wxT("compute"));
+   }
+}
+
+//! Apply each Nyquist plug-in that processes audio, with its default
+//! settings, to copies of the benchmark tracks in a track list of their own
+void BenchmarkNyquist(Report &report, TenacityProject &project,
+   const WaveTrack &left, const WaveTrack &right)
+{
+   const wxString group{ wxT("nyquist") };
+   auto &em = EffectManager::Get();
+   auto &factory = WaveTrackFactory::Get(project);
+   for (auto &plug : PluginManager::Get().PluginsOfType(PluginTypeEffect)) {
+      if (plug.GetEffectFamily() != NYQUISTEFFECTS_FAMILY.Internal() ||
+          plug.GetEffectType() != EffectTypeProcess ||
+          plug.GetPath() == NYQUIST_PROMPT_ID)
+         continue;
+
+      const auto name = plug.GetSymbol().Internal();
+      auto effect = dynamic_cast<Effect *>(em.GetEffect(plug.GetID()));
+      if (!effect) {
+         report.Fail(group, name);
+         continue;
+      }
+
+      try {
+         auto tracks = TrackList::Create(&project);
+         auto pLeft = tracks->Add(left.Duplicate());
+         auto pRight = tracks->Add(right.Duplicate());
+         tracks->MakeMultiChannelTrack(*pLeft, 2, true);
+         pLeft->SetSelected(true);
+         pRight->SetSelected(true);
+
+         NotifyingSelectedRegion region;
+         region.setTimes(0.0, Seconds);
+         effect->LoadFactoryDefaults();
+
+         // No parent window, so there is no prompt
+         const auto start = Clock::now();
+         const auto success = effect->DoEffect(Rate, tracks.get(), &factory,
+            region, EffectManager::kConfigured, nullptr, nullptr);
+         const auto seconds = Elapsed(start);
+
+         if (success)
+            report.Add(group, name, seconds, Length);
+         else
+            report.Fail(group, name);
+      }
+      catch (...) {
+         report.Fail(group, name);
+      }
+   }
+}
+
+void BenchmarkFormats(Report &report, TenacityProject &project)
+{
+   Exporter exporter{ project };
+   const wxFileName base{ TempDirectory::TempDir(), wxT("tenacity-benchmark") };
+
+   for (const auto &pPlugin : exporter.GetPlugins()) {
+      for (int ii = 0; ii < pPlugin->GetFormatCount(); ++ii) {
+         const auto format = pPlugin->GetFormat(ii);
+         // The command line exporter runs whatever program the user set up
+         if (format == wxT("CL"))
+            continue;
+
+         wxFileName fileName{ base };
+         fileName.SetExt(pPlugin->GetExtension(ii));
+         const auto path = fileName.GetFullPath();
+         const auto channels = std::min(2u, pPlugin->GetMaxChannels(ii));
+
+         auto start = Clock::now();
+         bool success = false;
+         try {
+            success = exporter.Process(
+               channels, format, path, true, 0.0, Seconds);
+         }
+         catch (...) {
+         }
+         if (!success) {
+            report.Fail(wxT("export"), format);
+            ::wxRemoveFile(path);
+            continue;
+         }
+         report.Add(wxT("export"), format, Elapsed(start), Length);
+
+         TrackHolders newTracks;
+         LabelHolders labelTracks;
+         TranslatableString errorMessage;
+         auto newTags = Tags::Get(project).Duplicate();
+         start = Clock::now();
+         try {
+            success = Importer::Get().Import(project, path,
+               &WaveTrackFactory::Get(project), newTracks, newTags.get(),
+               labelTracks, errorMessage);
+         }
+         catch (...) {
+            success = false;
+         }
+         if (success && !newTracks.empty())
+            report.Add(wxT("import"), format, Elapsed(start), Length);
+         else
+            report.Fail(wxT("import"), format);
+
+         ::wxRemoveFile(path);
+      }
+   }
+}
+
+}
+
+bool RunDSPBenchmark( TenacityProject &project, const wxString &path )
+{
+   Report report;
+   const auto signal = MakeSignal();
+
+   BenchmarkEffects(report, signal);
+
+   auto &tracks = TrackList::Get(project);
+   auto &factory = WaveTrackFactory::Get(project);
+   auto left = tracks.Add(factory.NewWaveTrack(floatSample, Rate));
+   auto right = tracks.Add(factory.NewWaveTrack(floatSample, Rate));
+   tracks.MakeMultiChannelTrack(*left, 2, true);
+
+   auto cleanup = finally([&]{
+      tracks.Remove(right);
+      tracks.Remove(left);
+   });
+
+   try {
+      left->Append(reinterpret_cast<constSamplePtr>(signal[0].get()),
+         floatSample, Length);
+      left->Flush();
+      right->Append(reinterpret_cast<constSamplePtr>(signal[1].get()),
+         floatSample, Length);
+      right->Flush();
+   }
+   catch (...) {
+      wxLogError(wxT("Could not make the benchmark tracks"));
+      return false;
+   }
+
+   for (auto track : tracks.Any())
+      track->SetSelected(track == left || track == right);
+
+   BenchmarkMixer(report, *left, *right);
+   BenchmarkSampleBlocks(report, project, signal);
+   BenchmarkSpectrogram(report, *left);
+   BenchmarkNyquist(report, project, *left, *right);
+   BenchmarkFormats(report, project);
+
+   if (!report.Write(path)) {
+      wxLogError(wxT("Could not write the benchmark results to %s"), path);
+      return false;
+   }
+   return !report.Failed();
+}
@@ -0,0 +1,34 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file DSPBenchmark.h
+
+ Timing of the signal processing paths, without any user interface
+
+ *********************************************************************/
+
+#ifndef __TENACITY_DSP_BENCHMARK__
+#define __TENACITY_DSP_BENCHMARK__
+
+class TenacityProject;
+class wxString;
+
+//! Time effects, mixing, sample block storage, Nyquist plug-ins, export,
+//! import and spectrograms
+/*!
+ Works on synthetic stereo tracks that are added to the project and removed
+ again afterwards.  Every case is reported with its wall clock time and the
+ number of samples it handled; cases that can't run are reported as skipped
+ or failed rather than stopping the run.
+
+ Started by the --dsp-benchmark command line option, usually together with
+ --headless.
+
+ @param path where to write the results, as JSON
+ @return whether the results file was written and no case failed
+ */
+TENACITY_DLL_API
+bool RunDSPBenchmark( TenacityProject &project, const wxString &path );
+
+#endif
@@ -0,0 +1,139 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file HeadlessMode.cpp
+
+ *********************************************************************/
+
+// Tenacity libraries
+#include <lib-basic-ui/BasicUI.h>
+#include <lib-strings/Internat.h>
+
+#include "HeadlessMode.h"
+
+#include <wx/app.h>
+#include <wx/log.h>
+
+namespace {
+
+bool sHeadless = false;
+
+//! Progress indicator that shows nothing and never cancels
+struct HeadlessProgress final
+   : BasicUI::ProgressDialog, BasicUI::GenericProgressDialog
+{
+   ~HeadlessProgress() override = default;
+
+   BasicUI::ProgressResult Poll(
+      unsigned long long, unsigned long long,
+      const TranslatableString &message) override
+   {
+      if (!message.empty())
+         SetMessage(message);
+      return BasicUI::ProgressResult::Success;
+   }
+
+   void SetMessage(const TranslatableString &message) override
+   {
+      wxLogMessage(wxT("%s"), message.Translation());
+   }
+
+   void Pulse() override {}
+};
+
+//! Implementation of BasicUI::Services that logs instead of showing windows
+class HeadlessBasicUI final : public BasicUI::Services {
+public:
+   ~HeadlessBasicUI() override = default;
+
+protected:
+   void DoCallAfter(const BasicUI::Action &action) override
+   {
+      wxTheApp->CallAfter(action);
+   }
+
+   void DoYield() override
+   {
+      wxTheApp->Yield();
+   }
+
+   void DoShowErrorDialog(const BasicUI::WindowPlacement &,
+      const TranslatableString &dlogTitle,
+      const TranslatableString &message,
+      const ManualPageID &,
+      const BasicUI::ErrorDialogOptions &options) override
+   {
+      wxLogError(wxT("%s: %s"),
+         dlogTitle.Translation(), message.Translation());
+      if (!options.log.empty())
+         wxLogError(wxT("%s"), options.log);
+   }
+
+   BasicUI::MessageBoxResult DoMessageBox(
+      const TranslatableString &message,
+      BasicUI::MessageBoxOptions options) override
+   {
+      wxLogMessage(wxT("%s: %s"),
+         options.caption.Translation(), message.Translation());
+      // Nobody can answer; take the default
+      using namespace BasicUI;
+      if (options.buttonStyle == Button::YesNo)
+         return options.yesOrOkDefaultButton
+            ? MessageBoxResult::Yes : MessageBoxResult::No;
+      return MessageBoxResult::Ok;
+   }
+
+   std::unique_ptr<BasicUI::ProgressDialog>
+   DoMakeProgress(const TranslatableString &,
+      const TranslatableString &,
+      unsigned,
+      const TranslatableString &) override
+   {
+      return std::make_unique<HeadlessProgress>();
+   }
+
+   std::unique_ptr<BasicUI::GenericProgressDialog>
+   DoMakeGenericProgress(const BasicUI::WindowPlacement &,
+      const TranslatableString &,
+      const TranslatableString &) override
+   {
+      return std::make_unique<HeadlessProgress>();
+   }
+
+   int DoMultiDialog(const TranslatableString &message,
+      const TranslatableString &title,
+      const TranslatableStrings &,
+      const ManualPageID &,
+      const TranslatableString &, bool) override
+   {
+      wxLogMessage(wxT("%s: %s"),
+         title.Translation(), message.Translation());
+      // The first button
+      return 0;
+   }
+};
+
+}
+
+namespace HeadlessMode {
+
+bool IsEnabled()
+{
+   return sHeadless;
+}
+
+void Enable()
+{
+   sHeadless = true;
+
+   static HeadlessBasicUI uiServices;
+   (void)BasicUI::Install(&uiServices);
+}
+
+TranslatableString Unsupported( const TranslatableString &command )
+{
+   return XO("%s is not supported in headless mode.").Format( command );
+}
+
+}
@@ -0,0 +1,47 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file HeadlessMode.h
+
+ Running as an automation server without project windows
+
+ *********************************************************************/
+
+#ifndef __TENACITY_HEADLESS_MODE__
+#define __TENACITY_HEADLESS_MODE__
+
+class TranslatableString;
+
+//! State of the --headless command line switch
+/*!
+ In headless mode the application makes no splash screen, theme, menus,
+ toolbars or project windows.  Projects exist only as their model objects,
+ and are driven by scripting commands (mod-script-pipe) that work on the
+ model layer.  Commands that need a window fail, reporting
+ Unsupported(): menu commands, Drag, GetInfo of menus, preferences or boxes,
+ SetProject of the window, Open Project without a file name or into a
+ project that is not empty, Save Project without a file name, and Save Copy.
+
+ wxWidgets must still be initialized, so a display is still needed where
+ the toolkit needs one to start:  with GTK, an X11 or Wayland display, so
+ that a server without one must run under a virtual display such as Xvfb.
+ Nothing is ever shown or repainted on it.
+ */
+namespace HeadlessMode {
+
+//! Whether the application was started with --headless
+TENACITY_DLL_API bool IsEnabled();
+
+//! Turn on headless mode; call once at startup, before any project exists
+/*! Also installs BasicUI services that write messages to the log instead of
+ showing dialogs, and that never let progress indicators cancel */
+TENACITY_DLL_API void Enable();
+
+//! Message for a command that can't run without a project window
+TENACITY_DLL_API TranslatableString Unsupported(
+   const TranslatableString &command );
+
+}
+
+#endif
@@ -17,6 +17,7 @@
 #include "JournalEvents.h"
 #include "JournalOutput.h"
 #include "JournalRegistry.h"
+#include "JournalTiming.h"
 
 #include <algorithm>
 #include <wx/app.h>
@@ -223,9 +224,16 @@ bool Dispatch()
       throw SyncException{};
 
    // Pass all the fields including the command name to the function
-   if ( !iter->second( words ) )
+   Timing::BeginStep( sLineNumber, words );
+   bool handled;
+   {
+      Timing::Scope scope{ Timing::Category::Dispatch };
+      handled = iter->second( words );
+   }
+   if ( !handled )
       throw SyncException{};
 
+   Timing::Repaint();
    return true;
 }
 
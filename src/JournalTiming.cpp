@@ -0,0 +1,200 @@
+/*!********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file JournalTiming.cpp
+
+**********************************************************************/
+
+#include "JournalTiming.h"
+#include "Journal.h"
+#include "JournalOutput.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include <wx/ffile.h>
+#include <wx/toplevel.h>
+
+// Tenacity libraries
+#include <lib-strings/wxArrayStringEx.h>
+
+namespace Journal {
+
+namespace Timing {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t nCategories = 3;
+
+struct Step {
+   int lineNumber;
+   wxString command;
+   Clock::time_point start;
+   double seconds = 0;
+   double categories[ nCategories ]{};
+};
+
+struct Frame {
+   Category category;
+   Clock::time_point start;
+};
+
+wxString sReportFileName;
+std::vector< Step > sSteps;
+// Scopes in progress; only the innermost one is accumulating time
+std::vector< Frame > sFrames;
+
+double Seconds( Clock::time_point start, Clock::time_point end )
+{
+   return std::chrono::duration< double >( end - start ).count();
+}
+
+// Credit the innermost scope with the time since it last started accumulating
+void Credit( Clock::time_point now )
+{
+   if ( sFrames.empty() )
+      return;
+   auto &frame = sFrames.back();
+   if ( !sSteps.empty() )
+      sSteps.back().categories[ static_cast< size_t >( frame.category ) ] +=
+         Seconds( frame.start, now );
+   frame.start = now;
+}
+
+void EndStep( Clock::time_point now )
+{
+   Credit( now );
+   if ( !sSteps.empty() )
+      sSteps.back().seconds = Seconds( sSteps.back().start, now );
+}
+
+wxString Quote( const wxString &str )
+{
+   wxString result{ wxT("\"") };
+   for ( auto ch : str ) {
+      const auto c = static_cast< wxChar >( ch );
+      switch ( c ) {
+      case wxT('"'):  result += wxT("\\\""); break;
+      case wxT('\\'): result += wxT("\\\\"); break;
+      default:
+         if ( c < 0x20 )
+            result += wxString::Format( wxT("\\u%04x"), (unsigned) c );
+         else
+            result += c;
+      }
+   }
+   return result + wxT("\"");
+}
+
+wxString Number( double value )
+{
+   return std::isfinite( value )
+      ? wxString::FromCDouble( value, 6 ) : wxString{ wxT("null") };
+}
+
+wxString Times( double seconds, const double ( &categories )[ nCategories ] )
+{
+   wxString result;
+   result << wxT("\"seconds\": ") << Number( seconds )
+      << wxT(", \"dispatch\": ")
+      << Number( categories[ static_cast< size_t >( Category::Dispatch ) ] )
+      << wxT(", \"paint\": ")
+      << Number( categories[ static_cast< size_t >( Category::Paint ) ] )
+      << wxT(", \"idle\": ")
+      << Number( categories[ static_cast< size_t >( Category::Idle ) ] );
+   return result;
+}
+
+}
+
+void SetReportFileName( const wxString &path )
+{
+   sReportFileName = path;
+}
+
+bool IsEnabled()
+{
+   return !sReportFileName.empty() && IsReplaying();
+}
+
+void BeginStep( int lineNumber, const wxArrayStringEx &tokens )
+{
+   if ( !IsEnabled() )
+      return;
+   const auto now = Clock::now();
+   EndStep( now );
+   sSteps.push_back( { lineNumber,
+      ::wxJoin( tokens, SeparatorCharacter, EscapeCharacter ), now } );
+}
+
+void Repaint()
+{
+   if ( !IsEnabled() )
+      return;
+   // Paint events are timed as they are handled
+   for ( auto pWindow : wxTopLevelWindows )
+      pWindow->Update();
+}
+
+Scope::Scope( Category category )
+   : mActive{ IsEnabled() }
+{
+   if ( mActive ) {
+      const auto now = Clock::now();
+      Credit( now );
+      sFrames.push_back( { category, now } );
+   }
+}
+
+Scope::~Scope()
+{
+   if ( mActive ) {
+      const auto now = Clock::now();
+      Credit( now );
+      sFrames.pop_back();
+      // The enclosing scope resumes accumulating
+      if ( !sFrames.empty() )
+         sFrames.back().start = now;
+   }
+}
+
+bool WriteReport()
+{
+   if ( sReportFileName.empty() || sSteps.empty() )
+      return true;
+   EndStep( Clock::now() );
+
+   double seconds = 0;
+   double categories[ nCategories ]{};
+   wxString json;
+   json << wxT("{\n  \"steps\": [");
+   const char *separator = "\n";
+   for ( const auto &step : sSteps ) {
+      seconds += step.seconds;
+      for ( size_t ii = 0; ii < nCategories; ++ii )
+         categories[ ii ] += step.categories[ ii ];
+      json << separator
+         << wxT("    { \"line\": ") << step.lineNumber
+         << wxT(", \"command\": ") << Quote( step.command )
+         << wxT(", ") << Times( step.seconds, step.categories )
+         << wxT(" }");
+      separator = ",\n";
+   }
+   json << wxT("\n  ],\n  \"total\": { ")
+      << Times( seconds, categories )
+      << wxT(" }\n}\n");
+   sSteps.clear();
+
+   wxFFile file;
+   if ( !file.Open( sReportFileName, wxT("wb") ) )
+      return false;
+   return file.Write( json, wxConvUTF8 ) && file.Close();
+}
+
+}
+
+}
@@ -0,0 +1,60 @@
+/*!********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file JournalTiming.h
+  @brief Measures the replay of a journal, step by step
+
+**********************************************************************/
+
+#ifndef __TENACITY_JOURNAL_TIMING__
+#define __TENACITY_JOURNAL_TIMING__
+
+class wxArrayStringEx;
+class wxString;
+
+namespace Journal
+{
+namespace Timing
+{
+   //\brief Set the file for the timing report at start up
+   // Replay then repaints windows after each step, so that painting is
+   // counted in the step that caused it
+   void SetReportFileName( const wxString &path );
+
+   //\brief Whether replaying, and a report file was set
+   bool IsEnabled();
+
+   //\brief Kinds of work that are measured separately within each step
+   enum class Category {
+      Dispatch, //!< Processing of the command or event in the journal
+      Paint,    //!< Handling of paint events
+      Idle,     //!< Handling of idle events, other than replay itself
+   };
+
+   //\brief Start the step for a line of the journal, ending the previous
+   // step.  Does nothing unless IsEnabled()
+   void BeginStep( int lineNumber, const wxArrayStringEx &tokens );
+
+   //\brief Update all windows now if IsEnabled(), timing it as painting
+   void Repaint();
+
+   //\brief Counts the time that it exists in a category, excluding the time
+   // of Scopes nested in it.  Does nothing unless IsEnabled()
+   class Scope {
+   public:
+      explicit Scope( Category category );
+      ~Scope();
+      Scope( const Scope& ) = delete;
+      Scope &operator=( const Scope& ) = delete;
+   private:
+      bool mActive;
+   };
+
+   //\brief End the last step and write the report, as JSON, if there is one
+   //\return whether successful
+   bool WriteReport();
+}
+}
+
+#endif
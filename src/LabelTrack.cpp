@@ -32,6 +32,7 @@ for drawing different aspects of the label and its text box.
 #include "LabelTrack.h"
 
 #include <algorithm>
+#include <iterator>
 #include <limits.h>
 #include <cfloat>
 
@@ -952,6 +953,41 @@ int LabelTrack::AddLabel(const SelectedRegion &selectedRegion,
    return pos;
 }
 
+void LabelTrack::AddLabels(LabelArray labels)
+{
+   // AddLabel inserts before labels that start at the same time, so repeated
+   // calls leave such labels in the opposite order to the calls; reversing
+   // before the stable sort gives the same order
+   std::reverse( labels.begin(), labels.end() );
+   std::stable_sort( labels.begin(), labels.end(),
+      []( const LabelStruct &label1, const LabelStruct &label2 )
+         { return label1.getT0() < label2.getT0(); } );
+
+   LabelArray merged;
+   merged.reserve( mLabels.size() + labels.size() );
+   std::vector< int > positions;
+   positions.reserve( labels.size() );
+   auto old = mLabels.begin(), oldEnd = mLabels.end();
+   for ( auto &label : labels ) {
+      // As in AddLabel, before any old label that starts at the same time
+      while ( old != oldEnd && old->getT0() < label.getT0() )
+         merged.push_back( std::move( *old++ ) );
+      positions.push_back( merged.size() );
+      merged.push_back( std::move( label ) );
+   }
+   merged.insert( merged.end(),
+      std::make_move_iterator( old ), std::make_move_iterator( oldEnd ) );
+   mLabels.swap( merged );
+
+   for ( auto pos : positions ) {
+      LabelTrackEvent evt{
+         EVT_LABELTRACK_ADDITION, SharedPointer<LabelTrack>(),
+         mLabels[ pos ].title, -1, pos
+      };
+      ProcessEvent( evt );
+   }
+}
+
 void LabelTrack::DeleteLabel(int index)
 {
    wxASSERT((index < (int)mLabels.size()));
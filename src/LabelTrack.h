@@ -137,6 +137,12 @@ public:
    //This returns the index of the label we just added.
    int AddLabel(const SelectedRegion &region, const wxString &title);
 
+   //This adds many labels, sorting them in together rather than one at a
+   //time.  The order is the same as after AddLabel for each in turn, also
+   //for labels that start at the same time.  Listeners are told of each, as
+   //if by AddLabel in order of the positions that result.
+   void AddLabels(LabelArray labels);
+
    //This deletes the label at given index.
    void DeleteLabel(int index);
 
@@ -10,8 +10,12 @@ Paul Licameli split from Mix.cpp
 
 #include "MixAndRender.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "BasicUI.h"
 #include "Mix.h"
+#include "ParallelMix.h"
 #include "WaveTrack.h"
 
 using WaveTrackConstArray = std::vector < std::shared_ptr < const WaveTrack > >;
@@ -121,16 +125,39 @@ void MixAndRender(TrackList *tracks, WaveTrackFactory *trackFactory,
       endTime = mixEndTime;
    }
 
-   Mixer mixer(waveArray,
-      // Throw to abort mix-and-render if read fails:
-      true,
-      Mixer::WarpOptions{*tracks},
-      startTime, endTime, mono ? 1 : 2, maxBlockLen, false,
-      rate, format);
-
    using namespace BasicUI;
    auto updateResult = ProgressResult::Success;
+
+   const auto numThreads = std::max(1u, std::thread::hardware_concurrency());
+   // A time track warps the timeline, so that segments of the output don't
+   // correspond to fixed times; then mix in one pass
+   if (numThreads > 1 &&
+       (endTime - startTime) * rate > 2 * ParallelMixSegmentFrames &&
+       !Mixer::WarpOptions::DefaultWarp::Call(*tracks))
    {
+      std::vector<WaveTrack*> outputs{ mixLeft.get() };
+      if (!mono)
+         outputs.push_back(mixRight.get());
+      auto pProgress = MakeProgress(XO("Mix and Render"),
+         XO("Mixing and rendering tracks"));
+      MixInParallel(waveArray, rate, format, startTime, endTime,
+         numThreads, maxBlockLen, outputs.size(),
+         [&](unsigned channel, constSamplePtr buffer, size_t len){
+            outputs[channel]->Append(buffer, format, len);
+         },
+         [&](double done){
+            updateResult = pProgress->Poll(done, endTime - startTime);
+            return updateResult == ProgressResult::Success;
+         });
+   }
+   else {
+      Mixer mixer(waveArray,
+         // Throw to abort mix-and-render if read fails:
+         true,
+         Mixer::WarpOptions{*tracks},
+         startTime, endTime, mono ? 1 : 2, maxBlockLen, false,
+         rate, format);
+
       auto pProgress = MakeProgress(XO("Mix and Render"),
          XO("Mixing and rendering tracks"));
 
@@ -31,6 +31,8 @@ class WaveTrackFactory;
  * If the start and end times passed are the same this is taken as meaning
  * no explicit time range to process, and the whole occupied length of the
  * input tracks is processed.
+ * Long mixes are divided into segments of time that are mixed by several
+ * threads, unless a time track warps the timeline.
  */
 void TENACITY_DLL_API MixAndRender(TrackList * tracks, WaveTrackFactory *factory,
                   double rate, sampleFormat format,
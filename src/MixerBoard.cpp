@@ -12,6 +12,7 @@
 #include "MixerBoard.h"
 
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 
@@ -608,53 +609,45 @@ void MixerTrackCluster::UpdateMeter(const double t0, const double t1)
    auto nFrames = scnFrames.as_size_t();
 
    Floats tempFloatsArray{ nFrames };
-   decltype(tempFloatsArray) meterFloatsArray;
+   // We always pass a stereo sample array to the meter, as it shows 2 channels.
+   // Mono shows same in both meters.
+   Floats meterFloatsArray{ 2 * nFrames };
+
+   // Interleave for stereo, applying the gain and clipping to [-1.0, 1.0]
+   // range as we go; the meter then measures both channels in one pass.
+   //vvv Need to apply envelope, too? See Mixer::MixSameRate.
+   const auto interleave = [&](unsigned channel, float gain) {
+      for (unsigned int index = 0; index < nFrames; index++)
+         meterFloatsArray[(2 * index) + channel] =
+            std::clamp(tempFloatsArray[index] * gain, -1.0f, 1.0f);
+   };
+
    // Don't throw on read error in this drawing update routine
    bool bSuccess = pTrack->GetFloats(tempFloatsArray.get(),
       startSample, nFrames, fillZero, false);
    if (bSuccess)
    {
-      // We always pass a stereo sample array to the meter, as it shows 2 channels.
-      // Mono shows same in both meters.
-      // Since we're not mixing, need to duplicate same signal for "right" channel in mono case.
-      meterFloatsArray = Floats{ 2 * nFrames };
-
-      // Interleave for stereo. Left/mono first.
-      for (unsigned int index = 0; index < nFrames; index++)
-         meterFloatsArray[2 * index] = tempFloatsArray[index];
+      // Left/mono first.
+      interleave(0, pTrack->GetChannelGain(0));
 
       if (GetRight())
+      {
          // Again, don't throw
          bSuccess = GetRight()->GetFloats(tempFloatsArray.get(),
             startSample, nFrames, fillZero, false);
-
-      if (bSuccess)
-         // Interleave right channel, or duplicate same signal for "right" channel in mono case.
-         for (unsigned int index = 0; index < nFrames; index++)
-            meterFloatsArray[(2 * index) + 1] = tempFloatsArray[index];
+         if (bSuccess)
+            interleave(1, GetRight()->GetChannelGain(1));
+      }
+      else
+         // Since we're not mixing, need to duplicate same signal for "right"
+         // channel in mono case.
+         interleave(1, pTrack->GetChannelGain(1));
    }
 
    //const bool bWantPostFadeValues = true; //v Turn this into a checkbox on MixerBoard? For now, always true.
    //if (bSuccess && bWantPostFadeValues)
    if (bSuccess)
    {
-      //vvv Need to apply envelope, too? See Mixer::MixSameRate.
-      float gain = pTrack->GetChannelGain(0);
-      for (unsigned int index = 0; index < nFrames; index++)
-         meterFloatsArray[2 * index] *= gain;
-      if (GetRight())
-         gain = GetRight()->GetChannelGain(1);
-      else
-         gain = pTrack->GetChannelGain(1);
-      for (unsigned int index = 0; index < nFrames; index++)
-         meterFloatsArray[(2 * index) + 1] *= gain;
-      // Clip to [-1.0, 1.0] range.
-      for (unsigned int index = 0; index < 2 * nFrames; index++)
-         if (meterFloatsArray[index] < -1.0)
-            meterFloatsArray[index] = -1.0;
-         else if (meterFloatsArray[index] > 1.0)
-            meterFloatsArray[index] = 1.0;
-
       if (mMeter)
          mMeter->UpdateDisplay(2, nFrames, meterFloatsArray.get());
    }
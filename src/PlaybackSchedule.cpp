@@ -160,6 +160,11 @@ const PlaybackPolicy &PlaybackSchedule::GetPolicy() const
    return const_cast<PlaybackSchedule&>(*this).GetPolicy();
 }
 
+namespace {
+//! Longest loop, in seconds, whose output is kept in memory after a pass
+constexpr double MaxCachedLoopDuration = 30.0;
+}
+
 LoopingPlaybackPolicy::~LoopingPlaybackPolicy() = default;
 
 bool LoopingPlaybackPolicy::Done( PlaybackSchedule &, unsigned long )
@@ -259,8 +264,13 @@ bool LoopingPlaybackPolicy::RepositionPlayback(
    // and if yes, restart from the beginning.
    if (schedule.RealTimeRemaining() <= 0)
    {
+      // Loops short enough to keep in memory are mixed once more, then
+      // replayed; the slack allows for rounding of the lengths of slices
+      const auto maxFrames = schedule.mWarpedLength <= MaxCachedLoopDuration
+         ? static_cast<size_t>(lrint(schedule.mWarpedLength * mRate)) + 64
+         : 0;
       for (auto &pMixer : playbackMixers)
-         pMixer->Restart();
+         pMixer->RestartLoop(maxFrames);
       schedule.RealTimeRestart();
    }
    return false;
@@ -11,146 +11,304 @@
 ******************************************************************//**
 
 \class Profiler
-\brief A simple profiler to measure the average time lengths that a
-particular task/function takes.  Currently not thread-safe and not thread-smart,
-but it will probably work fine if you use it on a high level.
+\brief A profiler to measure the distribution of time lengths that a
+particular task/function takes.
 
-\class TaskProfile
-\brief a simple class to keep track of one task that may be called multiple times.
+\class Profiler::Ring
+\brief Events recorded by one thread, waiting for the aggregator
 
 *//*******************************************************************/
 
 
 #include "Profiler.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
+#include <ctime>
+#include <string>
 #include <wx/crt.h>
 
-///write to a profile at the end of the test.
-Profiler::~Profiler()
+namespace {
+
+//Durations kept per task for percentiles; beyond this, a uniform sample
+constexpr size_t MaxSamples = 1 << 16;
+//Tasks kept for the trace; later ones are left out
+constexpr size_t MaxTraceEvents = 1 << 20;
+
+double Percentile(const std::vector<double> &sorted, double fraction)
 {
-   if(mTasks.size())
+   if (sorted.empty())
+      return 0.0;
+   // Nearest rank
+   const auto rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+   return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+std::string Escape(const char* str)
+{
+   std::string result;
+   for (; *str; ++str) {
+      if (*str == '"' || *str == '\\')
+         result += '\\';
+      result += *str;
+   }
+   return result;
+}
+
+//Microseconds with three decimals, independent of the locale
+void PrintMicroseconds(FILE* file, std::chrono::steady_clock::duration time)
+{
+   const long long ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+   fprintf(file, "%lld.%03lld", ns / 1000, ns % 1000);
+}
+
+}
+
+class Profiler::Ring
+{
+public:
+   static constexpr size_t Size = 1 << 14;
+
+   explicit Ring(unsigned thread) : mThread{ thread } {}
+
+   ///Called only by the thread that owns the ring
+   void Push(const Site &site, bool begin)
    {
-      //print everything out.  append to a log.
-      FILE* log = fopen("TenacityProfilerLog.txt", "a");
-      time_t now;
-
-      time(&now);
-      wxFprintf(log,"Tenacity Profiler Run, Ended at ");
-      wxFprintf(log,"%s",ctime(&now));
-      wxFprintf(log,"****************************************\n");
-      //print out the tasks
-      for(int i=0;i<(int)mTasks.size();i++)
-      {
-         if(mTasks[i]->mNumHits>0)
-         {
-            wxFprintf(log,"Task: %s\n(begins at line %d in %s)\n\n",mTasks[i]->mDescription.get(), mTasks[i]->mLine, mTasks[i]->mFileName.get());
-            wxFprintf(log,"Number of times run: %d\n",mTasks[i]->mNumHits);
-            wxFprintf(log,"Total run time (seconds): %f\n", (double)mTasks[i]->mCumTime/CLOCKS_PER_SEC);
-            wxFprintf(log,"Average run time (seconds): %f\n",mTasks[i]->ComputeAverageRunTime());
-
-            if(i < ((int)mTasks.size()) -1)
-               wxFprintf(log,"----------------------------\n");
-         }
+      const auto time = Clock::now();
+      const auto written = mWritten.load(std::memory_order_relaxed);
+      if (written - mRead.load(std::memory_order_acquire) == Size) {
+         // The aggregator fell behind; don't wait for it
+         mDropped.fetch_add(1, std::memory_order_relaxed);
+         return;
       }
-      wxFprintf(log,"\n****************************************\n\n\n");
+      mEvents[written % Size] = { &site, time, begin };
+      mWritten.store(written + 1, std::memory_order_release);
+   }
 
-      fclose(log);
+   ///Called only by the aggregator
+   template<typename Function> void Pop(const Function &function)
+   {
+      const auto written = mWritten.load(std::memory_order_acquire);
+      auto read = mRead.load(std::memory_order_relaxed);
+      for (; read != written; ++read)
+         function(mEvents[read % Size]);
+      mRead.store(read, std::memory_order_release);
    }
+
+   size_t TakeDropped()
+   {
+      return mDropped.exchange(0, std::memory_order_relaxed);
+   }
+
+   const unsigned mThread;
+   //Beginnings not yet matched with ends, used only by the aggregator
+   std::vector<Event> mOpen;
+
+private:
+   std::array<Event, Size> mEvents;
+   std::atomic<size_t> mWritten{ 0 };
+   std::atomic<size_t> mRead{ 0 };
+   std::atomic<size_t> mDropped{ 0 };
+};
+
+Profiler::Profiler()
+   : mStart{ Clock::now() }
+{
+   mAggregator = std::thread{ [this]{ Aggregate(); } };
+}
+
+///write the reports at the end of the test.
+Profiler::~Profiler()
+{
+   {
+      std::lock_guard<std::mutex> guard{ mMutex };
+      mStopping = true;
+   }
+   mWake.notify_one();
+   mAggregator.join();
+
+   WriteReport("TenacityProfilerLog.txt");
+   WriteTrace("TenacityProfilerTrace.json");
 }
 
 ///start the task timer.
-void Profiler::Begin(const char* fileName, int lineNum, const char* taskDescription)
+void Profiler::Begin(const Site &site)
 {
-   std::lock_guard<std::mutex> guard{ mTasksMutex };
-   GetOrCreateTaskProfile(fileName,lineNum)->Begin(fileName,lineNum,taskDescription);
+   ThreadRing().Push(site, true);
 }
 
 ///end the task timer.
-void Profiler::End(const char* fileName, int lineNum, const char* taskDescription)
+void Profiler::End(const Site &site)
 {
-   std::lock_guard<std::mutex> guard{ mTasksMutex };
-   TaskProfile* tp;
-   tp=GetTaskProfileByDescription(taskDescription);
-   if(tp)
-      tp->End(fileName,lineNum,taskDescription);
+   ThreadRing().Push(site, false);
+}
+
+void Profiler::RegisterThread()
+{
+   ThreadRing();
 }
 
 ///Gets the singleton instance
 Profiler* Profiler::Instance()
 {
    static Profiler pro;
-   //this isn't 100% threadsafe but I think Okay for this purpose.
-
    return &pro;
 }
 
-///find a taskProfile for the given task, otherwise create
-TaskProfile* Profiler::GetOrCreateTaskProfile(const char* fileName, int lineNum)
+Profiler::Ring &Profiler::ThreadRing()
 {
-   for(int i=0;i<(int)mTasks.size();i++)
-   {
-      if(strcmp(fileName, mTasks[i]->mFileName.get())==0 && lineNum == mTasks[i]->mLine)
-         return mTasks[i].get();
-   }
+   // Allocated at the first use in each thread, and kept after the thread
+   // finishes until the aggregator is done with it
+   thread_local const auto ring = Instance()->NewRing();
+   return *ring;
+}
 
-   auto tp = std::make_unique<TaskProfile>();
-   mTasks.push_back(std::move(tp));
-   return mTasks.back().get();
+std::shared_ptr<Profiler::Ring> Profiler::NewRing()
+{
+   std::lock_guard<std::mutex> guard{ mMutex };
+   mRings.push_back(std::make_shared<Ring>(mRings.size() + 1));
+   return mRings.back();
 }
 
-TaskProfile* Profiler::GetTaskProfileByDescription(const char* description)
+void Profiler::Aggregate()
 {
-   for(int i=0;i<(int)mTasks.size();i++)
-   {
-      if(strcmp(description, mTasks[i]->mDescription.get())==0)
-         return mTasks[i].get();
+   std::unique_lock<std::mutex> lock{ mMutex };
+   while (!mStopping) {
+      mWake.wait_for(lock, std::chrono::milliseconds(20));
+      Drain();
    }
+}
 
-   return NULL;
+void Profiler::Drain()
+{
+   for (const auto &pRing : mRings) {
+      auto &ring = *pRing;
+      mDropped += ring.TakeDropped();
+      ring.Pop([&](const Event &event){
+         if (event.begin) {
+            ring.mOpen.push_back(event);
+            return;
+         }
 
-}
+         // Match the innermost unfinished task with the same description
+         const auto iter = std::find_if(ring.mOpen.rbegin(), ring.mOpen.rend(),
+            [&](const Event &open){
+               return 0 == strcmp(
+                  open.site->mDescription, event.site->mDescription);
+            });
+         if (iter == ring.mOpen.rend())
+            // Its beginning was dropped, or it never began
+            return;
+         const auto begin = *iter;
+         ring.mOpen.erase(std::next(iter).base());
 
+         const auto duration = event.time - begin.time;
+         const auto seconds = std::chrono::duration<double>(duration).count();
+         auto &stats = mStats[begin.site];
+         ++stats.count;
+         stats.total += seconds;
+         stats.maximum = std::max(stats.maximum, seconds);
+         if (stats.durations.size() < MaxSamples)
+            stats.durations.push_back(seconds);
+         else {
+            // Reservoir sampling
+            const auto index = std::uniform_int_distribution<size_t>{
+               0, stats.count - 1 }(mSampler);
+            if (index < MaxSamples)
+               stats.durations[index] = seconds;
+         }
 
-///Task Profile
-TaskProfile::TaskProfile()
-{
-   mCumTime=0;
-   mNumHits=0;
+         if (mTrace.size() < MaxTraceEvents)
+            mTrace.push_back({ begin.site, ring.mThread, begin.time, duration });
+      });
+   }
 }
 
-TaskProfile::~TaskProfile()
+bool Profiler::WriteReport(const char* fileName)
 {
-}
+   std::lock_guard<std::mutex> guard{ mMutex };
+   Drain();
+   if (mStats.empty())
+      return true;
 
-///start the task timer.
-void TaskProfile::Begin(const char* fileName, int lineNum, const char* taskDescription)
-{
-   if(!mFileName)
+   //print everything out.  append to a log.
+   FILE* log = fopen(fileName, "a");
+   if (!log)
+      return false;
+
+   //longest total time first
+   std::vector<std::pair<const Site*, const TaskStats*>> tasks;
+   for (const auto &pair : mStats)
+      tasks.emplace_back(pair.first, &pair.second);
+   std::sort(tasks.begin(), tasks.end(), [](const auto &a, const auto &b){
+      return a.second->total > b.second->total;
+   });
+
+   time_t now;
+
+   time(&now);
+   wxFprintf(log,"Tenacity Profiler Run, Ended at ");
+   wxFprintf(log,"%s",ctime(&now));
+   wxFprintf(log,"****************************************\n");
+   //print out the tasks
+   for (size_t i = 0; i < tasks.size(); ++i)
    {
-      mFileName.reinit( strlen(fileName) + 1 );
-      strcpy(mFileName.get(), fileName);
-      mDescription.reinit( strlen(taskDescription) + 1 );
-      strcpy(mDescription.get(), taskDescription);
-      mLine = lineNum;
-   }
+      const auto &site = *tasks[i].first;
+      const auto &stats = *tasks[i].second;
+      auto sorted = stats.durations;
+      std::sort(sorted.begin(), sorted.end());
 
-   mLastTime = clock();
+      wxFprintf(log,"Task: %s\n(begins at line %d in %s)\n\n",site.mDescription, site.mLine, site.mFileName);
+      wxFprintf(log,"Number of times run: %lu\n",(unsigned long)stats.count);
+      wxFprintf(log,"Total run time (seconds): %f\n", stats.total);
+      wxFprintf(log,"Average run time (seconds): %f\n", stats.total / stats.count);
+      wxFprintf(log,"Median run time (seconds): %f\n", Percentile(sorted, 0.5));
+      wxFprintf(log,"90th percentile run time (seconds): %f\n", Percentile(sorted, 0.9));
+      wxFprintf(log,"99th percentile run time (seconds): %f\n", Percentile(sorted, 0.99));
+      wxFprintf(log,"Maximum run time (seconds): %f\n", stats.maximum);
 
-}
+      if (i + 1 < tasks.size())
+         wxFprintf(log,"----------------------------\n");
+   }
+   if (mDropped)
+      wxFprintf(log,"\nEvents dropped because recording outpaced the profiler: %lu\n",(unsigned long)mDropped);
+   wxFprintf(log,"\n****************************************\n\n\n");
 
-///end the task timer.
-void TaskProfile::End(const char* /* fileName */, int /* lineNum */, const char* /* taskDescription */)
-{
-   mCumTime += clock() - mLastTime;
-   mNumHits++;
+   return fclose(log) == 0;
 }
 
-double TaskProfile::ComputeAverageRunTime()
+bool Profiler::WriteTrace(const char* fileName)
 {
-   if(mNumHits)
-      return (double) ((double)mCumTime/CLOCKS_PER_SEC)/mNumHits;
-   else
-      return 0.0;
+   std::lock_guard<std::mutex> guard{ mMutex };
+   Drain();
+   if (mTrace.empty())
+      return true;
+
+   FILE* file = fopen(fileName, "w");
+   if (!file)
+      return false;
+
+   fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+   const char* separator = "\n";
+   for (const auto &event : mTrace) {
+      fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s:%d\",\"ph\":\"X\","
+         "\"pid\":1,\"tid\":%u,\"ts\":",
+         separator,
+         Escape(event.site->mDescription).c_str(),
+         Escape(event.site->mFileName).c_str(), event.site->mLine,
+         event.thread);
+      PrintMicroseconds(file, event.start - mStart);
+      fprintf(file, ",\"dur\":");
+      PrintMicroseconds(file, event.duration);
+      fprintf(file, "}");
+      separator = ",\n";
+   }
+   fprintf(file, "\n]}\n");
+
+   return fclose(file) == 0;
 }
@@ -11,81 +11,164 @@
 ******************************************************************//**
 
 \class Profiler
-\brief A simple profiler to measure the average time lengths that a
-particular task/function takes.  Currently not thread-safe and not thread-smart,
-but it will probably work fine if you use it on a high level.
-
-\class TaskProfile
-\brief a simple class to keep track of one task that may be called multiple times.
+\brief A profiler to measure the distribution of time lengths that a
+particular task/function takes.
+
+Each place that begins or ends a task is registered once, statically.
+Recording a time appends to a ring buffer belonging to the calling thread,
+without locks or allocation, so that tasks can be timed on the audio thread.
+The ring is made at the first use in each thread, which locks and
+allocates; a thread that must never do so calls RegisterThread() first.
+A background thread drains the buffers and pairs the beginnings and ends of
+tasks.  When the program exits, a text report of percentiles is appended to
+TenacityProfilerLog.txt, and the individual tasks are written to
+TenacityProfilerTrace.json, which Perfetto and chrome://tracing can show.
+
+\class Profiler::Site
+\brief A place in the code that begins or ends a task
 
 *//*******************************************************************/
 
 
 #ifndef __AUDACITY_PROFILER__
 #define __AUDACITY_PROFILER__
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <random>
+#include <thread>
 #include <vector>
-#include <time.h>
-
-// Tenacity libraries
-#include <lib-utility/MemoryX.h>
-
 
-#define BEGIN_TASK_PROFILING(TASK_DESCRIPTION) Profiler::Instance()->Begin(__FILE__,__LINE__,TASK_DESCRIPTION)
-#define END_TASK_PROFILING(TASK_DESCRIPTION) Profiler::Instance()->End(__FILE__,__LINE__,TASK_DESCRIPTION)
+#define BEGIN_TASK_PROFILING(TASK_DESCRIPTION) \
+   do { \
+      static const Profiler::Site site{ __FILE__, __LINE__, TASK_DESCRIPTION }; \
+      Profiler::Begin(site); \
+   } while (false)
+#define END_TASK_PROFILING(TASK_DESCRIPTION) \
+   do { \
+      static const Profiler::Site site{ __FILE__, __LINE__, TASK_DESCRIPTION }; \
+      Profiler::End(site); \
+   } while (false)
+
+#define PROFILER_CONCAT_(a, b) a ## b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+//! Time the rest of the enclosing block as a task
+#define TASK_PROFILING_SCOPE(TASK_DESCRIPTION) \
+   static const Profiler::Site PROFILER_CONCAT(profilerSite, __LINE__){ \
+      __FILE__, __LINE__, TASK_DESCRIPTION }; \
+   const Profiler::Scope PROFILER_CONCAT(profilerScope, __LINE__){ \
+      PROFILER_CONCAT(profilerSite, __LINE__) }
 
-class TaskProfile;
 class Profiler
 {
  public:
+   struct Site
+   {
+      constexpr Site(
+         const char* fileName, int lineNum, const char* taskDescription)
+         : mFileName{ fileName }
+         , mLine{ lineNum }
+         , mDescription{ taskDescription }
+      {}
+
+      const char* const mFileName;
+      const int mLine;
+      //! Beginnings and ends of the same task are matched by description
+      const char* const mDescription;
+   };
 
-   ///write to a profile at the end of the test.
+   //! Begins a task at construction and ends it at destruction
+   class Scope
+   {
+   public:
+      explicit Scope(const Site &site) : mSite{ site } { Begin(mSite); }
+      ~Scope() { End(mSite); }
+      Scope(const Scope&) = delete;
+      Scope &operator=(const Scope&) = delete;
+   private:
+      const Site &mSite;
+   };
+
+   ///write the reports at the end of the test.
    virtual ~Profiler();
 
-   ///start the task timer.
-   void Begin(const char* fileName, int lineNum, const char* taskDescription);
-   ///end the task timer.
-   void End(const char* fileName, int lineNum, const char* taskDescription);
+   ///start the task timer.  Wait-free, after the first call in a thread
+   static void Begin(const Site &site);
+   ///end the task timer.  Wait-free, after the first call in a thread
+   static void End(const Site &site);
+
+   ///Make the ring of the calling thread, so that its first Begin() or End()
+   ///doesn't lock or allocate.  Call before the thread has time constraints
+   static void RegisterThread();
 
    ///Gets the singleton instance
    static Profiler* Instance();
 
+   ///Append percentiles of the task times to a text file
+   bool WriteReport(const char* fileName);
+   ///Write the timed tasks in the Trace Event Format of Chrome and Perfetto
+   bool WriteTrace(const char* fileName);
+
   protected:
    ///private constructor - Singleton.
-   Profiler(){};
+   Profiler();
 
-   ///find a taskProfile for the given task, otherwise create
-   TaskProfile* GetOrCreateTaskProfile(const char* fileName, int lineNum);
-   TaskProfile* GetTaskProfileByDescription(const char* description);
+   using Clock = std::chrono::steady_clock;
 
-   //List of current Task to do.
-   std::vector<std::unique_ptr<TaskProfile>> mTasks;
-   //mutex for above variable
-   std::mutex mTasksMutex;
+   struct Event
+   {
+      const Site* site;
+      Clock::time_point time;
+      bool begin;
+   };
 
-};
+   class Ring;
 
- class TaskProfile
+   struct TaskStats
    {
-   public:
-      TaskProfile();
-      virtual ~TaskProfile();
-
-      ///start the task timer.
-      void Begin(const char* fileName, int lineNum, const char* taskDescription);
-      ///end the task timer.
-      void End(const char* fileName, int lineNum, const char* taskDescription);
-
-      double ComputeAverageRunTime();
-
-      ArrayOf<char> mFileName;
-      int mLine;
-      ArrayOf<char> mDescription;
-      int mNumHits;
-      clock_t mCumTime;
-      clock_t mLastTime;
+      size_t count{ 0 };
+      double total{ 0 };
+      double maximum{ 0 };
+      //A uniform sample of the durations, for percentiles
+      std::vector<double> durations;
+   };
+
+   struct TraceEvent
+   {
+      const Site* site;
+      unsigned thread;
+      Clock::time_point start;
+      Clock::duration duration;
    };
 
+   static Ring &ThreadRing();
+   std::shared_ptr<Ring> NewRing();
+
+   ///pair up the events recorded since the last call
+   void Drain();
+   void Aggregate();
+
+   //Rings of all threads that have recorded, including finished threads
+   std::vector<std::shared_ptr<Ring>> mRings;
+   //mutex for the above and for the aggregated data
+   std::mutex mMutex;
+
+   const Clock::time_point mStart;
+   std::condition_variable mWake;
+   bool mStopping{ false };
+
+   //Durations by the site that began the task
+   std::map<const Site*, TaskStats> mStats;
+   std::minstd_rand mSampler;
+   std::vector<TraceEvent> mTrace;
+   size_t mDropped{ 0 };
+
+   //Started last, when the members it uses are constructed
+   std::thread mAggregator;
+};
 
 #endif
 
@@ -72,6 +72,8 @@ ProjectAudioManager::ProjectAudioManager( TenacityProject &project )
       registerStatusWidthFunction{ StatusWidthFunction };
    project.Bind( EVT_CHECKPOINT_FAILURE,
       &ProjectAudioManager::OnCheckpointFailure, this );
+   mTrackListSubscription = TrackList::Get( project )
+      .Subscribe( *this, &ProjectAudioManager::OnTrackListEvent );
 }
 
 ProjectAudioManager::~ProjectAudioManager() = default;
@@ -929,12 +931,33 @@ void ProjectAudioManager::OnAudioIONewBlocks(const WaveTrackArray *tracks)
 {
    auto &project = mProject;
    auto &projectFileIO = ProjectFileIO::Get( project );
+
+   // While the capture journal also keeps the recording, a crash loses
+   // nothing between autosaves, so they can be much less frequent
+   constexpr auto JournaledAutoSaveInterval = std::chrono::seconds(60);
+   const auto now = std::chrono::steady_clock::now();
+   auto gAudioIO = AudioIO::Get();
+   if (gAudioIO->IsCaptureJournaling() &&
+       now - mLastRecordingAutoSave < JournaledAutoSaveInterval) {
+      mRecordingAutoSaveSkipped = true;
+      return;
+   }
+   mLastRecordingAutoSave = now;
+   mRecordingAutoSaveSkipped = false;
    projectFileIO.AutoSave(true);
 }
 
 void ProjectAudioManager::OnCommitRecording()
 {
    const auto project = &mProject;
+   auto &projectFileIO = ProjectFileIO::Get( *project );
+
+   // Catch up on skipped autosaves before the capture journal is discarded,
+   // or else keep the journal
+   if (mRecordingAutoSaveSkipped.exchange(false) &&
+       !projectFileIO.AutoSave(true))
+      AudioIO::Get()->KeepCaptureJournal();
+
    TrackList::Get( *project ).ApplyPendingTracks();
 }
 
@@ -947,6 +970,68 @@ void ProjectAudioManager::OnSoundActivationThreshold()
    }
 }
 
+// Play tracks added to the project, and silence tracks removed from it,
+// without restarting playback
+void ProjectAudioManager::OnTrackListEvent(const TrackListEvent &event)
+{
+   auto gAudioIO = AudioIO::Get();
+   const auto token = ProjectAudioIO::Get( mProject ).GetAudioIOToken();
+   if (!gAudioIO || !gAudioIO->IsStreamActive( token ) || mCutPreviewTracks)
+      return;
+
+   switch (event.mType) {
+   case TrackListEvent::ADDITION:
+      // Commands add the channels of a track one by one, and group them
+      // after; play them once the command is done
+      if (mAddedTracks.empty())
+         BasicUI::CallAfter( [wThis = weak_from_this()]{
+            if (auto pThis = wThis.lock())
+               pThis->PlayAddedTracks();
+         } );
+      mAddedTracks.push_back( event.mpTrack );
+      break;
+   case TrackListEvent::DELETION: {
+      const auto &tracks = TrackList::Get( mProject );
+      gAudioIO->RemovePlaybackTracks( [&](const WaveTrack &track){
+         return track.GetOwner().get() != &tracks;
+      } );
+      break;
+   }
+   default:
+      break;
+   }
+}
+
+void ProjectAudioManager::PlayAddedTracks()
+{
+   std::vector<std::weak_ptr<Track>> added;
+   added.swap( mAddedTracks );
+
+   auto gAudioIO = AudioIO::Get();
+   const auto token = ProjectAudioIO::Get( mProject ).GetAudioIOToken();
+   if (!gAudioIO || !gAudioIO->IsStreamActive( token ) || mCutPreviewTracks)
+      return;
+
+   // Add each group of channels once
+   auto &tracks = TrackList::Get( mProject );
+   std::vector<const Track *> leaders;
+   for (const auto &wTrack : added) {
+      const auto pTrack = wTrack.lock();
+      // Skip tracks removed since
+      if (!pTrack || pTrack->GetOwner().get() != &tracks)
+         continue;
+      const auto pLeader =
+         dynamic_cast<WaveTrack *>( *tracks.FindLeader( pTrack.get() ) );
+      if (!pLeader || make_iterator_range( leaders ).contains( pLeader ))
+         continue;
+      leaders.push_back( pLeader );
+      WaveTrackArray channels;
+      for (auto channel : TrackList::Channels( pLeader ))
+         channels.push_back( channel->SharedPointer<WaveTrack>() );
+      gAudioIO->AddPlaybackTracks( channels );
+   }
+}
+
 void ProjectAudioManager::OnCheckpointFailure(wxCommandEvent &evt)
 {
    evt.Skip();
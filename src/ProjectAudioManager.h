@@ -11,18 +11,23 @@ Paul Licameli split from ProjectManager.h
 #ifndef __AUDACITY_PROJECT_AUDIO_MANAGER__
 #define __AUDACITY_PROJECT_AUDIO_MANAGER__
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <vector>
 
 #include "AudioIOListener.h" // to inherit
 #include "ClientData.h" // to inherit
+#include <lib-utility/Observer.h>
 #include <wx/event.h> // to declare custom event type
 
 constexpr int RATE_NOT_SELECTED{ -1 };
 
 class TenacityProject;
 struct AudioIOStartStreamOptions;
+class Track;
 class TrackList;
+struct TrackListEvent;
 class SelectedRegion;
 
 class WaveTrack;
@@ -144,9 +149,15 @@ private:
    void OnSoundActivationThreshold() override;
 
    void OnCheckpointFailure(wxCommandEvent &evt);
+   void OnTrackListEvent(const TrackListEvent &event);
+   void PlayAddedTracks();
 
    TenacityProject &mProject;
 
+   Observer::Subscription mTrackListSubscription;
+   //! Tracks added while playing, to play when their channels are grouped
+   std::vector<std::weak_ptr<Track>> mAddedTracks;
+
    std::shared_ptr<TrackList> mCutPreviewTracks;
 
    PlayMode mLastPlayMode{ PlayMode::normalPlay };
@@ -154,6 +165,11 @@ private:
    //flag for cancellation of timer record.
    bool mTimerRecordCanceled{ false };
 
+   //! When the project was last autosaved for new blocks of a recording
+   std::chrono::steady_clock::time_point mLastRecordingAutoSave;
+   //! Whether new blocks were recorded since then
+   std::atomic<bool> mRecordingAutoSaveSkipped{ false };
+
    bool mPaused{ false };
    bool mAppending{ false };
    bool mLooping{ false };
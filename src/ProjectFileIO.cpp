@@ -433,7 +433,8 @@ bool ProjectFileIO::InitializeSQL()
 static void RefreshAllTitles(bool bShowProjectNumbers )
 {
    for ( auto pProject : AllProjects{} ) {
-      if ( !GetProjectFrame( *pProject ).IsIconized() ) {
+      auto pWindow = FindProjectFrame( pProject.get() );
+      if ( pWindow && !pWindow->IsIconized() ) {
          ProjectFileIO::Get( *pProject ).SetProjectTitle(
             bShowProjectNumbers ? pProject->GetProjectNumber() : -1 );
       }
@@ -157,7 +157,8 @@ auto ProjectFileManager::ReadProjectFile(
 {
    auto &project = mProject;
    auto &projectFileIO = ProjectFileIO::Get( project );
-   auto &window = GetProjectFrame( project );
+   // Null in headless mode
+   auto pWindow = FindProjectFrame( &project );
 
    ///
    /// Parse project file
@@ -190,7 +191,7 @@ auto ProjectFileManager::ReadProjectFile(
                     "to preserve its contents."),
             XO("Project Recovered"),
             wxICON_WARNING,
-            &window);
+            pWindow);
       }
 
       // By making a duplicate set of pointers to the existing blocks
@@ -276,7 +277,8 @@ bool ProjectFileManager::DoSave(const FilePath & fileName, const bool fromSaveAs
    // See explanation above
    // ProjectDisabler disabler(this);
    auto &proj = mProject;
-   auto &window = GetProjectFrame( proj );
+   // Null in headless mode
+   auto pWindow = FindProjectFrame( &proj );
    auto &projectFileIO = ProjectFileIO::Get( proj );
    const auto &settings = ProjectSettings::Get( proj );
 
@@ -298,7 +300,7 @@ bool ProjectFileManager::DoSave(const FilePath & fileName, const bool fromSaveAs
    "Your project is now empty.\nIf saved, the project will have no tracks.\n\nTo save any previously open tracks:\nClick 'No', Edit > Undo until all tracks\nare open, then File > Save Project.\n\nSave anyway?"),
                XO("Warning - Empty Project"),
                wxYES_NO | wxICON_QUESTION,
-               &window);
+               pWindow);
             if (result == wxNO)
             {
                return false;
@@ -972,8 +974,10 @@ TenacityProject *ProjectFileManager::OpenFile( const ProjectChooserFn &chooser,
          if (Get(project).Import(fileName)) {
             // Undo history is incremented inside this:
             // Bug 2743: Don't zoom with lof.
+            // There is nothing to zoom in headless mode
             if (!fileName.AfterLast('.').IsSameAs(wxT("lof"), false))
-               ProjectWindow::Get(project).ZoomAfterImport(nullptr);
+               if (auto pWindow = ProjectWindow::Find(&project))
+                  pWindow->ZoomAfterImport(nullptr);
             return &project;
          }
          return nullptr;
@@ -999,9 +1003,9 @@ TenacityProject *ProjectFileManager::OpenProjectFile(
    auto &project = mProject;
    auto &history = ProjectHistory::Get( project );
    auto &tracks = TrackList::Get( project );
-   auto &trackPanel = TrackPanel::Get( project );
    auto &projectFileIO = ProjectFileIO::Get( project );
-   auto &window = ProjectWindow::Get( project );
+   // Null in headless mode, and then there is no track panel either
+   auto pWindow = ProjectWindow::Find( &project );
 
    auto results = ReadProjectFile( fileName );
    const bool bParseSuccess = results.parseSuccess;
@@ -1010,7 +1014,8 @@ TenacityProject *ProjectFileManager::OpenProjectFile(
 
    if (bParseSuccess) {
       auto &settings = ProjectSettings::Get( project );
-      window.mbInitializingScrollbar = true; // this must precede AS_SetSnapTo
+      if (pWindow)
+         pWindow->mbInitializingScrollbar = true; // this must precede AS_SetSnapTo
          // to make persistence of the vertical scrollbar position work
 
       auto &selectionManager = ProjectSelectionManager::Get( project );
@@ -1022,19 +1027,23 @@ TenacityProject *ProjectFileManager::OpenProjectFile(
       selectionManager.SSBL_SetBandwidthSelectionFormatName(
       settings.GetBandwidthSelectionFormatName());
 
-      SettingsBar::Get( project )
-         .SetRate( ProjectRate::Get(project).GetRate() );
+      if (pWindow)
+         SettingsBar::Get( project )
+            .SetRate( ProjectRate::Get(project).GetRate() );
 
       ProjectHistory::Get( project ).InitialState();
-      TrackFocus::Get( project ).Set( *tracks.Any().begin() );
-      window.HandleResize();
-      trackPanel.Refresh(false);
-
-      // ? Old rationale in this comment no longer applies in 3.0.0, with no
-      // more on-demand loading:
-      trackPanel.Update(); // force any repaint to happen now,
-      // else any asynch calls into the blockfile code will not have
-      // finished logging errors (if any) before the call to ProjectFSCK()
+      if (pWindow) {
+         TrackFocus::Get( project ).Set( *tracks.Any().begin() );
+         pWindow->HandleResize();
+         auto &trackPanel = TrackPanel::Get( project );
+         trackPanel.Refresh(false);
+
+         // ? Old rationale in this comment no longer applies in 3.0.0, with no
+         // more on-demand loading:
+         trackPanel.Update(); // force any repaint to happen now,
+         // else any asynch calls into the blockfile code will not have
+         // finished logging errors (if any) before the call to ProjectFSCK()
+      }
 
       if (addtohistory)
          FileHistory::Global().Append(fileName);
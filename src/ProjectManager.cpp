@@ -19,6 +19,7 @@ Paul Licameli split from TenacityProject.cpp
 #include "AdornedRulerPanel.h"
 #include "AudioIO.h"
 #include "Clipboard.h"
+#include "HeadlessMode.h"
 #include "Menus.h"
 #include "ModuleManager.h"
 #include "Project.h"
@@ -52,6 +53,7 @@ Paul Licameli split from TenacityProject.cpp
 #include <wx/app.h>
 #include <wx/dataobj.h>
 #include <wx/dnd.h>
+#include <wx/log.h>
 #include <wx/scrolbar.h>
 #include <wx/sizer.h>
 
@@ -81,8 +83,11 @@ ProjectManager::ProjectManager( TenacityProject &project )
    : mProject{ project }
    , mTimer{ std::make_unique<wxTimer>(this, TenacityProjectTimerID) }
 {
-   auto &window = ProjectWindow::Get( mProject );
-   window.Bind( wxEVT_CLOSE_WINDOW, &ProjectManager::OnCloseWindow, this );
+   // Don't make a window just to bind its close event
+   if (!HeadlessMode::IsEnabled()) {
+      auto &window = ProjectWindow::Get( mProject );
+      window.Bind( wxEVT_CLOSE_WINDOW, &ProjectManager::OnCloseWindow, this );
+   }
    mSubscription = ProjectStatus::Get(mProject)
       .Subscribe(*this, &ProjectManager::OnStatusChange);
    project.Bind( EVT_RECONNECTION_FAILURE,
@@ -496,6 +501,70 @@ TenacityProject *ProjectManager::New()
    return p;
 }
 
+TenacityProject *ProjectManager::NewHeadless()
+{
+   auto sp = std::make_shared< TenacityProject >();
+   AllProjects{}.Add( sp );
+   auto p = sp.get();
+   auto &project = *p;
+   auto &projectHistory = ProjectHistory::Get( project );
+   auto &projectManager = Get( project );
+
+   // Not OpenNewProject(), which explains a failure with a dialog
+   if (!ProjectFileManager::Get( project ).OpenProject())
+      wxLogError(wxT("Could not open the temporary project file"));
+
+   // No menus, hence no menu commands; scripting commands and effects are
+   // found through the PluginManager instead
+
+   projectHistory.InitialState();
+   projectManager.RestartTimer();
+
+   auto gAudioIO = AudioIO::Get();
+   gAudioIO->SetListener(
+      ProjectAudioManager::Get( project ).shared_from_this() );
+
+   SetActiveProject(p);
+
+   ModuleManager::Get().Dispatch(ProjectInitialized);
+
+   return p;
+}
+
+void ProjectManager::CloseHeadless(TenacityProject &project)
+{
+   auto &projectFileManager = ProjectFileManager::Get( project );
+
+   ModuleManager::Get().Dispatch(ProjectClosing);
+
+   Get( project ).mTimer.reset();
+
+   auto &clipboard = Clipboard::Get();
+   if ( clipboard.Project().lock().get() == &project )
+      clipboard.Clear();
+
+   // As in OnCloseWindow, but there are no windows to tear down
+   projectFileManager.CompactProjectOnClose();
+   ProjectFileIO::Get( project ).SetBypass();
+   UndoManager::Get( project ).ClearStates();
+   TrackList::Get( project ).Clear();
+   projectFileManager.CloseProject();
+   WaveTrackFactory::Destroy( project );
+
+   auto pSelf = AllProjects{}.Remove( project );
+   wxASSERT( pSelf );
+
+   auto gAudioIO = AudioIO::Get();
+   if ( GetActiveProject().lock().get() == &project ) {
+      auto next = AllProjects{}.empty()
+         ? nullptr : AllProjects{}.begin()->get();
+      SetActiveProject( next );
+      gAudioIO->SetListener( next
+         ? ProjectAudioManager::Get( *next ).shared_from_this()
+         : nullptr );
+   }
+}
+
 void ProjectManager::OnReconnectionFailure(wxCommandEvent & event)
 {
    event.Skip();
@@ -49,6 +49,13 @@ public:
    // This is the factory for projects:
    static TenacityProject *New();
 
+   //! Factory for projects with no window, menus or toolbars
+   /*! For HeadlessMode; the project becomes the active one */
+   static TenacityProject *NewHeadless();
+
+   //! Close a project made by NewHeadless(), without saving it
+   static void CloseHeadless(TenacityProject &project);
+
    // The function that imports files can act as a factory too, and for that
    // reason remains in this class, not in ProjectFileManager
    static void OpenFiles(TenacityProject *proj);
@@ -53,11 +53,16 @@ ProjectSelectionManager::ProjectSelectionManager( TenacityProject &project )
 
 ProjectSelectionManager::~ProjectSelectionManager() = default;
 
+bool ProjectSelectionManager::HasWindow() const
+{
+   // In headless mode there is no window, and so no track panel or toolbars
+   return ProjectWindow::Find( &mProject ) != nullptr;
+}
+
 bool ProjectSelectionManager::SnapSelection()
 {
    auto &project = mProject;
    auto &settings = ProjectSettings::Get( project );
-   auto &window = ProjectWindow::Get( project );
    auto snapTo = settings.GetSnapTo();
    if (snapTo != SNAP_OFF) {
       auto &viewInfo = ViewInfo::Get( project );
@@ -95,7 +100,8 @@ void ProjectSelectionManager::AS_SetRate(double rate)
 {
    auto &project = mProject;
    ProjectRate::Get( project ).SetRate( rate );
-   SettingsBar::Get( project ).SetRate(rate);
+   if (HasWindow())
+      SettingsBar::Get( project ).SetRate(rate);
 }
 
 int ProjectSelectionManager::AS_GetSnapTo()
@@ -109,7 +115,6 @@ void ProjectSelectionManager::AS_SetSnapTo(int snap)
 {
    auto &project = mProject;
    auto &settings = ProjectSettings::Get( project );
-   auto &window = ProjectWindow::Get( project );
 
    settings.SetSnapTo( snap );
 
@@ -120,9 +125,10 @@ void ProjectSelectionManager::AS_SetSnapTo(int snap)
 
    SnapSelection();
 
-   window.RedrawProject();
-
-   SettingsBar::Get( project ).SetSnapTo(snap);
+   if (auto pWindow = ProjectWindow::Find( &project )) {
+      pWindow->RedrawProject();
+      SettingsBar::Get( project ).SetSnapTo(snap);
+   }
 }
 
 const NumericFormatSymbol & ProjectSelectionManager::AS_GetSelectionFormat()
@@ -142,7 +148,10 @@ void ProjectSelectionManager::AS_SetSelectionFormat(
    gPrefs->Write(wxT("/SelectionFormat"), format.Internal());
    gPrefs->Flush();
 
-   if (SnapSelection())
+   const bool snapped = SnapSelection();
+   if (!HasWindow())
+      return;
+   if (snapped)
       TrackPanel::Get( project ).Refresh(false);
 
    SelectionBar::Get( project ).SetSelectionFormat(format);
@@ -165,7 +174,8 @@ void ProjectSelectionManager::TT_SetAudioTimeFormat(
    gPrefs->Write(wxT("/AudioTimeFormat"), format.Internal());
    gPrefs->Flush();
 
-   TimeToolBar::Get( project ).SetAudioTimeFormat(format);
+   if (HasWindow())
+      TimeToolBar::Get( project ).SetAudioTimeFormat(format);
 }
 
 void ProjectSelectionManager::AS_ModifySelection(
@@ -173,10 +183,10 @@ void ProjectSelectionManager::AS_ModifySelection(
 {
    auto &project = mProject;
    auto &history = ProjectHistory::Get( project );
-   auto &trackPanel = TrackPanel::Get( project );
    auto &viewInfo = ViewInfo::Get( project );
    viewInfo.selectedRegion.setTimes(start, end);
-   trackPanel.Refresh(false);
+   if (HasWindow())
+      TrackPanel::Get( project ).Refresh(false);
    if (done) {
       history.ModifyState(false);
    }
@@ -212,7 +222,8 @@ void ProjectSelectionManager::SSBL_SetFrequencySelectionFormatName(
    gPrefs->Flush();
 
 #ifdef EXPERIMENTAL_SPECTRAL_EDITING
-   SpectralSelectionBar::Get( project ).SetFrequencySelectionFormatName(formatName);
+   if (HasWindow())
+      SpectralSelectionBar::Get( project ).SetFrequencySelectionFormatName(formatName);
 #endif
 }
 
@@ -237,7 +248,8 @@ void ProjectSelectionManager::SSBL_SetBandwidthSelectionFormatName(
    gPrefs->Flush();
 
 #ifdef EXPERIMENTAL_SPECTRAL_EDITING
-   SpectralSelectionBar::Get( project ).SetBandwidthSelectionFormatName(formatName);
+   if (HasWindow())
+      SpectralSelectionBar::Get( project ).SetBandwidthSelectionFormatName(formatName);
 #endif
 }
 
@@ -247,7 +259,6 @@ void ProjectSelectionManager::SSBL_ModifySpectralSelection(
 #ifdef EXPERIMENTAL_SPECTRAL_EDITING
    auto &project = mProject;
    auto &history = ProjectHistory::Get( project );
-   auto &trackPanel = TrackPanel::Get( project );
    auto &viewInfo = ViewInfo::Get( project );
 
    double nyq = SSBL_GetRate() / 2.0;
@@ -256,7 +267,8 @@ void ProjectSelectionManager::SSBL_ModifySpectralSelection(
    if (top >= 0.0)
       top = std::min(nyq, top);
    viewInfo.selectedRegion.setFrequencies(bottom, top);
-   trackPanel.Refresh(false);
+   if (HasWindow())
+      TrackPanel::Get( project ).Refresh(false);
    if (done) {
       history.ModifyState(false);
    }
@@ -62,6 +62,8 @@ public:
 
 private:
    bool SnapSelection();
+   //! Whether there are a track panel and toolbars to update
+   bool HasWindow() const;
 
    TenacityProject &mProject;
 };
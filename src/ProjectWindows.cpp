@@ -102,8 +102,9 @@ ProjectFramePlacement( TenacityProject *project )
 {
    if (!project)
       return std::make_unique<BasicUI::WindowPlacement>();
+   // The frame is missing in headless mode
    return std::make_unique<wxWidgetsWindowPlacement>(
-      &GetProjectFrame(*project));
+      FindProjectFrame(project));
 }
 
 void SetProjectFrame(TenacityProject &project, wxFrame &frame )
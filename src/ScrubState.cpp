@@ -11,10 +11,15 @@
 #include "ScrubState.h"
 #include "AudioIO.h"
 #include "Mix.h"
+#include "SampleTrackPrefetch.h"
 
 #include <cmath>
 
 namespace {
+//! Seconds of each track kept in memory around the cursor, when scrubbing
+constexpr double PrefetchDuration = 10.0;
+
+
 struct ScrubQueue : NonInterferingBase
 {
    static ScrubQueue Instance;
@@ -314,6 +319,7 @@ void ScrubbingPlaybackPolicy::Initialize( PlaybackSchedule &schedule,
 void ScrubbingPlaybackPolicy::Finalize(  PlaybackSchedule & )
 {
    ScrubQueue::Instance.Stop();
+   mPrefetch.reset();
 }
 
 Mixer::WarpOptions ScrubbingPlaybackPolicy::MixerWarpOptions(PlaybackSchedule &)
@@ -440,6 +446,26 @@ bool ScrubbingPlaybackPolicy::RepositionPlayback(
          else
             mScrubSpeed =
                double(diff) / mScrubDuration.as_double();
+         const bool byMouse =
+            !(mOptions.isPlayingAtSpeed || mOptions.isKeyboardScrubbing);
+         if (byMouse && !mPrefetch) {
+            // The mouse can jump anywhere, so keep the samples around it in
+            // memory, rather than wait on storage in the middle of a jump
+            SampleTrackConstArray tracks;
+            for (auto &pMixer : playbackMixers) {
+               const auto inputs = pMixer->GetInputTracks();
+               tracks.insert(tracks.end(), inputs.begin(), inputs.end());
+            }
+            mPrefetch =
+               std::make_shared<SampleTrackPrefetch>(tracks, PrefetchDuration);
+            for (auto &pMixer : playbackMixers)
+               pMixer->SetPrefetch(mPrefetch);
+         }
+         if (byMouse && mScrubDuration > 0)
+            // Guess that the cursor goes on as it did in this interval
+            mPrefetch->SetTarget(
+               endTime + (endTime - startTime), endTime < startTime);
+
          if (!mSilentScrub)
          {
             for (auto &pMixer : playbackMixers) {
@@ -448,7 +474,9 @@ bool ScrubbingPlaybackPolicy::RepositionPlayback(
                else if (mOptions.isKeyboardScrubbing)
                   pMixer->SetSpeedForKeyboardScrubbing(mScrubSpeed, startTime);
                else
-                  pMixer->SetTimesAndSpeed(
+                  // Play on from the last interval when it ends where this
+                  // begins, and crossfade when it doesn't
+                  pMixer->ContinueTimesAndSpeed(
                      startTime, endTime, fabs( mScrubSpeed ));
             }
          }
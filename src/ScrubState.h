@@ -14,6 +14,10 @@
 #include "PlaybackSchedule.h" // to inherit
 #include "SampleCount.h"
 
+#include <memory>
+
+class SampleTrackPrefetch;
+
 // For putting an increment of work in the scrubbing queue
 struct ScrubbingOptions {
    ScrubbingOptions() {}
@@ -85,6 +89,9 @@ private:
    bool mSilentScrub{ false };
    bool mReplenish{ false };
 
+   //! Samples around the cursor, for scrubbing with the mouse
+   std::shared_ptr<SampleTrackPrefetch> mPrefetch;
+
    const ScrubbingOptions mOptions;
 };
 
@@ -9,6 +9,7 @@ Paul Licameli -- split from SampleBlock.cpp and SampleBlock.h
 **********************************************************************/
 
 #include <cfloat>
+#include <mutex>
 #include <sqlite3.h>
 
 #include "DBConnection.h"
@@ -161,6 +162,12 @@ private:
 
    const std::shared_ptr<ConnectionPtr> mppConnection;
 
+   //! Lets threads that append to different tracks at once, such as the
+   //! channels of a recording, compute summaries in parallel, while the
+   //! blocks are written to the database one at a time; also guards
+   //! mAllBlocks
+   std::mutex mMutex;
+
    // Track all blocks that this factory has created, but don't control
    // their lifetimes (so use weak_ptr)
    // (Must also use weak pointers because the blocks have shared pointers
@@ -186,6 +193,7 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreate(
    auto sb = std::make_shared<SqliteSampleBlock>(shared_from_this());
    sb->SetSamples(src, numsamples, srcformat);
    // block id has now been assigned
+   std::lock_guard<std::mutex> lock{ mMutex };
    mAllBlocks[ sb->GetBlockID() ] = sb;
    return sb;
 }
@@ -193,6 +201,7 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreate(
 auto SqliteSampleBlockFactory::GetActiveBlockIDs() -> SampleBlockIDs
 {
    SampleBlockIDs result;
+   std::lock_guard<std::mutex> lock{ mMutex };
    for (auto end = mAllBlocks.end(), it = mAllBlocks.begin(); it != end;) {
       if (it->second.expired())
          // Tighten up the map
@@ -244,6 +253,7 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreateFromXML(
             sb = DoCreateSilent( -nValue, floatSample );
          }
          else {
+            std::lock_guard<std::mutex> lock{ mMutex };
             // First see if this block id was previously loaded
             auto &wb = mAllBlocks[ nValue ];
             auto pb = wb.lock();
@@ -713,6 +723,10 @@ void SqliteSampleBlock::Commit(Sizes sizes)
    auto db = DB();
    int rc;
 
+   // The summaries are already computed; only the writing is serial, and
+   // the id of the inserted row is that of this thread's insertion
+   std::lock_guard<std::mutex> lock{ mpFactory->mMutex };
+
    // Prepare and cache statement...automatically finalized at DB close
    sqlite3_stmt *stmt = Conn()->Prepare(DBConnection::InsertSampleBlock,
       "INSERT INTO sampleblocks (sampleformat, summin, summax, sumrms,"
@@ -770,6 +784,8 @@ void SqliteSampleBlock::Delete()
 
    wxASSERT(!IsSilent());
 
+   std::lock_guard<std::mutex> lock{ mpFactory->mMutex };
+
    // Prepare and cache statement...automatically finalized at DB close
    sqlite3_stmt *stmt = Conn()->Prepare(DBConnection::DeleteSampleBlock,
       "DELETE FROM sampleblocks WHERE blockid = ?1;");
@@ -73,7 +73,11 @@ It handles initialization and termination by subclassing wxApp.
 #include "TenacityFileConfig.h"
 #include "AudioIO.h"
 #include "Benchmark.h"
+#include "DSPBenchmark.h"
 #include "Clipboard.h"
+#include "HeadlessMode.h"
+#include "Journal.h"
+#include "JournalTiming.h"
 #include "commands/CommandHandler.h"
 #include "commands/AppCommandEvent.h"
 #include "widgets/ASlider.h"
@@ -125,6 +129,7 @@ It handles initialization and termination by subclassing wxApp.
 // Logo for Splash Screen
 #include "../images/TenacityLogoWithName.xpm"
 
+#include <optional>
 #include <thread>
 
 
@@ -318,7 +323,11 @@ static bool CloseAllProjects( bool force )
    {
       // Closing the project has global side-effect
       // of deletion from gTenacityProjects
-      if ( force )
+      if ( HeadlessMode::IsEnabled() )
+      {
+         ProjectManager::CloseHeadless( **AllProjects{}.begin() );
+      }
+      else if ( force )
       {
          GetProjectFrame( **AllProjects{}.begin() ).Close(true);
       }
@@ -357,7 +366,7 @@ static void QuitAudacity(bool bForce)
    else
 /*end+*/
    {
-      if (AllProjects{}.size())
+      if (AllProjects{}.size() && !HeadlessMode::IsEnabled())
          // PRL:  Always did at least once before close might be vetoed
          // though I don't know why that is important
          ProjectManager::SaveWindowSize();
@@ -547,6 +556,9 @@ BEGIN_EVENT_TABLE(TenacityApp, wxApp)
 
    // Global ESC key handling
    EVT_KEY_DOWN(TenacityApp::OnKeyDown)
+
+   // Replay of journals
+   EVT_IDLE(TenacityApp::OnIdle)
 END_EVENT_TABLE()
 
 // backend for OnMRUFile
@@ -637,10 +649,11 @@ void TenacityApp::OnTimer(wxTimerEvent& /* event */)
             if (name.empty()) {
                // Get the users attention
                if (auto project = GetActiveProject().lock()) {
-                  auto &window = GetProjectFrame( *project );
-                  window.Maximize();
-                  window.Raise();
-                  window.RequestUserAttention();
+                  if (auto pWindow = FindProjectFrame( project.get() )) {
+                     pWindow->Maximize();
+                     pWindow->Raise();
+                     pWindow->RequestUserAttention();
+                  }
                }
                continue;
             }
@@ -707,7 +720,8 @@ bool TenacityApp::OnExceptionInMainLoop()
             // Forget pending changes in the TrackList
             TrackList::Get( *pProject ).ClearPendingTracks();
 
-            ProjectWindow::Get( *pProject ).RedrawProject();
+            if (auto pWindow = ProjectWindow::Find( pProject.get() ))
+               pWindow->RedrawProject();
          }
 
          // Give the user an alert
@@ -743,6 +757,15 @@ TenacityApp::~TenacityApp()
 {
 }
 
+// Look for --headless before the command line parser exists
+static bool HasHeadlessSwitch(int argc, const wxCmdLineArgsArray &argv)
+{
+   for (int i = 1; i < argc; ++i)
+      if (argv[i] == wxT("--headless"))
+         return true;
+   return false;
+}
+
 // The `main program' equivalent, creating the windows and returning the
 // main frame
 bool TenacityApp::OnInit()
@@ -760,7 +783,12 @@ bool TenacityApp::OnInit()
    // Ensure we have an event loop during initialization
    wxEventLoopGuarantor eventLoop;
 
-   // Inject basic GUI services behind the facade
+   // Inject basic GUI services behind the facade.  The command line is not
+   // parsed yet (see InitPart2), but headless mode must be known before
+   // anything can show a dialog.
+   if (HasHeadlessSwitch(argc, argv))
+      HeadlessMode::Enable();
+   else
    {
       static wxWidgetsBasicUI uiServices;
       (void)BasicUI::Install(&uiServices);
@@ -990,10 +1018,14 @@ bool TenacityApp::OnInit()
    this->AssociateFileTypes();
 #endif
 
-   theTheme.EnsureInitialised();
+   // Nothing is drawn in headless mode
+   if (!HeadlessMode::IsEnabled())
+   {
+      theTheme.EnsureInitialised();
 
-   // AColor depends on theTheme.
-   AColor::Init();
+      // AColor depends on theTheme.
+      AColor::Init();
+   }
 
    // If this fails, we must exit the program.
    if (!InitTempDir()) {
@@ -1064,6 +1096,14 @@ bool TenacityApp::InitPart2()
       Sequence::SetMaxDiskBlockSize(lval);
    }
 
+   {
+      wxString fileName;
+      if (parser->Found(wxT("j"), &fileName))
+         Journal::SetInputFileName( fileName );
+      if (parser->Found(wxT("journal-timing"), &fileName))
+         Journal::Timing::SetReportFileName( fileName );
+   }
+
    // Make sure the temp dir isn't locked by another process.
    {
       auto key =
@@ -1090,52 +1130,58 @@ bool TenacityApp::InitPart2()
    PluginManager::Get().Initialize( [](const FilePath &localFileName){
       return TenacityFileConfig::Create({}, {}, localFileName); } );
 
-   // BG: Create a temporary window to set as the top window
-   wxImage logoimage((const char **)TenacityLogoWithName_xpm);
-   logoimage.Rescale(logoimage.GetWidth() / 2, logoimage.GetHeight() / 2);
-   if( GetLayoutDirection() == wxLayout_RightToLeft)
-      logoimage = logoimage.Mirror();
-   wxBitmap logo(logoimage);
+   const bool headless = HeadlessMode::IsEnabled();
 
    TenacityProject *project;
    {
-      // Bug 718: Position splash screen on same screen
-      // as where Audacity project will appear.
-      wxRect wndRect;
-      bool bMaximized = false;
-      bool bIconized = false;
-      GetNextWindowPlacement(&wndRect, &bMaximized, &bIconized);
-
-      wxSplashScreen temporarywindow(
-         logo,
-         wxSPLASH_CENTRE_ON_SCREEN | wxSPLASH_NO_TIMEOUT,
-         0,
-         NULL,
-         wxID_ANY,
-         wndRect.GetTopLeft(),
-         wxDefaultSize,
-         wxSTAY_ON_TOP);
-
-      // Unfortunately with the Windows 10 Creators update, the splash screen
-      // now appears before setting its position.
-      // On a dual monitor screen it will appear on one screen and then
-      // possibly jump to the second.
-      // We could fix this by writing our own splash screen and using Hide()
-      // until the splash scren was correctly positioned, then Show()
-
-      // Possibly move it on to the second screen...
-      temporarywindow.SetPosition( wndRect.GetTopLeft() );
-      // Centered on whichever screen it is on.
-      temporarywindow.Center();
-      temporarywindow.SetTitle(_("Tenacity is starting up..."));
-      SetTopWindow(&temporarywindow);
-      temporarywindow.Show();
-      temporarywindow.Raise();
-
-
-      // ANSWER-ME: Why is YieldFor needed at all?
-      //wxEventLoopBase::GetActive()->YieldFor(wxEVT_CATEGORY_UI|wxEVT_CATEGORY_USER_INPUT|wxEVT_CATEGORY_UNKNOWN);
-      wxEventLoopBase::GetActive()->YieldFor(wxEVT_CATEGORY_UI);
+      // BG: Create a temporary window to set as the top window
+      std::optional<wxSplashScreen> temporarywindow;
+      if (!headless)
+      {
+         wxImage logoimage((const char **)TenacityLogoWithName_xpm);
+         logoimage.Rescale(logoimage.GetWidth() / 2, logoimage.GetHeight() / 2);
+         if( GetLayoutDirection() == wxLayout_RightToLeft)
+            logoimage = logoimage.Mirror();
+         wxBitmap logo(logoimage);
+
+         // Bug 718: Position splash screen on same screen
+         // as where Audacity project will appear.
+         wxRect wndRect;
+         bool bMaximized = false;
+         bool bIconized = false;
+         GetNextWindowPlacement(&wndRect, &bMaximized, &bIconized);
+
+         temporarywindow.emplace(
+            logo,
+            wxSPLASH_CENTRE_ON_SCREEN | wxSPLASH_NO_TIMEOUT,
+            0,
+            nullptr,
+            wxID_ANY,
+            wndRect.GetTopLeft(),
+            wxDefaultSize,
+            wxSTAY_ON_TOP);
+
+         // Unfortunately with the Windows 10 Creators update, the splash screen
+         // now appears before setting its position.
+         // On a dual monitor screen it will appear on one screen and then
+         // possibly jump to the second.
+         // We could fix this by writing our own splash screen and using Hide()
+         // until the splash scren was correctly positioned, then Show()
+
+         // Possibly move it on to the second screen...
+         temporarywindow->SetPosition( wndRect.GetTopLeft() );
+         // Centered on whichever screen it is on.
+         temporarywindow->Center();
+         temporarywindow->SetTitle(_("Tenacity is starting up..."));
+         SetTopWindow(&*temporarywindow);
+         temporarywindow->Show();
+         temporarywindow->Raise();
+
+
+         // ANSWER-ME: Why is YieldFor needed at all?
+         //wxEventLoopBase::GetActive()->YieldFor(wxEVT_CATEGORY_UI|wxEVT_CATEGORY_USER_INPUT|wxEVT_CATEGORY_UNKNOWN);
+         wxEventLoopBase::GetActive()->YieldFor(wxEVT_CATEGORY_UI);
+      }
 
       //JKC: Would like to put module loading here.
 
@@ -1166,30 +1212,33 @@ bool TenacityApp::InitPart2()
 
       // On the Mac, users don't expect a program to quit when you close the last window.
       // Create a menubar that will show when all project windows are closed.
+      if (!headless)
+      {
+         auto fileMenu = std::make_unique<wxMenu>();
+         auto urecentMenu = std::make_unique<wxMenu>();
+         auto recentMenu = urecentMenu.get();
+         fileMenu->Append(wxID_NEW, wxString(_("&New")) + wxT("\tCtrl+N"));
+         fileMenu->Append(wxID_OPEN, wxString(_("&Open...")) + wxT("\tCtrl+O"));
+         fileMenu->AppendSubMenu(urecentMenu.release(), _("Open &Recent..."));
+         fileMenu->Append(wxID_ABOUT, _("&About Tenacity..."));
+         fileMenu->Append(wxID_PREFERENCES, wxString(_("&Preferences...")) + wxT("\tCtrl+,"));
 
-      auto fileMenu = std::make_unique<wxMenu>();
-      auto urecentMenu = std::make_unique<wxMenu>();
-      auto recentMenu = urecentMenu.get();
-      fileMenu->Append(wxID_NEW, wxString(_("&New")) + wxT("\tCtrl+N"));
-      fileMenu->Append(wxID_OPEN, wxString(_("&Open...")) + wxT("\tCtrl+O"));
-      fileMenu->AppendSubMenu(urecentMenu.release(), _("Open &Recent..."));
-      fileMenu->Append(wxID_ABOUT, _("&About Tenacity..."));
-      fileMenu->Append(wxID_PREFERENCES, wxString(_("&Preferences...")) + wxT("\tCtrl+,"));
+         {
+            auto menuBar = std::make_unique<wxMenuBar>();
+            menuBar->Append(fileMenu.release(), _("&File"));
 
-      {
-         auto menuBar = std::make_unique<wxMenuBar>();
-         menuBar->Append(fileMenu.release(), _("&File"));
+            // PRL:  Are we sure wxWindows will not leak this menuBar?
+            // The online documentation is not explicit.
+            wxMenuBar::MacSetCommonMenuBar(menuBar.release());
+         }
 
-         // PRL:  Are we sure wxWindows will not leak this menuBar?
-         // The online documentation is not explicit.
-         wxMenuBar::MacSetCommonMenuBar(menuBar.release());
+         auto &recentFiles = FileHistory::Global();
+         recentFiles.UseMenu(recentMenu);
       }
 
-      auto &recentFiles = FileHistory::Global();
-      recentFiles.UseMenu(recentMenu);
-
 #endif //__WXMAC__
-      temporarywindow.Show(false);
+      if (temporarywindow)
+         temporarywindow->Show(false);
    }
 
    // Workaround Bug 1377 - Crash after Audacity starts and low disk space warning appears
@@ -1201,10 +1250,12 @@ bool TenacityApp::InitPart2()
    // Root cause is problem with wxSplashScreen and other dialogs co-existing, that
    // seemed to arrive with wx3.
    {
-      project = ProjectManager::New();
+      project = headless
+         ? ProjectManager::NewHeadless()
+         : ProjectManager::New();
    }
 
-   if( ProjectSettings::Get( *project ).GetShowSplashScreen() ){
+   if( !headless && ProjectSettings::Get( *project ).GetShowSplashScreen() ){
       SplashDialog::DoHelpWelcome(*project);
    }
 
@@ -1214,44 +1265,64 @@ bool TenacityApp::InitPart2()
 
    Importer::Get().Initialize();
 
-   // Bug1561: delay the recovery dialog, to avoid crashes.
-   CallAfter( [=] () mutable {
-      // Remove duplicate shortcuts when there's a change of version
-      int vMajorInit, vMinorInit, vMicroInit;
-      gPrefs->GetVersionKeysInit(vMajorInit, vMinorInit, vMicroInit);
-      if (vMajorInit != TENACITY_VERSION || vMinorInit != TENACITY_RELEASE
-         || vMicroInit != TENACITY_REVISION) {
-         CommandManager::Get(*project).RemoveDuplicateShortcuts();
-      }
-      //
-      // Auto-recovery
-      //
-      bool didRecoverAnything = false;
-      // This call may reassign project (passed by reference)
-      if (!ShowAutoRecoveryDialogIfNeeded(project, &didRecoverAnything))
-      {
-         QuitAudacity(true);
-      }
+   // Start replay of a journal given on the command line, which happens in
+   // idle time; the exit code will report a failure
+   if (!Journal::Begin( FileNames::DataDir() ))
+      CallAfter( []{ QuitAudacity(true); } );
 
-      //
-      // Remainder of command line parsing, but only if we didn't recover
-      //
-      if (project && !didRecoverAnything)
-      {
-         if (parser->Found(wxT("t")))
+   // Bug1561: delay the recovery dialog, to avoid crashes.
+   // In headless mode there are no shortcuts, nobody to answer the recovery
+   // dialog, and files are imported by scripting commands instead.
+   if (!headless) {
+      CallAfter( [=] () mutable {
+         // Remove duplicate shortcuts when there's a change of version
+         int vMajorInit, vMinorInit, vMicroInit;
+         gPrefs->GetVersionKeysInit(vMajorInit, vMinorInit, vMicroInit);
+         if (vMajorInit != TENACITY_VERSION || vMinorInit != TENACITY_RELEASE
+            || vMicroInit != TENACITY_REVISION) {
+            CommandManager::Get(*project).RemoveDuplicateShortcuts();
+         }
+         //
+         // Auto-recovery
+         //
+         bool didRecoverAnything = false;
+         // This call may reassign project (passed by reference)
+         if (!ShowAutoRecoveryDialogIfNeeded(project, &didRecoverAnything))
          {
-            RunBenchmark( nullptr, *project);
             QuitAudacity(true);
          }
 
-         for (size_t i = 0, cnt = parser->GetParamCount(); i < cnt; i++)
+         //
+         // Remainder of command line parsing, but only if we didn't recover
+         //
+         if (project && !didRecoverAnything)
          {
-            // PRL: Catch any exceptions, don't try this file again, continue to
-            // other files.
-            SafeMRUOpen(parser->GetParam(i));
+            if (parser->Found(wxT("t")))
+            {
+               RunBenchmark( nullptr, *project);
+               QuitAudacity(true);
+            }
+
+            for (size_t i = 0, cnt = parser->GetParamCount(); i < cnt; i++)
+            {
+               // PRL: Catch any exceptions, don't try this file again, continue to
+               // other files.
+               SafeMRUOpen(parser->GetParam(i));
+            }
          }
-      }
-   } );
+      } );
+   }
+
+   // Benchmark, then quit, also in headless mode
+   wxString benchmarkPath;
+   if (parser->Found(wxT("dsp-benchmark"), &benchmarkPath))
+      CallAfter( [=] {
+         // Recovery may have replaced the first project
+         auto pProject = GetActiveProject().lock();
+         if (!pProject || !RunDSPBenchmark( *pProject, benchmarkPath ))
+            mExitCode = 1;
+         QuitAudacity(true);
+      } );
 
    gInited = true;
 
@@ -1876,6 +1947,27 @@ std::unique_ptr<wxCmdLineParser> TenacityApp::ParseCommandLine()
    parser->AddSwitch(wxT("h"), wxT("help"), _("this help message"),
                      wxCMD_LINE_OPTION_HELP);
 
+   /*i18n-hint: This replays a recording of user actions */
+   parser->AddOption(wxT("j"), wxT("journal"), _("replay a journal file"),
+                     wxCMD_LINE_VAL_STRING);
+
+   /*i18n-hint: This times each action of a replayed journal and writes the
+    *           results to a file */
+   parser->AddOption(wxEmptyString, wxT("journal-timing"),
+                     _("time each step of the replayed journal, writing JSON results to a file"),
+                     wxCMD_LINE_VAL_STRING);
+
+   /*i18n-hint: This runs Tenacity as a scripting server that never opens
+    *           any windows */
+   parser->AddSwitch(wxEmptyString, wxT("headless"),
+                     _("serve scripting commands without windows"));
+
+   /*i18n-hint: This times the audio processing code and writes the results
+    *           to a file */
+   parser->AddOption(wxEmptyString, wxT("dsp-benchmark"),
+                     _("time audio processing, writing JSON results to a file"),
+                     wxCMD_LINE_VAL_STRING);
+
    /*i18n-hint: This runs a set of automatic tests on Audacity itself */
    parser->AddSwitch(wxT("t"), wxT("test"), _("run self diagnostics"));
 
@@ -1928,6 +2020,51 @@ void TenacityApp::OnEndSession(wxCloseEvent & event)
    }
 }
 
+int TenacityApp::OnRun()
+{
+   const auto result = wxApp::OnRun();
+
+   if (!Journal::Timing::WriteReport())
+      wxPrintf(_("Could not write the journal timing report\n"));
+
+   // Nonzero if a journal was replayed and failed
+   if (const auto code = Journal::GetExitCode())
+      return code;
+   if (mExitCode)
+      return mExitCode;
+   return result;
+}
+
+void TenacityApp::OnIdle( wxIdleEvent &evt )
+{
+   evt.Skip();
+   try {
+      if ( Journal::Dispatch() )
+         evt.RequestMore();
+   }
+   catch( ... ) {
+      // wxWidgets doesn't guard calls to the idle handler as for other
+      // events, so do what it would do
+      if (!OnExceptionInMainLoop())
+         ExitMainLoop();
+   }
+}
+
+void TenacityApp::CallEventHandler( wxEvtHandler *handler,
+   wxEventFunctor &functor, wxEvent &event ) const
+{
+   // When timing journal replay, measure painting and idle time
+   std::optional<Journal::Timing::Scope> scope;
+   if (Journal::Timing::IsEnabled()) {
+      const auto type = event.GetEventType();
+      if (type == wxEVT_PAINT)
+         scope.emplace( Journal::Timing::Category::Paint );
+      else if (type == wxEVT_IDLE)
+         scope.emplace( Journal::Timing::Category::Idle );
+   }
+   wxApp::CallEventHandler( handler, functor, event );
+}
+
 int TenacityApp::OnExit()
 {
    gIsQuitting = true;
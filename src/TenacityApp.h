@@ -23,6 +23,7 @@
 
 #include <memory>
 
+class wxIdleEvent;
 class wxSingleInstanceChecker;
 class wxSocketEvent;
 class wxSocketServer;
@@ -39,10 +40,14 @@ class TenacityApp final : public wxApp {
    ~TenacityApp();
    bool OnInit(void) override;
    bool InitPart2();
+   int OnRun() override;
    int OnExit(void) override;
    void OnFatalException() override;
    bool OnExceptionInMainLoop() override;
 
+   void CallEventHandler( wxEvtHandler *handler,
+      wxEventFunctor &functor, wxEvent &event ) const override;
+
    // These are currently only used on Mac OS, where it's
    // possible to have a menu bar but no windows open.  It doesn't
    // hurt any other platforms, though.
@@ -67,6 +72,9 @@ class TenacityApp final : public wxApp {
 
    void OnKeyDown(wxKeyEvent &event);
 
+   // Dispatches the next step of a journal being replayed
+   void OnIdle(wxIdleEvent &event);
+
    void OnTimer(wxTimerEvent & event);
 
    // IPC communication
@@ -99,6 +107,9 @@ class TenacityApp final : public wxApp {
 
    wxTimer mTimer;
 
+   //! Nonzero if the --dsp-benchmark run failed
+   int mExitCode{ 0 };
+
    void InitCommandHandler();
 
    bool InitTempDir();
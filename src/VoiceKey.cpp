@@ -22,6 +22,7 @@ or "OFF" point
 #include "VoiceKey.h"
 
 #include <wx/string.h>
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 
@@ -29,6 +30,9 @@ or "OFF" point
 #include <wx/intl.h>
 #include <iostream>
 
+// Tenacity libraries
+#include <lib-math/SignalFeatures.h>
+
 #include "WaveTrack.h"
 #include "widgets/AudacityMessageBox.h"
 #include "widgets/wxPanelWrapper.h"
@@ -36,6 +40,8 @@ or "OFF" point
 using std::cout;
 using std::endl;
 
+//Samples read at once, ahead of a search
+static constexpr size_t ChunkSize = 1 << 16;
 
 
 VoiceKey::VoiceKey()
@@ -146,11 +152,10 @@ sampleCount VoiceKey::OnForward (
          //the first window + 1 samples--but we need another window samples to draw from.
          size_t remaining = 2*WindowSizeInt+1;
 
-         //To speed things up, create a local buffer to store things in, to avoid the costly t.Get();
+         //These samples are usually still kept from the block scan.
          //Only go through the first SignalWindowSizeInt samples, and choose the first that trips the key.
-         Floats buffer{ remaining };
-         t.GetFloats(buffer.get(),
-               lastsubthresholdsample, remaining);
+         const auto buffer =
+            GetSamples(t, lastsubthresholdsample, remaining, false);
 
 
 
@@ -160,19 +165,11 @@ sampleCount VoiceKey::OnForward (
          int ztrend = sgn(buffer[WindowSizeInt+1]-buffer[WindowSizeInt]);
 
 
-         double erg=0;
-         double  sc=0;
-         double  dc=0;
-
-         //Get initial test statistic values.
-         if(mUseEnergy)
-            erg = TestEnergy(t, lastsubthresholdsample, WindowSizeInt);
-
-         if(mUseSignChangesLow || mUseSignChangesHigh)
-            sc  = TestSignChanges(t,lastsubthresholdsample, WindowSizeInt);
-
-         if(mUseDirectionChangesLow || mUseDirectionChangesHigh)
-            dc  = TestDirectionChanges(t,lastsubthresholdsample,WindowSizeInt);
+         //Get initial test statistic values, from the first window of the buffer.
+         const auto statistics = TestStatistics(buffer, WindowSizeInt);
+         double erg = statistics.energy;
+         double  sc = statistics.signChanges;
+         double  dc = statistics.directionChanges;
 
 
          //Now, go through the sound again, sample by sample.
@@ -273,7 +270,7 @@ sampleCount VoiceKey::OnBackward (
 
 
          //Test whether we are above threshold
-         if(AboveThreshold(t,i,blocksize))
+         if(AboveThreshold(t,i,blocksize,true))
             {
                blockruns++;                   //Hit
             }
@@ -296,11 +293,11 @@ sampleCount VoiceKey::OnBackward (
          //the first window + 1 samples--but we need another window samples to draw from.
          size_t remaining = 2*WindowSizeInt+1;
 
-         //To speed things up, create a local buffer to store things in, to avoid the costly t.Get();
+         //These samples are usually still kept from the block scan.  Take another
+         //window past them, which the statistics and their updates look at.
          //Only go through the first mSilentWindowSizeInt samples, and choose the first that trips the key.
-         Floats buffer{ remaining };
-         t.GetFloats(buffer.get(),
-               lastsubthresholdsample - remaining, remaining);
+         const auto buffer = GetSamples(t, lastsubthresholdsample - remaining,
+                                        remaining + WindowSizeInt + 1, true);
 
          //Initialize these trend markers atrend and ztrend.  They keep track of the
          //up/down trends at the start and end of the evaluation window.
@@ -315,17 +312,11 @@ sampleCount VoiceKey::OnBackward (
                                   - 1
                            ]);
 
-         double erg=0;
-         double sc = 0;
-         double dc = 0;
-
-         //Get initial test statistic values.
-         if(mUseEnergy)
-            erg = TestEnergy(t, lastsubthresholdsample, WindowSizeInt);
-         if(mUseSignChangesLow || mUseSignChangesHigh)
-            sc  = TestSignChanges(t,lastsubthresholdsample, WindowSizeInt);
-         if(mUseDirectionChangesLow || mUseDirectionChangesHigh)
-            dc  = TestDirectionChanges(t,lastsubthresholdsample,WindowSizeInt);
+         //Get initial test statistic values, from the window past the end.
+         const auto statistics = TestStatistics(buffer + remaining, WindowSizeInt);
+         double erg = statistics.energy;
+         double sc = statistics.signChanges;
+         double dc = statistics.directionChanges;
 
          //Now, go through the sound again, sample by sample.
          size_t i;
@@ -439,11 +430,10 @@ sampleCount VoiceKey::OffForward (
          //the first window + 1 samples--but we need another window samples to draw from.
          size_t remaining = 2*WindowSizeInt+1;
 
-         //To speed things up, create a local buffer to store things in, to avoid the costly t.Get();
+         //These samples are usually still kept from the block scan.
          //Only go through the first SilentWindowSizeInt samples, and choose the first that trips the key.
-         Floats buffer{ remaining };
-         t.GetFloats(buffer.get(),
-               lastsubthresholdsample, remaining);
+         const auto buffer =
+            GetSamples(t, lastsubthresholdsample, remaining, false);
 
          //Initialize these trend markers atrend and ztrend.  They keep track of the
          //up/down trends at the start and end of the evaluation window.
@@ -451,17 +441,11 @@ sampleCount VoiceKey::OffForward (
          int ztrend = sgn(buffer[WindowSizeInt+1]-buffer[WindowSizeInt]);
 
 
-         double erg=0;
-         double sc=0;
-         double dc=0;
-
-         //Get initial test statistic values.
-         if(mUseEnergy)
-            erg = TestEnergy(t, lastsubthresholdsample, WindowSizeInt);
-         if(mUseSignChangesLow || mUseSignChangesHigh)
-            sc  = TestSignChanges(t,lastsubthresholdsample, WindowSizeInt);
-         if(mUseDirectionChangesLow || mUseDirectionChangesHigh)
-            dc  = TestDirectionChanges(t,lastsubthresholdsample,WindowSizeInt);
+         //Get initial test statistic values, from the first window of the buffer.
+         const auto statistics = TestStatistics(buffer, WindowSizeInt);
+         double erg = statistics.energy;
+         double sc = statistics.signChanges;
+         double dc = statistics.directionChanges;
 
          //Now, go through the sound again, sample by sample.
          size_t i;
@@ -551,7 +535,7 @@ sampleCount VoiceKey::OffBackward (
          //Set blocksize so that it is the right size
          const auto blocksize = limitSampleBufferSize( WindowSizeInt, samplesleft);
 
-         if(!AboveThreshold(t,i,blocksize))
+         if(!AboveThreshold(t,i,blocksize,true))
             {
 
                blockruns++;                   //Hit
@@ -576,11 +560,11 @@ sampleCount VoiceKey::OffBackward (
          //the first window + 1 samples--but we need another window samples to draw from.
          const size_t remaining = 2*WindowSizeInt+1;
 
-         //To speed things up, create a local buffer to store things in, to avoid the costly t.Get();
+         //These samples are usually still kept from the block scan.  Take another
+         //window past them, which the statistics and their updates look at.
          //Only go through the first SilentWindowSizeInt samples, and choose the first that trips the key.
-         Floats buffer{ remaining };
-         t.GetFloats(buffer.get(),
-               lastsubthresholdsample - remaining, remaining);
+         const auto buffer = GetSamples(t, lastsubthresholdsample - remaining,
+                                        remaining + WindowSizeInt + 1, true);
 
          //Initialize these trend markers atrend and ztrend.  They keep track of the
          //up/down trends at the start and end of the remaining window.
@@ -589,16 +573,11 @@ sampleCount VoiceKey::OffBackward (
             sgn(buffer[remaining - WindowSizeInt - 2] -
                 buffer[remaining - WindowSizeInt - 2]);
 
-         double erg=0;
-         double  sc=0;
-         double  dc=0;
-         //Get initial test statistic values.
-         if(mUseEnergy)
-            erg = TestEnergy(t, lastsubthresholdsample, WindowSizeInt);
-         if(mUseSignChangesLow || mUseSignChangesHigh)
-            sc  = TestSignChanges(t,lastsubthresholdsample, WindowSizeInt);
-         if(mUseDirectionChangesLow || mUseDirectionChangesHigh)
-            dc  = TestDirectionChanges(t,lastsubthresholdsample,WindowSizeInt);
+         //Get initial test statistic values, from the window past the end.
+         const auto statistics = TestStatistics(buffer + remaining, WindowSizeInt);
+         double erg = statistics.energy;
+         double  sc = statistics.signChanges;
+         double  dc = statistics.directionChanges;
 
          //Now, go through the sound again, sample by sample.
          size_t i;
@@ -658,20 +637,21 @@ sampleCount VoiceKey::OffBackward (
 
 //This tests whether a specified block region is above or below threshold.
 bool VoiceKey::AboveThreshold(
-   const WaveTrack & t, sampleCount start, sampleCount len)
+   const WaveTrack & t, sampleCount start, sampleCount len, bool backwards)
 {
 
-   double erg=0;
-   double  sc=0;
-   double  dc=0;   //These store three statistics: energy, signchanges, and directionchanges
+   //Calculate the test statistics: energy, signchanges, and directionchanges
+   const auto statistics = TestStatistics(
+      GetSamples(t, start, len.as_size_t(), backwards), len.as_size_t());
+   const double erg = statistics.energy;
+   const double  sc = statistics.signChanges;
+   const double  dc = statistics.directionChanges;
    int tests =0;   //Keeps track of how many statistics surpass the threshold.
    int testThreshold=0;  //Keeps track of the threshold.
 
-   //Calculate the test statistics
    if(mUseEnergy)
       {
          testThreshold++;
-         erg = TestEnergy(t, start,len);
          tests +=(int)(erg > mThresholdEnergy);
 #if 0
          std::cout << "Energy: " << erg << " " <<mThresholdEnergy << std::endl;
@@ -681,7 +661,6 @@ bool VoiceKey::AboveThreshold(
    if(mUseSignChangesLow)
       {
          testThreshold++;
-         sc  = TestSignChanges(t,start,len);
          tests += (int)(sc < mThresholdSignChangesLower);
 #if 0
          std::cout << "SignChanges: " << sc << " " <<mThresholdSignChangesLower<< " < " << mThresholdSignChangesUpper << std::endl;
@@ -691,7 +670,6 @@ bool VoiceKey::AboveThreshold(
    if(mUseSignChangesHigh)
       {
          testThreshold++;
-         sc  = TestSignChanges(t,start,len);
          tests += (int)(sc > mThresholdSignChangesUpper);
 #if 0
          std::cout << "SignChanges: " << sc << " " <<mThresholdSignChangesLower<< " < " << mThresholdSignChangesUpper << std::endl;
@@ -703,7 +681,6 @@ bool VoiceKey::AboveThreshold(
    if(mUseDirectionChangesLow)
       {
          testThreshold++;
-         dc  = TestDirectionChanges(t,start,len);
          tests += (int)(dc < mThresholdDirectionChangesLower);
 #if 0
          std::cout << "DirectionChanges: " << dc << " " <<mThresholdDirectionChangesLower<< " < " << mThresholdDirectionChangesUpper << std::endl;
@@ -712,7 +689,6 @@ bool VoiceKey::AboveThreshold(
    if(mUseDirectionChangesHigh)
       {
          testThreshold++;
-         dc  = TestDirectionChanges(t,start,len);
          tests += (int)(dc > mThresholdDirectionChangesUpper);
 #if 0
          std::cout << "DirectionChanges: " << dc << " " <<mThresholdDirectionChangesLower<< " < " << mThresholdDirectionChangesUpper << std::endl;
@@ -752,7 +728,6 @@ void VoiceKey::CalibrateNoise(const WaveTrack & t, sampleCount start, sampleCoun
    double sumerg, sumerg2;
    double sumsc, sumsc2;
    double sumdc, sumdc2;
-   double erg, sc, dc;
    //Now, change the millisecond-based parameters into sample-based parameters
    //(This depends on WaveTrack t)
    double rate = t.GetRate();
@@ -760,20 +735,9 @@ void VoiceKey::CalibrateNoise(const WaveTrack & t, sampleCount start, sampleCoun
    //   unsigned int SignalWindowSizeInt = (unsigned int)(rate  * mSignalWindowSize);
 
 
-   //Get the first test statistics
-
    //Calibrate all of the statistic, because they might be
    //changed later.
 
-   //   if(mUseEnergy)
-   erg = TestEnergy(t, start, WindowSizeInt);
-
-   //   if(mUseSignChanges)
-   sc = TestSignChanges(t,start, WindowSizeInt);
-
-   //   if(mUseDirectionChanges)
-   dc = TestDirectionChanges(t,start,WindowSizeInt);
-
    sumerg =0.0;
    sumerg2 = 0.0;
    sumsc =0.0;
@@ -795,16 +759,19 @@ void VoiceKey::CalibrateNoise(const WaveTrack & t, sampleCount start, sampleCoun
          samples++;          //Increment the number of samples we have
          const auto blocksize = limitSampleBufferSize( WindowSizeInt, samplesleft);
 
-         erg = TestEnergy(t, i, blocksize);
+         const auto statistics =
+            TestStatistics(GetSamples(t, i, blocksize, false), blocksize);
+
+         const double erg = statistics.energy;
          sumerg +=(double)erg;
          sumerg2 += pow((double)erg,2);
 
-         sc = TestSignChanges(t,i, blocksize);
+         const double sc = statistics.signChanges;
          sumsc += (double)sc;
          sumsc2 += pow((double)sc,2);
 
 
-         dc = TestDirectionChanges(t,i,blocksize);
+         const double dc = statistics.directionChanges;
          sumdc += (double)dc;
          sumdc2 += pow((double)dc,2);
       }
@@ -853,36 +820,66 @@ void VoiceKey::SetKeyType(bool erg, bool scLow , bool scHigh,
 }
 
 
-//This might continue over a number of blocks.
-double VoiceKey::TestEnergy (
-   const WaveTrack & t, sampleCount start, sampleCount len)
+void VoiceKey::Forget()
 {
+   mWindow.track = mSpare.track = nullptr;
+}
 
-   double sum = 1;
-   auto s = start;                                //Keep track of start
-   auto originalLen = len;                        //Keep track of the length of block to process (its not the length of t)
-   const auto blockSize = limitSampleBufferSize(
-      t.GetMaxBlockSize(), len);               //Determine size of sampling buffer
-   Floats buffer{ blockSize };       //Get a sampling buffer
 
-   while(len > 0)
-   {
-      //Figure out how much to grab
-      auto block = limitSampleBufferSize ( t.GetBestBlockSize(s), len );
+const float *VoiceKey::GetSamples(
+   const WaveTrack & t, sampleCount start, size_t len, bool backwards)
+{
+   const auto end = start + len;
+   if (mWindow.track == &t && start >= mWindow.start &&
+       end <= mWindow.start + mWindow.samples.size())
+      return mWindow.samples.data() + (start - mWindow.start).as_size_t();
+
+   //Read a chunk ahead in the direction of the search, keeping what the
+   //old window holds of it.
+   const auto size = std::max(len, ChunkSize);
+   const auto newStart = backwards ? end - size : start;
+   const auto newEnd = newStart + size;
+   auto &window = mSpare;
+   window.track = nullptr;
+   window.start = newStart;
+   window.samples.resize(size);
+
+   auto overlapStart = newEnd, overlapEnd = newEnd;
+   if (mWindow.track == &t) {
+      overlapStart = std::max(newStart, mWindow.start);
+      overlapEnd = std::min(newEnd, mWindow.start + mWindow.samples.size());
+      if (overlapEnd > overlapStart)
+         std::copy_n(
+            mWindow.samples.data() + (overlapStart - mWindow.start).as_size_t(),
+            (overlapEnd - overlapStart).as_size_t(),
+            window.samples.data() + (overlapStart - newStart).as_size_t());
+      else
+         overlapStart = overlapEnd = newEnd;
+   }
 
-      t.GetFloats(buffer.get(), s,block);                      //grab the block;
+   if (overlapStart > newStart)
+      t.GetFloats(window.samples.data(), newStart,
+         (overlapStart - newStart).as_size_t());
+   if (newEnd > overlapEnd)
+      t.GetFloats(window.samples.data() + (overlapEnd - newStart).as_size_t(),
+         overlapEnd, (newEnd - overlapEnd).as_size_t());
 
-      //Now, go through the block and calculate energy
-      for(decltype(block) i = 0; i< block; i++)
-      {
-         sum += static_cast<double>(buffer[i]) * buffer[i];
-      }
+   window.track = &t;
+   std::swap(mWindow, mSpare);
+   return mWindow.samples.data() + (start - newStart).as_size_t();
+}
 
-      len -= block;
-      s += block;
-   }
 
-   return sum / originalLen.as_double();
+//The statistics are fractions of the length of the block, and each sum
+//begins at one.
+auto VoiceKey::TestStatistics(const float *buffer, size_t len) -> Statistics
+{
+   const auto features = SignalFeatures::Measure(buffer, len);
+   return {
+      (1 + features.sumSquares) / len,
+      (1 + features.signChanges) / double(len),
+      (1 + features.directionChanges) / double(len),
+   };
 }
 
 
@@ -895,49 +892,6 @@ void VoiceKey::TestEnergyUpdate (double & prevErg, int len, const float & drop,
 }
 
 
-double VoiceKey::TestSignChanges(
-   const WaveTrack & t, sampleCount start, sampleCount len)
-{
-
-
-   auto s = start;                                //Keep track of start
-   auto originalLen = len;                        //Keep track of the length of block to process (its not the length of t)
-   const auto blockSize = limitSampleBufferSize(
-      t.GetMaxBlockSize(), len);               //Determine size of sampling buffer
-   unsigned long signchanges = 1;
-   int currentsign=0;
-
-   Floats buffer{ blockSize };       //Get a sampling buffer
-
-   while(len > 0) {
-      //Figure out how much to grab
-      auto block = limitSampleBufferSize ( t.GetBestBlockSize(s), len );
-
-      t.GetFloats(buffer.get(), s, block);                      //grab the block;
-
-      if  (len == originalLen)
-         {
-            //The first time through, set stuff up special.
-            currentsign = sgn(buffer[0]);
-         }
-
-      //Now, go through the block and calculate zero crossings
-
-      for(decltype(block) i = 0; i< block; i++)
-         {
-            if( sgn(buffer[i]) != currentsign)
-               {
-                  currentsign = sgn(buffer[i]);
-                  signchanges++;
-               }
-
-         }
-      len -= block;
-      s += block;
-   }
-   return (double)signchanges / originalLen.as_double();
-}
-
 void VoiceKey::TestSignChangesUpdate(double & currentsignchanges, int len,
                                      const float & a1,
                                      const float & a2,
@@ -951,53 +905,6 @@ void VoiceKey::TestSignChangesUpdate(double & currentsignchanges, int len,
 }
 
 
-double VoiceKey::TestDirectionChanges(
-   const WaveTrack & t, sampleCount start, sampleCount len)
-{
-
-
-   auto s = start;                                //Keep track of start
-   auto originalLen = len;                        //Keep track of the length of block to process (its not the length of t)
-   const auto blockSize = limitSampleBufferSize(
-      t.GetMaxBlockSize(), len);               //Determine size of sampling buffer
-   unsigned long directionchanges = 1;
-   float lastval=float(0);
-   int lastdirection=1;
-
-   Floats buffer{ blockSize };       //Get a sampling buffer
-
-   while(len > 0) {
-      //Figure out how much to grab
-      auto block = limitSampleBufferSize ( t.GetBestBlockSize(s), len );
-
-      t.GetFloats(buffer.get(), s, block);                      //grab the block;
-
-      if  (len == originalLen) {
-         //The first time through, set stuff up special.
-         lastval = buffer[0];
-      }
-
-      //Now, go through the block and calculate zero crossings
-
-
-      for(decltype(block) i = 0; i< block; i++){
-
-         if( sgn(buffer[i]-lastval) != lastdirection) {
-            directionchanges++;
-            lastdirection = sgn(buffer[i] - lastval);
-         }
-         lastval = buffer[i];
-
-      }
-      len -= block;
-      s += block;
-   }
-   return (double)directionchanges/originalLen.as_double();
-}
-
-
-
-
 // This method does an updating by looking at the trends
 // This will change currentdirections and atrend/trend, so be warned.
 void VoiceKey::TestDirectionChangesUpdate(double & currentdirectionchanges, int len,
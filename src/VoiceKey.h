@@ -16,6 +16,8 @@
 #define	M_PI		3.14159265358979323846  /* pi */
 #endif
 
+#include <vector>
+
 // Tenacity libraries
 #include <lib-math/SampleCount.h>
 
@@ -45,7 +47,12 @@ class VoiceKey {
    void AdjustThreshold(double t);
 
 
-   bool AboveThreshold(const WaveTrack & t, sampleCount start,sampleCount len);
+   bool AboveThreshold(const WaveTrack & t, sampleCount start,sampleCount len,
+                       bool backwards = false);
+
+   //! Forget the samples kept from previous searches.  Call it before
+   //! searching a track that may have changed since
+   void Forget();
 
    void SetKeyType(bool erg, bool scLow, bool scHigh,
                    bool dcLow, bool dcHigh);
@@ -80,11 +87,29 @@ class VoiceKey {
    double mSilentWindowSize;           //Time in milliseconds of below-threshold windows required for silence
    double mSignalWindowSize;           //Time in milliseconds of above-threshold windows required for speech
 
-   double TestEnergy (const WaveTrack & t, sampleCount start,sampleCount len);
-   double TestSignChanges (
-      const WaveTrack & t, sampleCount start, sampleCount len);
-   double TestDirectionChanges(
-      const WaveTrack & t, sampleCount start, sampleCount len);
+   //Samples of the track last searched, kept for the next searches
+   struct Window
+   {
+      const WaveTrack *track{};
+      sampleCount start{ 0 };
+      std::vector<float> samples;
+   };
+   Window mWindow;
+   Window mSpare;                      //Filled, then swapped with mWindow
+
+   //Returns len samples of t, valid until the next call.  When they are not
+   //kept already, reads a large chunk ahead in the direction of the search.
+   const float *GetSamples(const WaveTrack & t, sampleCount start, size_t len,
+                           bool backwards);
+
+   struct Statistics
+   {
+      double energy;
+      double signChanges;
+      double directionChanges;
+   };
+   //Computes all three test statistics in one pass over the samples
+   static Statistics TestStatistics(const float *buffer, size_t len);
 
    void TestEnergyUpdate (double & prevErg, int length, const float & drop, const float & add);
    void TestSignChangesUpdate(double & currentsignchanges,int length, const float & a1,
@@ -97,6 +122,7 @@ class VoiceKey {
 
 
 inline int sgn(int  number){ return (number<0) ? -1: 1;}
+inline int sgn(float number){ return (number<0) ? -1: 1;}
 
 //This returns a logistic density based on a z-score
 // a logistic distn has variance (pi*s)^2/3
@@ -47,6 +47,7 @@ from the project that will own the track.
 #include <lib-track/TimeWarper.h>
 
 #include "Envelope.h"
+#include "SampleBlock.h"
 #include "Sequence.h"
 
 #include "Project.h"
@@ -2307,6 +2308,41 @@ void WaveTrack::GetEnvelopeValues(double *buffer, size_t bufferLen,
    }
 }
 
+namespace {
+void HashCombine(size_t &seed, size_t value)
+{
+   seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+}
+
+size_t WaveTrack::GetContentHash() const
+{
+   const std::hash<double> hash;
+   size_t result = hash(mRate);
+   for (const auto &clip : mClips) {
+      HashCombine(result, hash(clip->GetSequenceStartTime()));
+      HashCombine(result, hash(clip->GetPlayStartTime()));
+      HashCombine(result, hash(clip->GetPlayEndTime()));
+      HashCombine(result, clip->GetRate());
+      HashCombine(result,
+         clip->GetSequenceSamplesCount().as_size_t());
+
+      // Edits of samples make new blocks; the blocks themselves don't change
+      for (const auto &block : *clip->GetSequenceBlockArray()) {
+         HashCombine(result, block.sb->GetBlockID());
+         HashCombine(result, block.start.as_size_t());
+      }
+
+      const auto &envelope = *clip->GetEnvelope();
+      HashCombine(result, hash(envelope.GetOffset()));
+      for (int ii = 0, nn = envelope.GetNumberOfPoints(); ii < nn; ++ii) {
+         HashCombine(result, hash(envelope[ii].GetT()));
+         HashCombine(result, hash(envelope[ii].GetVal()));
+      }
+   }
+   return result;
+}
+
 WaveClip* WaveTrack::GetClipAtSample(sampleCount sample)
 {
    for (const auto &clip: mClips)
@@ -271,6 +271,8 @@ private:
    void GetEnvelopeValues(double *buffer, size_t bufferLen,
                          double t0) const override;
 
+   size_t GetContentHash() const override;
+
    // May assume precondition: t0 <= t1
    std::pair<float, float> GetMinMax(
       double t0, double t1, bool mayThrow = true) const;
@@ -0,0 +1,96 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file WorkerPool.cpp
+
+**********************************************************************/
+
+#include "WorkerPool.h"
+
+#include <utility>
+
+WorkerPool::WorkerPool(size_t nThreads)
+{
+   mThreads.reserve(nThreads);
+   for (size_t ii = 0; ii < nThreads; ++ii)
+      mThreads.emplace_back([this]{ Work(); });
+}
+
+WorkerPool::~WorkerPool()
+{
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mStopping = true;
+   }
+   mStarted.notify_all();
+   for (auto &thread : mThreads)
+      thread.join();
+}
+
+void WorkerPool::ForEach(
+   size_t count, const std::function<void(size_t)> &body)
+{
+   if (count == 0)
+      return;
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mpBody = &body;
+      mCount = count;
+      mNext = 0;
+      mError = nullptr;
+      mBusy = mThreads.size();
+      ++mGeneration;
+   }
+   mStarted.notify_all();
+
+   RunIterations();
+
+   std::unique_lock<std::mutex> lock{ mMutex };
+   mFinished.wait(lock, [this]{ return mBusy == 0; });
+   mpBody = nullptr;
+   if (auto error = std::exchange(mError, nullptr))
+      std::rethrow_exception(error);
+}
+
+void WorkerPool::Work()
+{
+   size_t generation = 0;
+   while (true) {
+      {
+         std::unique_lock<std::mutex> lock{ mMutex };
+         mStarted.wait(lock, [&]{
+            return mStopping || mGeneration != generation; });
+         if (mStopping)
+            return;
+         generation = mGeneration;
+      }
+
+      RunIterations();
+
+      bool last;
+      {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         last = (--mBusy == 0);
+      }
+      if (last)
+         mFinished.notify_one();
+   }
+}
+
+void WorkerPool::RunIterations()
+{
+   // mpBody and mCount don't change until all threads are done
+   for (size_t ii; (ii = mNext++) < mCount;) {
+      try {
+         (*mpBody)(ii);
+      }
+      catch (...) {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         if (!mError)
+            mError = std::current_exception();
+         // Skip the rest
+         mNext = mCount;
+      }
+   }
+}
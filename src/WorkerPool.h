@@ -0,0 +1,70 @@
+/**********************************************************************
+
+  Tenacity: A Digital Audio Editor
+
+  @file WorkerPool.h
+  @brief Threads kept alive to run the iterations of loops in parallel
+
+**********************************************************************/
+
+#ifndef __TENACITY_WORKER_POOL__
+#define __TENACITY_WORKER_POOL__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! Runs the iterations of a loop on its own threads and the caller's
+/*!
+ The threads are started once, and wait between loops, so that a loop that
+ is run again and again, such as one per period of the audio engine,
+ doesn't pay for starting and joining threads each time.
+
+ Only one thread at a time may call ForEach().
+ */
+class WorkerPool
+{
+public:
+   //! Start nThreads threads, which help the calling thread
+   explicit WorkerPool(size_t nThreads);
+   ~WorkerPool();
+
+   WorkerPool(const WorkerPool&) = delete;
+   WorkerPool &operator=(const WorkerPool&) = delete;
+
+   //! The pool's threads and the caller's
+   size_t Concurrency() const { return mThreads.size() + 1; }
+
+   //! Call body for each index in [0, count), in no particular order, and
+   //! return when all calls are done
+   /*! If calls throw, the remaining indices are skipped, and the first
+    exception is rethrown */
+   void ForEach(size_t count, const std::function<void(size_t)> &body);
+
+private:
+   void Work();
+   void RunIterations();
+
+   std::vector<std::thread> mThreads;
+
+   std::mutex mMutex;
+   std::condition_variable mStarted;
+   std::condition_variable mFinished;
+   //! Incremented for each loop, to wake the threads
+   size_t mGeneration{ 0 };
+   //! Threads still running iterations of the current loop
+   size_t mBusy{ 0 };
+   bool mStopping{ false };
+
+   const std::function<void(size_t)> *mpBody{ nullptr };
+   size_t mCount{ 0 };
+   std::atomic<size_t> mNext{ 0 };
+   std::exception_ptr mError;
+};
+
+#endif
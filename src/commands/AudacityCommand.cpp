@@ -25,6 +25,7 @@ ShuttleGui.
 #include "CommandContext.h"
 
 #include "ConfigInterface.h"
+#include "../HeadlessMode.h"
 
 #include <algorithm>
 
@@ -182,6 +183,12 @@ bool AudacityCommand::DoAudacityCommand(wxWindow *parent,
                       const CommandContext & context,
                       bool shouldPrompt /* = true */)
 {
+   if (HeadlessMode::IsEnabled() && NeedsProjectWindow())
+   {
+      context.Error(HeadlessMode::Unsupported(GetName()).Translation());
+      return false;
+   }
+
    // Note: Init may read parameters from preferences
    if (!Init())
    {
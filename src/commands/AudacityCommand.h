@@ -66,6 +66,8 @@ class TENACITY_DLL_API AudacityCommand /* not final */ : public wxEvtHandler,
    virtual ManualPageID ManualPage(){ return {}; }
    virtual bool IsBatchProcessing(){ return mIsBatch;}
    virtual void SetBatchProcessing(bool start){ mIsBatch = start;};
+   //! Whether Apply() works on windows, so is unsupported in HeadlessMode
+   virtual bool NeedsProjectWindow(){ return false; }
    
    virtual bool Apply(const CommandContext & /* context */ ) {return false;};
 
@@ -63,11 +63,23 @@ OldStyleCommandPointer CommandBuilder::GetCommand()
 }
 
 wxString CommandBuilder::GetResponse()
+{
+   wxString response;
+   StreamResponse([&](const wxString &chunk){ response += chunk; });
+   return response;
+}
+
+void CommandBuilder::StreamResponse(
+   const std::function<void(const wxString &)> &write)
 {
    if (!mValid && !mError.empty()) {
-      return mError + wxT("\n");
+      write(mError + wxT("\n"));
+      return;
    }
-   return mResponse->GetResponse() + wxT("\n");
+   wxString chunk;
+   while (mResponse->NextChunk(chunk))
+      write(chunk);
+   write(wxT("\n"));
 }
 
 void CommandBuilder::Failure(const wxString &msg)
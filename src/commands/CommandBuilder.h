@@ -16,6 +16,7 @@
 #ifndef __COMMANDBUILDER__
 #define __COMMANDBUILDER__
 
+#include <functional>
 #include <memory>
 #include <wx/string.h>
 
@@ -50,5 +51,8 @@ class CommandBuilder
       bool WasValid();
       OldStyleCommandPointer GetCommand();
       wxString GetResponse();
+      //! Waits for the response, passing it to write in pieces as the
+      //! command produces it
+      void StreamResponse(const std::function<void(const wxString &)> &write);
 };
 #endif /* End of include guard: __COMMANDBUILDER__ */
@@ -50,7 +50,8 @@ void CommandHandler::OnReceiveCommand(AppCommandEvent &event)
          return cmd->Apply( context );
       });
 
-      // Redraw the project
-      ProjectWindow::Get( context.project ).RedrawProject();
+      // Redraw the project, unless in headless mode
+      if (auto pWindow = ProjectWindow::Find( &context.project ))
+         pWindow->RedrawProject();
    }
 }
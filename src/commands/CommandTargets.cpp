@@ -63,45 +63,73 @@ void CommandMessageTarget::EndStruct(){
    }
    Update( " }" );
 }
+
+// The JSON items below are built by appending rather than formatting, since
+// GetInfo may produce hundreds of thousands of them
+
+namespace {
+
+// Numbers as JSON needs them, whatever the locale of the user.
+// The stream is made once; making a locale per number was slow.
+wxString CNumber(double value)
+{
+   thread_local std::ostringstream str = []{
+      std::ostringstream result;
+      result.imbue(std::locale::classic());
+      return result;
+   }();
+   str.str(std::string{});
+   str << value;
+   return str.str();
+}
+
+}
+
 void CommandMessageTarget::AddItem(const wxString &value, const wxString &name){
-   wxString Padding;
-   Padding.Pad( mCounts.size() *2 -2);
-   Padding = (( value.length() < 15 ) || (mCounts.back()<=0))  ? wxString{} : wxString("\n") + Padding;
-   if( name.empty() )
-      Update( wxString::Format( "%s%s\"%s\"", (mCounts.back()>0)?", ":"", Padding, Escaped(value)));
-   else
-      Update( wxString::Format( "%s%s\"%s\":\"%s\"", (mCounts.back()>0)?", ":"", Padding, name, Escaped(value)));
+   wxString message;
+   if( mCounts.back() > 0 ){
+      message << ", ";
+      if( value.length() >= 15 ){
+         message << "\n";
+         message.Pad( mCounts.size() *2 -2);
+      }
+   }
+   if( !name.empty() )
+      message << "\"" << name << "\":";
+   message << "\"" << Escaped(value) << "\"";
+   Update( message );
    mCounts.back() += 1;
 }
 
 void CommandMessageTarget::AddBool(const bool value,      const wxString &name){
-   if( name.empty() )
-      Update( wxString::Format( "%s\"%s\"", (mCounts.back()>0)?", ":"", value?"true":"false"));
-   else
-      Update( wxString::Format( "%s\"%s\":\"%s\"", (mCounts.back()>0)?", ":"", name,value?"true":"false"));
+   wxString message;
+   if( mCounts.back() > 0 )
+      message << ", ";
+   if( !name.empty() )
+      message << "\"" << name << "\":";
+   message << ( value ? "\"true\"" : "\"false\"" );
+   Update( message );
    mCounts.back() += 1;
 }
 
 void CommandMessageTarget::AddItem(const double value,    const wxString &name){
-   std::stringstream str;
-   std::locale nolocale("C");
-   str.imbue(nolocale);
-
-   if( name.empty() )
-      str << ((mCounts.back()>0)? std::string(", ") : std::string("")) << value;
-   else
-      str << ((mCounts.back()>0)? std::string(", ") : std::string(""))
-          << std::string("\"") << name << std::string("\"") << std::string(":") << value;
-
-   Update( str.str() );
+   wxString message;
+   if( mCounts.back() > 0 )
+      message << ", ";
+   if( !name.empty() )
+      message << "\"" << name << "\":";
+   message << CNumber( value );
+   Update( message );
    mCounts.back() += 1;
 }
 
 void CommandMessageTarget::StartField(const wxString &name){
-   if( name.empty() )
-      Update( wxString::Format( "%s", (mCounts.back()>0)? ", " : ""));
-   else
-      Update( wxString::Format( "%s\"%s\":", (mCounts.back()>0) ?", ":"", name));
+   wxString message;
+   if( mCounts.back() > 0 )
+      message << ", ";
+   if( !name.empty() )
+      message << "\"" << name << "\":";
+   Update( message );
    mCounts.back() += 1;
    mCounts.push_back( 0 );
 }
@@ -116,6 +144,9 @@ void CommandMessageTarget::Flush(){
 }
 
 wxString CommandMessageTarget::Escaped( const wxString & str){
+   // Most strings need no escaping; don't copy and search them twice
+   if( str.find( '"' ) == wxString::npos )
+      return str;
    wxString Temp = str;
    Temp.Replace( "\"", "\\\"");
    return Temp;
@@ -456,6 +487,55 @@ InteractiveOutputTargets::InteractiveOutputTargets() :
 {
 }
 
+ResponseTarget::ResponseTarget()
+{
+   // Cater for handling long responses quickly.
+   mPending.Alloc(ChunkSize);
+}
+
+ResponseTarget::~ResponseTarget()
+{
+}
+
+void ResponseTarget::Update(const wxString &message)
+{
+   mPending += message;
+   if( mPending.length() < ChunkSize )
+      return;
+   {
+      std::lock_guard<std::mutex> guard{ mMutex };
+      mChunks.emplace_back();
+      mChunks.back().swap( mPending );
+   }
+   mCondition.notify_one();
+   mPending.Alloc(ChunkSize);
+}
+
+void ResponseTarget::Flush()
+{
+   {
+      std::lock_guard<std::mutex> guard{ mMutex };
+      if( !mPending.empty() ){
+         mChunks.emplace_back();
+         mChunks.back().swap( mPending );
+      }
+      mFinished = true;
+   }
+   mCondition.notify_one();
+}
+
+bool ResponseTarget::NextChunk(wxString &chunk)
+{
+   std::unique_lock<std::mutex> lock{ mMutex };
+   mCondition.wait( lock, [this]{ return mFinished || !mChunks.empty(); } );
+   if( mChunks.empty() )
+      return false;
+   chunk.clear();
+   chunk.swap( mChunks.front() );
+   mChunks.pop_front();
+   return true;
+}
+
 void StatusBarTarget::Update(const wxString &message)
 {
    mStatus.SetStatusText(message, 0);
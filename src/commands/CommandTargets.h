@@ -55,7 +55,10 @@ and sends it to that message target.
 #ifndef __COMMANDTARGETS__
 #define __COMMANDTARGETS__
 
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <wx/string.h>
 #include <wx/thread.h>
@@ -223,35 +226,31 @@ public:
 };
 
 /// Constructs a response (to be sent back to a script)
+/** The response is handed over in chunks as it grows, so that a long one
+ can be sent while the command is still producing the rest */
 class ResponseTarget final : public CommandMessageTarget
 {
 private:
-   wxSemaphore mSemaphore;
-   wxString mBuffer;
+   //! Characters collected before the pending text becomes a chunk
+   static constexpr size_t ChunkSize = 64 * 1024;
+
+   // Written only by the thread running the command
+   wxString mPending;
+
+   // Shared with the thread reading the response
+   std::mutex mMutex;
+   std::condition_variable mCondition;
+   std::deque<wxString> mChunks;
+   bool mFinished{ false };
 public:
-   ResponseTarget()
-      : mBuffer(wxEmptyString),
-        mSemaphore(0, 1)
-   { 
-      // Cater for handling long responses quickly.
-      mBuffer.Alloc(40000);
-   }
-   virtual ~ResponseTarget()
-   {
-   }
-   void Update(const wxString &message) override
-   {
-      mBuffer += message;
-   }
-   virtual void Flush() override
-   {
-      mSemaphore.Post();
-   }
-   wxString GetResponse()
-   {
-      mSemaphore.Wait();
-      return mBuffer;
-   }
+   ResponseTarget();
+   virtual ~ResponseTarget();
+   void Update(const wxString &message) override;
+   //! Ends the response
+   virtual void Flush() override;
+   //! Waits for the next chunk of the response
+   /*! @return false, after the last chunk, when the response is finished */
+   bool NextChunk(wxString &chunk);
 };
 
 /// Sends messages to two message targets at once
@@ -23,12 +23,31 @@ threshold of difference in two selected tracks
 
 #include "LoadCommands.h"
 #include "ViewInfo.h"
+#include "../SampleBlock.h"
+#include "../Sequence.h"
+#include "../WaveClip.h"
 #include "../WaveTrack.h"
 
 
+#include <algorithm>
+#include <atomic>
 #include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
 #include <wx/intl.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COMPARE_AUDIO_SSE2
+#include <emmintrin.h>
+#endif
+
 #include "../shuttle/Shuttle.h"
 #include "../shuttle/ShuttleGui.h"
 #include "../widgets/AudacityMessageBox.h"
@@ -98,14 +117,209 @@ bool CompareAudioCommand::GetSelection(const CommandContext &context, TenacityPr
    return true;
 }
 
-double CompareAudioCommand::CompareSample(double value1, double value2)
+namespace {
+
+//! Half open interval of track samples
+struct SampleRange
+{
+   sampleCount start, end;
+};
+
+//! How many differing ranges are listed in the results
+constexpr size_t MaxReportedRanges = 100;
+
+//! Statistics of the differences found in some samples
+struct Differences
 {
-   return fabs(value1 - value2);
+   //! Samples differing by more than the threshold
+   sampleCount count{ 0 };
+   double maxError{ 0 };
+   double sumOfSquares{ 0 };
+   //! Number of maximal runs of differing samples
+   size_t nRanges{ 0 };
+   //! The first runs, up to MaxReportedRanges of them
+   std::vector<SampleRange> ranges;
+   //! The last run, valid when nRanges > 0
+   SampleRange last{};
+   //! Whether last is also ranges.back()
+   bool lastStored{ false };
+
+   //! Note one differing sample; calls must be in increasing position order
+   void Add(sampleCount position)
+   {
+      ++count;
+      if (nRanges > 0 && last.end == position) {
+         ++last.end;
+         if (lastStored)
+            ranges.back().end = last.end;
+         return;
+      }
+      ++nRanges;
+      last = { position, position + 1 };
+      lastStored = ranges.size() < MaxReportedRanges;
+      if (lastStored)
+         ranges.push_back(last);
+   }
+
+   //! Merge results for later samples
+   void Append(const Differences &other)
+   {
+      count += other.count;
+      maxError = std::max(maxError, other.maxError);
+      sumOfSquares += other.sumOfSquares;
+      if (other.nRanges == 0)
+         return;
+
+      auto iter = other.ranges.begin();
+      auto nOther = other.nRanges;
+      if (nRanges > 0 && last.end == iter->start) {
+         // A run continues across the boundary
+         last.end = iter->end;
+         if (lastStored)
+            ranges.back().end = last.end;
+         ++iter, --nOther;
+         if (nOther == 0)
+            return;
+      }
+
+      for (; iter != other.ranges.end() && ranges.size() < MaxReportedRanges;
+           ++iter)
+         ranges.push_back(*iter);
+      nRanges += nOther;
+      last = other.last;
+      lastStored = other.lastStored && iter == other.ranges.end();
+   }
+};
+
+//! Accumulate differences of corresponding samples, which begin at position
+void CompareSamples(const float *buffer0, const float *buffer1, size_t len,
+   sampleCount position, double threshold, Differences &differences)
+{
+   // Differences of floats are exact in double, and are compared with the
+   // threshold in double, so that results don't depend on rounding
+   size_t ii = 0;
+   double maxError = differences.maxError;
+   double sumOfSquares = 0;
+
+#ifdef COMPARE_AUDIO_SSE2
+   // Four samples at a time, in two pairs of doubles:  the statistics are
+   // branch free, and only groups containing a difference over the threshold
+   // are examined further
+   const auto absMask =
+      _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+   const auto thresholds = _mm_set1_pd(threshold);
+   auto maxima = _mm_setzero_pd();
+   auto sums = _mm_setzero_pd();
+   for (; ii + 4 <= len; ii += 4) {
+      const auto samples0 = _mm_loadu_ps(buffer0 + ii);
+      const auto samples1 = _mm_loadu_ps(buffer1 + ii);
+      const auto errorLow = _mm_and_pd(absMask,
+         _mm_sub_pd(_mm_cvtps_pd(samples0), _mm_cvtps_pd(samples1)));
+      const auto errorHigh = _mm_and_pd(absMask,
+         _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(samples0, samples0)),
+            _mm_cvtps_pd(_mm_movehl_ps(samples1, samples1))));
+      maxima = _mm_max_pd(maxima, _mm_max_pd(errorLow, errorHigh));
+      sums = _mm_add_pd(sums, _mm_mul_pd(errorLow, errorLow));
+      sums = _mm_add_pd(sums, _mm_mul_pd(errorHigh, errorHigh));
+      if (auto mask =
+            _mm_movemask_pd(_mm_cmpgt_pd(errorLow, thresholds)) |
+            (_mm_movemask_pd(_mm_cmpgt_pd(errorHigh, thresholds)) << 2))
+         for (int jj = 0; jj < 4; ++jj)
+            if (mask & (1 << jj))
+               differences.Add(position + ii + jj);
+   }
+
+   double lanes[2];
+   _mm_storeu_pd(lanes, maxima);
+   maxError = std::max({ maxError, lanes[0], lanes[1] });
+   _mm_storeu_pd(lanes, sums);
+   sumOfSquares = lanes[0] + lanes[1];
+#endif
+
+   for (; ii < len; ++ii) {
+      const auto error =
+         std::fabs(double(buffer0[ii]) - double(buffer1[ii]));
+      maxError = std::max(maxError, error);
+      sumOfSquares += error * error;
+      if (error > threshold)
+         differences.Add(position + ii);
+   }
+
+   differences.maxError = maxError;
+   differences.sumOfSquares += sumOfSquares;
 }
 
-inline int min(int a, int b)
+//! Whether the visible parts of clips of the track overlap each other
+bool ClipsOverlap(const WaveTrack &track)
 {
-   return (a < b) ? a : b;
+   auto clips = track.SortedClipArray();
+   for (size_t ii = 1; ii < clips.size(); ++ii)
+      if (clips[ii]->GetPlayStartSample() < clips[ii - 1]->GetPlayEndSample())
+         return true;
+   return false;
+}
+
+//! Find ranges within [start, end) where both tracks show the same samples
+//! of the same sample blocks, so that no reading is needed
+/*! Blocks are shared after copying, duplicating or undoing, and a render that
+ did not change some audio may keep its blocks.  Block summaries are not
+ used:  equal summaries don't prove equal samples.
+ @return disjoint ranges in increasing order */
+std::vector<SampleRange> FindSharedRanges(
+   const WaveTrack &track0, const WaveTrack &track1,
+   sampleCount start, sampleCount end)
+{
+   std::vector<SampleRange> result;
+
+   // With overlapping clips, which one is visible depends on clip order
+   if (ClipsOverlap(track0) || ClipsOverlap(track1))
+      return result;
+
+   // Visible part of each block in [start, end), keyed by block id and the
+   // track position of the first sample of the block
+   using Key = std::pair<SampleBlockID, long long>;
+   auto visit = [&](const WaveTrack &track, auto &&action){
+      for (const auto &clip : track.GetClips()) {
+         const auto sequenceStart = clip->GetSequenceStartSample();
+         const auto visibleStart = std::max(start, clip->GetPlayStartSample());
+         const auto visibleEnd = std::min(end, clip->GetPlayEndSample());
+         if (visibleStart >= visibleEnd)
+            continue;
+         for (const auto &block : clip->GetSequence()->GetBlockArray()) {
+            const auto blockStart = sequenceStart + block.start;
+            const auto blockEnd = blockStart + block.sb->GetSampleCount();
+            const SampleRange range{
+               std::max(blockStart, visibleStart),
+               std::min(blockEnd, visibleEnd) };
+            if (range.start < range.end)
+               action(
+                  Key{ block.sb->GetBlockID(), blockStart.as_long_long() },
+                  range);
+         }
+      }
+   };
+
+   std::map<Key, SampleRange> blocks0;
+   visit(track0, [&](const Key &key, const SampleRange &range){
+      blocks0.emplace(key, range);
+   });
+   visit(track1, [&](const Key &key, const SampleRange &range){
+      auto iter = blocks0.find(key);
+      if (iter == blocks0.end())
+         return;
+      const SampleRange shared{
+         std::max(range.start, iter->second.start),
+         std::min(range.end, iter->second.end) };
+      if (shared.start < shared.end)
+         result.push_back(shared);
+   });
+
+   std::sort(result.begin(), result.end(),
+      [](const SampleRange &a, const SampleRange &b){
+         return a.start < b.start; });
+   return result;
+}
+
 }
 
 bool CompareAudioCommand::Apply(const CommandContext & context)
@@ -120,47 +334,134 @@ bool CompareAudioCommand::Apply(const CommandContext & context)
       + mTrack1->GetName() + wxT("'.");
    context.Status(msg);
 
-   long errorCount = 0;
-   // Initialize buffers for track data to be analyzed
-   auto buffSize = std::min(mTrack0->GetMaxBlockSize(), mTrack1->GetMaxBlockSize());
-
-   Floats buff0{ buffSize };
-   Floats buff1{ buffSize };
-
-   // Compare tracks block by block
    auto s0 = mTrack0->TimeToLongSamples(mT0);
    auto s1 = mTrack0->TimeToLongSamples(mT1);
-   auto position = s0;
    auto length = s1 - s0;
-   while (position < s1)
-   {
-      // Get a block of data into the buffers
-      auto block = limitSampleBufferSize(
-         mTrack0->GetBestBlockSize(position), s1 - position
-      );
-      mTrack0->GetFloats(buff0.get(), position, block);
-      mTrack1->GetFloats(buff1.get(), position, block);
-
-      for (decltype(block) buffPos = 0; buffPos < block; ++buffPos)
-      {
-         if (CompareSample(buff0[buffPos], buff1[buffPos]) > errorThreshold)
-         {
-            ++errorCount;
+
+   // Samples in shared blocks are equal, so need no reading
+   const auto shared = FindSharedRanges(*mTrack0, *mTrack1, s0, s1);
+
+   // Long material is compared in chunks by several threads; the results
+   // of chunks are merged in order
+   const auto bufferSize =
+      std::min(mTrack0->GetMaxBlockSize(), mTrack1->GetMaxBlockSize());
+   const sampleCount chunkSize = std::max<size_t>(64 * bufferSize, 1 << 20);
+   const auto nChunks =
+      std::max<size_t>(1, ((length + chunkSize - 1) / chunkSize).as_size_t());
+   std::vector<Differences> results(nChunks);
+   std::atomic<size_t> nextChunk{ 0 };
+   std::atomic<long long> done{ 0 };
+   std::atomic<size_t> running{ 0 };
+   std::exception_ptr pException;
+   std::mutex exceptionMutex;
+   const double threshold = errorThreshold;
+
+   auto work = [&]{
+      try {
+         Floats buffer0{ bufferSize };
+         Floats buffer1{ bufferSize };
+         for (size_t chunk; (chunk = nextChunk++) < nChunks;) {
+            const auto chunkStart = s0 + chunkSize * chunk;
+            const auto chunkEnd = std::min(s1, chunkStart + chunkSize);
+            auto &differences = results[chunk];
+
+            auto iter = std::upper_bound(shared.begin(), shared.end(),
+               chunkStart, [](sampleCount position, const SampleRange &range){
+                  return position < range.end; });
+            auto position = chunkStart;
+            while (position < chunkEnd) {
+               // Skip what is shared
+               if (iter != shared.end() && iter->start <= position) {
+                  const auto skipTo = std::min(chunkEnd, iter->end);
+                  done += (skipTo - position).as_long_long();
+                  position = skipTo;
+                  ++iter;
+                  continue;
+               }
+
+               auto limit = chunkEnd;
+               if (iter != shared.end())
+                  limit = std::min(limit, iter->start);
+               const auto block = limitSampleBufferSize(
+                  std::min(bufferSize, mTrack0->GetBestBlockSize(position)),
+                  limit - position);
+               mTrack0->GetFloats(buffer0.get(), position, block);
+               mTrack1->GetFloats(buffer1.get(), position, block);
+               CompareSamples(buffer0.get(), buffer1.get(), block, position,
+                  threshold, differences);
+               position += block;
+               done += block;
+            }
          }
       }
-
-      position += block;
-      context.Progress(
-         (position - s0).as_double() /
-         length.as_double()
-      );
+      catch (...) {
+         std::lock_guard<std::mutex> lock{ exceptionMutex };
+         if (!pException)
+            pException = std::current_exception();
+         // Make the other threads stop too
+         nextChunk = nChunks;
+      }
+      --running;
+   };
+
+   const auto nThreads = std::min<size_t>(
+      nChunks, std::max(1u, std::thread::hardware_concurrency()));
+   running = nThreads;
+   if (nThreads == 1)
+      work();
+   else {
+      std::vector<std::thread> threads;
+      for (size_t ii = 0; ii < nThreads; ++ii)
+         threads.emplace_back(work);
+      // Only this thread reports progress
+      while (running > 0) {
+         context.Progress(done.load() / length.as_double());
+         std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      }
+      for (auto &thread : threads)
+         thread.join();
    }
+   context.Progress(1.0);
+   if (pException)
+      std::rethrow_exception(pException);
+
+   Differences total;
+   for (const auto &differences : results)
+      total.Append(differences);
+   const auto errorCount = total.count.as_long_long();
 
    // Output the results
    double errorSeconds = mTrack0->LongSamplesToTime(errorCount);
-   context.Status(wxString::Format(wxT("%li"), errorCount));
+   context.Status(wxString::Format(wxT("%lli"), errorCount));
    context.Status(wxString::Format(wxT("%.4f"), errorSeconds));
-   context.Status(wxString::Format(wxT("Finished comparison: %li samples (%.3f seconds) exceeded the error threshold of %f."), errorCount, errorSeconds, errorThreshold));
+   context.Status(wxString::Format(wxT("Finished comparison: %lli samples (%.3f seconds) exceeded the error threshold of %f."), errorCount, errorSeconds, errorThreshold));
+
+   // Details, after the lines that scripts have always parsed
+   const auto rms = std::sqrt(total.sumOfSquares / length.as_double());
+   context.Status(wxString::Format(
+      wxT("Maximum error %g, RMS error %g."), total.maxError, rms));
+   context.Status(wxString::Format(
+      wxT("%.3f seconds were shared between the tracks and not read."),
+      std::accumulate(shared.begin(), shared.end(), 0.0,
+         [&](double sum, const SampleRange &range){
+            return sum + mTrack0->LongSamplesToTime(range.end - range.start);
+         })));
+   if (total.nRanges > 0)
+   {
+      context.Status(wxString::Format(
+         wxT("First difference at %.6f seconds."),
+         mTrack0->LongSamplesToTime(total.ranges.front().start)));
+      context.Status(wxString::Format(
+         wxT("%llu differing ranges%s:"),
+         static_cast<unsigned long long>(total.nRanges),
+         total.nRanges > total.ranges.size()
+            ? wxString::Format(wxT(", the first %llu"),
+               static_cast<unsigned long long>(total.ranges.size()))
+            : wxString{}));
+      for (const auto &range : total.ranges)
+         context.Status(wxString::Format(wxT("%.6f\t%.6f"),
+            mTrack0->LongSamplesToTime(range.start),
+            mTrack0->LongSamplesToTime(range.end)));
+   }
    return true;
 }
-
@@ -47,10 +47,6 @@ private:
 
    // Update member variables with project selection data (and validate)
    bool GetSelection(const CommandContext &context, TenacityProject &proj);
-
-protected:
-   double CompareSample(double value1, double value2) /* not override */;
-
 };
 
 #endif /* End of include guard: __COMPAREAUDIOCOMMAND__ */
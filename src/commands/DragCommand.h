@@ -33,6 +33,7 @@ public:
 
    // AudacityCommand overrides
    ManualPageID ManualPage() override {return L"Extra_Menu:_Scriptables_II#move_mouse";}
+   bool NeedsProjectWindow() override {return true;}
 
    bool Apply(const CommandContext & context) override;
 
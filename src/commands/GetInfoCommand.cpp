@@ -25,6 +25,7 @@ This class now lists
 
 #include "LoadCommands.h"
 #include "Project.h"
+#include "../HeadlessMode.h"
 #include "../ProjectWindows.h"
 #include "CommandManager.h"
 #include "CommandTargets.h"
@@ -52,6 +53,8 @@ This class now lists
 // Tenacity libraries
 #include <lib-module-manager/PluginManager.h>
 
+#include <cfloat>
+
 #include <wx/frame.h>
 #include <wx/log.h>
 #include <wx/menu.h>
@@ -109,6 +112,11 @@ static const EnumValueSymbol kFormats[nFormats] =
 bool GetInfoCommand::DefineParams( ShuttleParams & S ){
    S.DefineEnum( mInfoType, wxT("Type"), 0, kTypes, nTypes );
    S.DefineEnum( mFormat, wxT("Format"), 0, kFormats, nFormats );
+   // Filters for Tracks, Clips, Envelopes and Labels
+   S.OptionalN( bHasFirstTrack ).Define( mFirstTrack, wxT("Track"), 0, 0, 100000 );
+   S.OptionalN( bHasNumTracks ).Define( mNumTracks, wxT("TrackCount"), 1, 0, 100000 );
+   S.OptionalN( bHasT0 ).Define( mT0, wxT("Start"), 0.0, -100.0, (double)FLT_MAX );
+   S.OptionalN( bHasT1 ).Define( mT1, wxT("End"), 0.0, -100.0, (double)FLT_MAX );
    return true;
 }
 
@@ -124,6 +132,15 @@ void GetInfoCommand::PopulateOrExchange(ShuttleGui & S)
          mFormat, Msgids( kFormats, nFormats ));
    }
    S.EndMultiColumn();
+   S.StartMultiColumn(3, wxEXPAND);
+   {
+      S.SetStretchyCol( 2 );
+      S.Optional( bHasFirstTrack ).TieNumericTextBox(XXO("First Track:"), mFirstTrack);
+      S.Optional( bHasNumTracks ).TieNumericTextBox(XXO("Track Count:"), mNumTracks);
+      S.Optional( bHasT0 ).TieNumericTextBox(XXO("Start Time:"), mT0);
+      S.Optional( bHasT1 ).TieNumericTextBox(XXO("End Time:"), mT1);
+   }
+   S.EndMultiColumn();
 }
 
 bool GetInfoCommand::Apply(const CommandContext &context)
@@ -154,6 +171,16 @@ bool GetInfoCommand::Apply(const CommandContext &context)
 
 bool GetInfoCommand::ApplyInner(const CommandContext &context)
 {
+   // These describe windows
+   if( HeadlessMode::IsEnabled() &&
+       ( mInfoType == kMenus || mInfoType == kPreferences ||
+         mInfoType == kBoxes ) ){
+      context.Error( HeadlessMode::Unsupported( Verbatim(
+         wxT("GetInfo: Type=") + kTypes[ mInfoType ].Internal() ) )
+            .Translation() );
+      return false;
+   }
+
    switch( mInfoType  ){
       // flag of 1 to include parameterless commands.
       case kCommands     : return SendCommands( context, 1 );
@@ -467,9 +494,15 @@ bool GetInfoCommand::SendBoxes(const CommandContext &context)
 bool GetInfoCommand::SendTracks(const CommandContext & context)
 {
    auto &tracks = TrackList::Get( context.project );
+   int i=0;
    context.StartArray();
    for (auto trk : tracks.Leaders())
    {
+      // Per track numbering counts all tracks
+      if( !WantTrack( i++ ) ||
+          !WantTimes( trk->GetStartTime(), trk->GetEndTime() ) )
+         continue;
+
       auto &trackFocus = TrackFocus::Get( context.project );
       Track * fTrack = trackFocus.Get();
 
@@ -517,9 +550,15 @@ bool GetInfoCommand::SendClips(const CommandContext &context)
    int i=0;
    context.StartArray();
    for (auto t : tracks.Leaders()) {
+      if( !WantTrack( i ) ) {
+         i++;
+         continue;
+      }
       t->TypeSwitch([&](WaveTrack *waveTrack) {
          WaveClipPointers ptrs(waveTrack->SortedClipArray());
          for (WaveClip * pClip : ptrs) {
+            if( !WantTimes( pClip->GetPlayStartTime(), pClip->GetPlayEndTime() ) )
+               continue;
             context.StartStruct();
             context.AddItem((double)i, "track");
             context.AddItem(pClip->GetPlayStartTime(), "start");
@@ -543,10 +582,19 @@ bool GetInfoCommand::SendEnvelopes(const CommandContext &context)
    int j=0;
    context.StartArray();
    for (auto t : tracks.Leaders()) {
+      if( !WantTrack( i ) ) {
+         i++;
+         continue;
+      }
       t->TypeSwitch([&](WaveTrack *waveTrack) {
          WaveClipPointers ptrs(waveTrack->SortedClipArray());
          j = 0;
          for (WaveClip * pClip : ptrs) {
+            // Per clip numbering counts all clips of the track
+            if( !WantTimes( pClip->GetPlayStartTime(), pClip->GetPlayEndTime() ) ) {
+               j++;
+               continue;
+            }
             context.StartStruct();
             context.AddItem((double)i, "track");
             context.AddItem((double)j, "clip");
@@ -584,10 +632,16 @@ bool GetInfoCommand::SendLabels(const CommandContext &context)
    int i=0;
    context.StartArray();
    for (auto t : tracks.Leaders()) {
+      if( !WantTrack( i ) ) {
+         i++;
+         continue;
+      }
       t->TypeSwitch( [&](LabelTrack *labelTrack) {
 #ifdef VERBOSE_LABELS_FORMATTING
          for (int nn = 0; nn< (int)labelTrack->mLabels.size(); nn++) {
             const auto &label = labelTrack->mLabels[nn];
+            if( !WantTimes( label.getT0(), label.getT1() ) )
+               continue;
             context.StartStruct();
             context.AddItem( (double)i, "track" );
             context.AddItem( label.getT0(), "start" );
@@ -600,6 +654,8 @@ bool GetInfoCommand::SendLabels(const CommandContext &context)
          context.AddItem( (double)i ); // Track number.
          context.StartArray();
          for ( const auto &label : labelTrack->GetLabels() ) {
+            if( !WantTimes( label.getT0(), label.getT1() ) )
+               continue;
             context.StartArray();
             context.AddItem( label.getT0() ); // start
             context.AddItem( label.getT1() ); // end
@@ -618,6 +674,19 @@ bool GetInfoCommand::SendLabels(const CommandContext &context)
    return true;
 }
 
+bool GetInfoCommand::WantTrack( int index ) const
+{
+   const int first = bHasFirstTrack ? mFirstTrack : 0;
+   return index >= first &&
+      ( !bHasNumTracks || index < first + mNumTracks );
+}
+
+bool GetInfoCommand::WantTimes( double t0, double t1 ) const
+{
+   // Anything overlapping the range, including its ends
+   return ( !bHasT0 || t1 >= mT0 ) && ( !bHasT1 || t0 <= mT1 );
+}
+
 /*******************************************************************
 The various Explore functions are called from the Send functions,
 and may be recursive.  'Send' is the top level.
@@ -46,6 +46,16 @@ public:
    int mInfoType;
    int mFormat;
 
+   // Optional filters, applied before anything is formatted
+   bool bHasFirstTrack;
+   bool bHasNumTracks;
+   bool bHasT0;
+   bool bHasT1;
+   int mFirstTrack;
+   int mNumTracks;
+   double mT0;
+   double mT1;
+
 private:
    bool SendCommands(const CommandContext & context, int flags);
    bool SendMenus(const CommandContext & context);
@@ -56,6 +66,11 @@ private:
    bool SendEnvelopes(const CommandContext & context);
    bool SendBoxes(const CommandContext & context);
 
+   //! Whether a track, numbered among all tracks, passes the filters
+   bool WantTrack( int index ) const;
+   //! Whether something spanning the times passes the filters
+   bool WantTimes( double t0, double t1 ) const;
+
    void ExploreMenu( const CommandContext &context, wxMenu * pMenu, int Id, int depth );
    void ExploreTrackPanel( const CommandContext & context,
       wxPoint P, int depth );
@@ -22,6 +22,7 @@
 
 #include "LoadCommands.h"
 #include "TenacityLogger.h"
+#include "../HeadlessMode.h"
 #include "../ProjectFileIO.h"
 #include "../ProjectFileManager.h"
 #include "../ProjectManager.h"
@@ -56,6 +57,26 @@ void OpenProjectCommand::PopulateOrExchange(ShuttleGui & S)
 
 bool OpenProjectCommand::Apply(const CommandContext & context){
 
+   // Without windows, there is no file dialog, and no new project to open
+   // into when this one is in use
+   if( HeadlessMode::IsEnabled() )
+   {
+      if( mFileName.empty() )
+      {
+         context.Error(
+            HeadlessMode::Unsupported( XO("Choosing a file to open") )
+               .Translation() );
+         return false;
+      }
+      if( !ProjectManager::SafeToOpenProjectInto( context.project ) )
+      {
+         context.Error( HeadlessMode::Unsupported(
+            XO("Opening a file when the project is not empty") )
+               .Translation() );
+         return false;
+      }
+   }
+
    auto &projectFileIO = ProjectFileIO::Get(context.project);
 
    auto oldFileName = projectFileIO.GetFileName();
@@ -106,6 +127,13 @@ void SaveProjectCommand::PopulateOrExchange(ShuttleGui & S)
 bool SaveProjectCommand::Apply(const CommandContext &context)
 {
    auto &projectFileManager = ProjectFileManager::Get( context.project );
+   if ( mFileName.empty() && HeadlessMode::IsEnabled() )
+   {
+      context.Error(
+         HeadlessMode::Unsupported( XO("Choosing a file to save") )
+            .Translation() );
+      return false;
+   }
    if ( mFileName.empty() )
       return projectFileManager.SaveAs();
    else
@@ -135,6 +163,13 @@ void SaveCopyCommand::PopulateOrExchange(ShuttleGui & S)
 
 bool SaveCopyCommand::Apply(const CommandContext &context)
 {
+   // Saving a copy always raises the project window, and may prompt
+   if ( HeadlessMode::IsEnabled() )
+   {
+      context.Error(
+         HeadlessMode::Unsupported( Symbol.Msgid() ).Translation() );
+      return false;
+   }
    auto &projectFileManager = ProjectFileManager::Get( context.project );
    return projectFileManager.SaveCopy(mFileName);
 }
@@ -25,16 +25,23 @@ code out of ModuleManager.
 #include "CommandBuilder.h"
 #include "ActiveProject.h"
 #include "AppCommandEvent.h"
+#include "BasicUI.h"
+#include "Internat.h"
 #include "Project.h"
+#include "ProjectHistory.h"
+#include "WaveTrack.h"
 #include <wx/app.h>
 #include <wx/string.h>
+#include <functional>
+#include <future>
 #include <thread>
 
 /// This is the function which actually obeys one command.
-static int ExecCommand(wxString *pIn, wxString *pOut, bool fromMain)
+static void ExecCommand(const wxString &in, bool fromMain,
+   const std::function<void(const wxString &)> &write)
 {
    if (auto pProject = ::GetActiveProject().lock()) {
-      CommandBuilder builder(*pProject, *pIn);
+      CommandBuilder builder(*pProject, in);
       if (builder.WasValid())
       {
          OldStyleCommandPointer cmd = builder.GetCommand();
@@ -56,11 +63,15 @@ static int ExecCommand(wxString *pIn, wxString *pOut, bool fromMain)
       }
 
       // Wait for and retrieve the response
-      *pOut = builder.GetResponse();
+      builder.StreamResponse(write);
    }
-   else
-      *pOut = wxString{};
+}
 
+static int ExecCommand(wxString *pIn, wxString *pOut, bool fromMain)
+{
+   pOut->clear();
+   ExecCommand(*pIn, fromMain,
+      [pOut](const wxString &chunk){ *pOut += chunk; });
    return 0;
 }
 
@@ -92,6 +103,72 @@ void ScriptCommandRelay::StartScriptServer(tpRegScriptServerFunc scriptFn)
    std::thread(server, scriptFn).detach();
 }
 
+void ScriptCommandRelay::ExecStreaming(const wxString &command,
+   const std::function<void(const wxString &)> &write)
+{
+   ExecCommand(command, false, write);
+}
+
+/// Finds a wave track channel by its index among all channels
+static WaveTrack *FindChannel(TenacityProject &project, long channel)
+{
+   long j = 0; // channel counter
+   for (auto t : TrackList::Get(project).Leaders())
+   {
+      for (auto pChannel : TrackList::Channels(t))
+      {
+         if (j++ == channel)
+            return track_cast<WaveTrack *>(pChannel);
+      }
+   }
+   return nullptr;
+}
+
+/// Runs an action on the active project in the main thread and waits for it;
+/// rethrows what the action throws
+template<typename Action>
+static bool DoInMainThread(const Action &action)
+{
+   std::promise<bool> promise;
+   auto future = promise.get_future();
+   BasicUI::CallAfter([&]{
+      try {
+         auto pProject = ::GetActiveProject().lock();
+         promise.set_value(pProject && action(*pProject));
+      }
+      catch (...) {
+         // Don't let exceptions escape to the event loop; rethrow them to
+         // the waiting thread instead
+         promise.set_exception(std::current_exception());
+      }
+   });
+   return future.get();
+}
+
+bool ScriptCommandRelay::GetSamples(
+   long channel, long long start, size_t len, float *buffer)
+{
+   return DoInMainThread([&](TenacityProject &project){
+      auto pTrack = FindChannel(project, channel);
+      return pTrack && pTrack->GetFloats(buffer, start, len);
+   });
+}
+
+bool ScriptCommandRelay::SetSamples(
+   long channel, long long start, size_t len, const float *buffer)
+{
+   return DoInMainThread([&](TenacityProject &project){
+      auto pTrack = FindChannel(project, channel);
+      if (!pTrack)
+         return false;
+      pTrack->Set(reinterpret_cast<constSamplePtr>(buffer),
+         floatSample, start, len);
+      ProjectHistory::Get(project).PushState(
+         XO("Set samples by script"), XO("Set Samples"), UndoPush::CONSOLIDATE);
+      return true;
+   });
+}
+
 #ifdef USE_NYQUIST
 
 // FIXME: Why is this mixing private libnyquist symbols with wxString???????
@@ -18,6 +18,8 @@
 
 
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 
 class wxString;
@@ -29,6 +31,32 @@ class TENACITY_DLL_API ScriptCommandRelay
 {
 public:
    static void StartScriptServer(tpRegScriptServerFunc scriptFn);
+
+   //! Execute a command from a thread other than the main thread
+   /*! Unlike the registered server function, passes the response to write in
+    pieces while the command runs, so a long response need not be kept whole.
+    Returns when the response is complete. */
+   static void ExecStreaming(const wxString &command,
+      const std::function<void(const wxString &)> &write);
+
+   //! Copy samples of a wave track channel of the active project
+   /*! May be called from any thread; the copy is made on the main thread.
+    @param channel counts the channels of all tracks, like the Channel
+    parameter of scripting commands
+    @return false if there is no such channel or the read failed
+    @throws what the read throws, such as for a missing block file */
+   static bool GetSamples(
+      long channel, long long start, size_t len, float *buffer);
+
+   //! Overwrite samples of a wave track channel of the active project
+   /*! May be called from any thread; the change is made on the main thread.
+    Successive calls are consolidated into one undo state.
+    @param channel counts the channels of all tracks, like the Channel
+    parameter of scripting commands
+    @return false if there is no such channel
+    @throws what the write throws, such as for a full disk */
+   static bool SetSamples(
+      long channel, long long start, size_t len, const float *buffer);
 };
 
 // The void * return is actually a Lisp LVAL and will be cast to such as needed.
@@ -37,6 +37,7 @@ explicitly code all three.
 
 #include "LoadCommands.h"
 #include "../ProjectSelectionManager.h"
+#include "../ProjectWindow.h"
 #include "../TrackPanel.h"
 #include "../shuttle/Shuttle.h"
 #include "../shuttle/ShuttleGui.h"
@@ -92,7 +93,9 @@ void SelectTimeCommand::PopulateOrExchange(ShuttleGui & S)
 bool SelectTimeCommand::Apply(const CommandContext & context){
    // Many commands need focus on track panel.
    // No harm in setting it with a scripted select.
-   TrackPanel::Get( context.project ).SetFocus();
+   // There is no track panel in headless mode.
+   if( ProjectWindow::Find( &context.project ) )
+      TrackPanel::Get( context.project ).SetFocus();
    if( !bHasT0 && !bHasT1 )
       return true;
 
@@ -31,6 +31,9 @@
 // Tenacity libraries
 #include <lib-track/Envelope.h>
 
+#include <algorithm>
+#include <wx/tokenzr.h>
+
 const ComponentInterfaceSymbol SetEnvelopeCommand::Symbol
 { XO("Set Envelope") };
 
@@ -46,6 +49,7 @@ bool SetEnvelopeCommand::DefineParams( ShuttleParams & S ){
    S.OptionalY( bHasT              ).Define(  mT,              wxT("Time"),     0.0, 0.0, 100000.0);
    S.OptionalY( bHasV              ).Define(  mV,              wxT("Value"),    1.0, 0.0, 2.0);
    S.OptionalN( bHasDelete         ).Define(  mbDelete,        wxT("Delete"),   false );
+   S.OptionalN( bHasPoints         ).Define(  mPoints,         wxT("Points"),   wxString{} );
    return true;
 };
 
@@ -58,15 +62,45 @@ void SetEnvelopeCommand::PopulateOrExchange(ShuttleGui & S)
       S.Optional( bHasT           ).TieNumericTextBox(  XXO("Time:"),          mT );
       S.Optional( bHasV           ).TieNumericTextBox(  XXO("Value:"),         mV );
       S.Optional( bHasDelete      ).TieCheckBox(        XXO("Delete"),         mbDelete );
+      S.Optional( bHasPoints      ).TieTextBox(         XXO("Points:"),        mPoints );
    }
    S.EndMultiColumn();
 }
 
+// Points are pairs of time and value, separated by spaces, as in
+// "0.5,1 1.5,0.25"
+static bool ParsePoints( const wxString &str, std::vector<EnvPoint> &points )
+{
+   wxStringTokenizer tokens{ str, wxT(" \t\n"), wxTOKEN_STRTOK };
+   while( tokens.HasMoreTokens() ){
+      const auto token = tokens.GetNextToken();
+      double t, v;
+      if( !token.BeforeFirst( ',' ).ToCDouble( &t ) ||
+          !token.AfterFirst( ',' ).ToCDouble( &v ) )
+         return false;
+      points.emplace_back( t, v );
+   }
+   return true;
+}
+
 bool SetEnvelopeCommand::ApplyInner( const CommandContext &context, Track * t )
 {
+   std::vector<EnvPoint> points;
+   if( bHasPoints ){
+      if( !ParsePoints( mPoints, points ) ){
+         context.Error( wxT("Points must be pairs of time,value.") );
+         return false;
+      }
+      // Stable, so that of several points at one time, the last one wins
+      std::stable_sort( points.begin(), points.end(),
+         []( const EnvPoint &point1, const EnvPoint &point2 )
+            { return point1.GetT() < point2.GetT(); } );
+   }
+
    // if no time is specified, then
    //   - delete deletes any envelope in selected tracks.
    //   - value is not set for any clip
+   bool didSomething = false;
    t->TypeSwitch([&](WaveTrack *waveTrack) {
       WaveClipPointers ptrs( waveTrack->SortedClipArray());
       for(auto it = ptrs.begin(); (it != ptrs.end()); it++ ){
@@ -80,22 +114,38 @@ bool SetEnvelopeCommand::ApplyInner( const CommandContext &context, Track * t )
          {
             // Inside this IF is where we actually apply the command
             Envelope* pEnv = pClip->GetEnvelope();
-            bool didSomething = false;
             if( bHasDelete && mbDelete )
                pEnv->Clear(), didSomething = true;
             if( bHasT && bHasV )
                pEnv->InsertOrReplace( mT, pEnv->ClampValue( mV ) ),
                didSomething = true;
-
-            if (didSomething)
-               // Consolidate, because this ApplyInner() function may be
-               // visited multiple times in one command invocation
-               ProjectHistory::Get(context.project).PushState(
-                  XO("Edited Envelope"), XO("Envelope"),
-                  UndoPush::CONSOLIDATE);
+            if( bHasPoints ){
+               // The points within the clip, all inserted together
+               const auto compare = []( const EnvPoint &point1,
+                  const EnvPoint &point2 ){ return point1.GetT() < point2.GetT(); };
+               const auto begin = std::lower_bound( points.begin(), points.end(),
+                  EnvPoint{ pClip->GetPlayStartTime(), 0.0 }, compare );
+               const auto end = std::upper_bound( begin, points.end(),
+                  EnvPoint{ pClip->GetPlayEndTime(), 0.0 }, compare );
+               std::vector<EnvPoint> inClip;
+               inClip.reserve( end - begin );
+               for( auto point = begin; point != end; ++point )
+                  inClip.emplace_back(
+                     point->GetT(), pEnv->ClampValue( point->GetVal() ) );
+               if( !inClip.empty() )
+                  pEnv->InsertOrReplaceMany( std::move( inClip ) ),
+                  didSomething = true;
+            }
          }
       }
    } );
 
+   if (didSomething)
+      // Consolidate, because this ApplyInner() function may be
+      // visited multiple times in one command invocation
+      ProjectHistory::Get(context.project).PushState(
+         XO("Edited Envelope"), XO("Envelope"),
+         UndoPush::CONSOLIDATE);
+
    return true;
 }
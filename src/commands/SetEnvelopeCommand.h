@@ -38,10 +38,13 @@ public:
    double mT;
    double mV;
    bool mbDelete;
+   // Many points at once, as "time,value" pairs separated by spaces
+   wxString mPoints;
 
    bool bHasT;
    bool bHasV;
    bool bHasDelete;
+   bool bHasPoints;
 };
 
 
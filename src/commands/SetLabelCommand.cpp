@@ -29,6 +29,8 @@
 #include "CommandContext.h"
 #include "../tracks/labeltrack/ui/LabelTrackView.h"
 
+#include <wx/tokenzr.h>
+
 const ComponentInterfaceSymbol SetLabelCommand::Symbol
 { XO("Set Label") };
 
@@ -130,3 +132,83 @@ bool SetLabelCommand::Apply(const CommandContext & context)
 
    return true;
 }
+
+const ComponentInterfaceSymbol AddLabelsCommand::Symbol
+{ XO("Add Labels") };
+
+namespace{ BuiltinCommandsModule::Registration< AddLabelsCommand > reg2; }
+
+AddLabelsCommand::AddLabelsCommand()
+{
+}
+
+bool AddLabelsCommand::DefineParams( ShuttleParams & S ){
+   S.Define(    mLabels,                                wxT("Labels"),     wxString{} );
+   S.OptionalN( bHasTrackIndex ).Define(  mTrackIndex,  wxT("Track"),      0, 0, 100000 );
+   return true;
+};
+
+void AddLabelsCommand::PopulateOrExchange(ShuttleGui & S)
+{
+   S.AddSpace(0, 5);
+
+   S.StartMultiColumn(2, wxALIGN_CENTER);
+   {
+      S.TieTextBox( XXO("Labels:"), mLabels );
+   }
+   S.EndMultiColumn();
+   S.StartMultiColumn(3, wxALIGN_CENTER);
+   {
+      S.Optional( bHasTrackIndex ).TieNumericTextBox(  XXO("Track:"),    mTrackIndex );
+   }
+   S.EndMultiColumn();
+}
+
+bool AddLabelsCommand::Apply(const CommandContext & context)
+{
+   LabelArray labels;
+   wxStringTokenizer lines{ mLabels, wxT("\n"), wxTOKEN_STRTOK };
+   while ( lines.HasMoreTokens() ) {
+      const auto line = lines.GetNextToken();
+      const auto rest = line.AfterFirst( '\t' );
+      double t0, t1;
+      if ( !line.BeforeFirst( '\t' ).ToCDouble( &t0 ) ||
+           !rest.BeforeFirst( '\t' ).ToCDouble( &t1 ) ) {
+         context.Error( wxT("Label was badly formed: ") + line );
+         return false;
+      }
+      labels.emplace_back(
+         SelectedRegion{ std::min( t0, t1 ), std::max( t0, t1 ) },
+         rest.AfterFirst( '\t' ) );
+   }
+   if ( labels.empty() )
+      return true;
+
+   auto &tracks = TrackList::Get( context.project );
+   LabelTrack *labelTrack = nullptr;
+   if ( bHasTrackIndex ) {
+      int ii = 0;
+      for ( auto t : tracks.Leaders() )
+         if ( ii++ == mTrackIndex ) {
+            labelTrack = track_cast<LabelTrack *>( t );
+            break;
+         }
+      if ( !labelTrack ) {
+         context.Error(wxT("Track was not a label track."));
+         return false;
+      }
+   }
+   else {
+      labelTrack = *tracks.Any<LabelTrack>().begin();
+      if ( !labelTrack )
+         labelTrack = LabelTrack::New( context.project );
+   }
+
+   // All in one undo state, rather than one per label
+   labelTrack->AddLabels( std::move( labels ) );
+
+   ProjectHistory::Get(context.project).PushState(
+      XO("Added Labels"), XO("Labels"));
+
+   return true;
+}
@@ -52,5 +52,32 @@ public:
    bool bHasSelected;
 };
 
+class AddLabelsCommand : public AudacityCommand
+{
+public:
+   static const ComponentInterfaceSymbol Symbol;
+
+   AddLabelsCommand();
+   // ComponentInterface overrides
+   ComponentInterfaceSymbol GetSymbol() override {return Symbol;};
+   TranslatableString GetDescription() override {return XO("Adds many labels at once.");};
+   bool DefineParams( ShuttleParams & S ) override;
+   void PopulateOrExchange(ShuttleGui & S) override;
+
+   // AudacityCommand overrides
+   ManualPageID ManualPage() override {return L"Extra_Menu:_Scriptables_I#add_labels";}
+
+   bool Apply(const CommandContext & context) override;
+
+public:
+   // One label per line, with start, end and text separated by tabs, as in
+   // exported label files
+   wxString mLabels;
+   // index of a label track among all tracks
+   int mTrackIndex;
+
+// For tracking optional parameters.
+   bool bHasTrackIndex;
+};
 
 #endif /* End of include guard: __SETTRACKINFOCOMMAND__ */
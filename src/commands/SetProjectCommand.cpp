@@ -22,6 +22,8 @@
 
 #include "LoadCommands.h"
 #include "Project.h"
+#include "ProjectRate.h"
+#include "../HeadlessMode.h"
 #include "../ProjectWindows.h"
 #include "../WaveTrack.h"
 #include "../shuttle/Shuttle.h"
@@ -75,6 +77,22 @@ void SetProjectCommand::PopulateOrExchange(ShuttleGui & S)
 bool SetProjectCommand::Apply(const CommandContext & context)
 {
    auto &project = context.project;
+
+   // Without windows only the rate can be set
+   if( HeadlessMode::IsEnabled() )
+   {
+      if( bHasName || bHasSizing )
+      {
+         context.Error(
+            HeadlessMode::Unsupported( XO("Setting the project window") )
+               .Translation() );
+         return false;
+      }
+      if( bHasRate && mRate >= 1 && mRate <= 1000000 )
+         ProjectRate::Get( project ).SetRate( mRate );
+      return true;
+   }
+
    auto &window = GetProjectFrame( project );
    if( bHasName )
       window.SetLabel(mName);
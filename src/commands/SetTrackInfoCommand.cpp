@@ -38,6 +38,7 @@ SetTrackAudioCommand and SetTrackVisualsCommand.
 
 #include "LoadCommands.h"
 #include "Project.h"
+#include "../ProjectWindow.h"
 #include "../TrackPanelAx.h"
 #include "../TrackPanel.h"
 #include "../WaveTrack.h"
@@ -434,8 +435,8 @@ bool SetTrackVisualsCommand::ApplyInner(const CommandContext & context, Track *
          mVZoomTop = c + ZOOMLIMIT / 2.0;
       }
       wt->SetDisplayBounds(mVZoomBottom, mVZoomTop);
-      auto &tp = TrackPanel::Get( context.project );
-      tp.UpdateVRulers();
+      if( ProjectWindow::Find( &context.project ) )
+         TrackPanel::Get( context.project ).UpdateVRulers();
    }
 
    if( wt && bHasUseSpecPrefs   ){
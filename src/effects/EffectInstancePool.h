@@ -0,0 +1,127 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file EffectInstancePool.h
+
+ Keeps warm plug-in processing instances between invocations
+
+ *********************************************************************/
+
+#ifndef __TENACITY_EFFECT_INSTANCE_POOL__
+#define __TENACITY_EFFECT_INSTANCE_POOL__
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <utility>
+
+//! Bounded pool of idle plug-in instances, keyed by sample rate
+/*!
+ Instantiating a plug-in (LADSPA instantiate, lilv_plugin_instantiate...)
+ can be far more costly than processing a short selection, and batch
+ processing repeats that for every file.  Effects return instances here
+ instead of destroying them, in a deactivated state, and the next
+ ProcessInitialize or RealtimeAddProcessor at the same rate takes one back
+ and reactivates it, which plug-in APIs define as a full reset.
+
+ The pool holds at most a fixed number of idle instances; the oldest is
+ destroyed when that is exceeded.
+
+ Not thread safe:  use it only from the thread that initializes and
+ finalizes processing.
+ */
+template< typename Handle > class EffectInstancePool
+{
+public:
+   //! Destroys an idle instance that the pool no longer wants
+   using Deleter = std::function< void(Handle) >;
+
+   struct Statistics
+   {
+      size_t hits{ 0 };       //!< Acquisitions served from the pool
+      size_t misses{ 0 };     //!< Acquisitions needing a new instance
+      size_t evictions{ 0 };  //!< Idle instances destroyed for capacity
+   };
+
+   static constexpr size_t DefaultCapacity = 4;
+
+   explicit EffectInstancePool(
+      Deleter deleter, size_t capacity = DefaultCapacity )
+      : mDeleter{ std::move(deleter) }
+      , mCapacity{ capacity }
+   {}
+
+   EffectInstancePool( const EffectInstancePool& ) = delete;
+   EffectInstancePool &operator= ( const EffectInstancePool& ) = delete;
+
+   ~EffectInstancePool() { Clear(); }
+
+   //! Take an idle instance made for the given rate
+   /*! @return a default-constructed (null) Handle on a miss; the caller then
+    makes a NEW instance and may Release() it later */
+   Handle Acquire( double rate )
+   {
+      for (auto iter = mIdle.rbegin(), end = mIdle.rend(); iter != end; ++iter)
+      {
+         if (iter->first == rate)
+         {
+            auto handle = iter->second;
+            mIdle.erase(std::next(iter).base());
+            ++mStatistics.hits;
+            return handle;
+         }
+      }
+      ++mStatistics.misses;
+      return Handle{};
+   }
+
+   //! Give back a deactivated instance made for the given rate
+   void Release( double rate, Handle handle )
+   {
+      if (!handle)
+         return;
+      mIdle.emplace_back(rate, handle);
+      Trim();
+   }
+
+   //! Destroy all idle instances; statistics are kept
+   void Clear()
+   {
+      while (!mIdle.empty())
+      {
+         auto handle = mIdle.front().second;
+         mIdle.pop_front();
+         mDeleter(handle);
+      }
+   }
+
+   void SetCapacity( size_t capacity )
+   {
+      mCapacity = capacity;
+      Trim();
+   }
+
+   size_t GetIdleCount() const { return mIdle.size(); }
+   const Statistics &GetStatistics() const { return mStatistics; }
+
+private:
+   void Trim()
+   {
+      while (mIdle.size() > mCapacity)
+      {
+         auto oldest = mIdle.front().second;
+         mIdle.pop_front();
+         ++mStatistics.evictions;
+         mDeleter(oldest);
+      }
+   }
+
+   Deleter mDeleter;
+   size_t mCapacity;
+   //! Least recently released at the front
+   std::deque< std::pair< double, Handle > > mIdle;
+   Statistics mStatistics;
+};
+
+#endif
@@ -1221,12 +1221,14 @@ wxDialog *EffectUI::DialogFactory( wxWindow &parent,
 {
    TenacityProject &project = context.project;
    auto &tracks = TrackList::Get( project );
-   auto &trackPanel = TrackPanel::Get( project );
    auto &trackFactory = WaveTrackFactory::Get( project );
    auto rate = ProjectRate::Get(project).GetRate();
    auto &selectedRegion = ViewInfo::Get( project ).selectedRegion;
    auto &commandManager = CommandManager::Get( project );
-   auto &window = ProjectWindow::Get( project );
+   // Null in headless mode, which allows only configured effects
+   auto pWindow = ProjectWindow::Find( &project );
+   if (!pWindow && !(flags & EffectManager::kConfigured))
+      return false;
 
    const PluginDescriptor *plug = PluginManager::Get().GetPlugin(ID);
    if (!plug)
@@ -1256,7 +1258,7 @@ wxDialog *EffectUI::DialogFactory( wxWindow &parent,
    bool success = false;
    auto cleanup = finally( [&] {
 
-      if (!success) {
+      if (!success && pWindow) {
          // For now, we're limiting realtime preview to a single effect, so
          // make sure the menus reflect that fact that one may have just been
          // opened.
@@ -1283,7 +1285,7 @@ wxDialog *EffectUI::DialogFactory( wxWindow &parent,
          &trackFactory,
          selectedRegion,
          flags,
-         &window,
+         pWindow,
          (flags & EffectManager::kConfigured) == 0
             ? DialogFactory
             : nullptr
@@ -1342,6 +1344,12 @@ wxDialog *EffectUI::DialogFactory( wxWindow &parent,
       }
    }
 
+   // Nothing is shown in headless mode
+   if (!pWindow)
+      return true;
+   auto &window = *pWindow;
+   auto &trackPanel = TrackPanel::Get( project );
+
    //STM:
    //The following automatically re-zooms after sound was generated.
    // IMO, it was disorienting, removing to try out without re-fitting
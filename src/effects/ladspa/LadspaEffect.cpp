@@ -602,6 +602,10 @@ BEGIN_EVENT_TABLE(LadspaEffect, wxEvtHandler)
 END_EVENT_TABLE()
 
 LadspaEffect::LadspaEffect(const wxString & path, int index)
+   : mInstancePool{ [this](LADSPA_Handle handle){
+      // Pooled instances are already deactivated
+      mData->cleanup(handle);
+   } }
 {
    mPath = path;
    mIndex = index;
@@ -609,6 +613,7 @@ LadspaEffect::LadspaEffect(const wxString & path, int index)
 
    mHost = NULL;
    mMaster = NULL;
+   mMasterRate = 0;
    mReady = false;
 
    mInteractive = false;
@@ -627,6 +632,12 @@ LadspaEffect::LadspaEffect(const wxString & path, int index)
 
 LadspaEffect::~LadspaEffect()
 {
+   const auto &stats = mInstancePool.GetStatistics();
+   if (stats.hits + stats.misses > 0)
+   {
+      wxLogDebug(wxT("%s: instance pool reused %zu of %zu, evicted %zu"),
+         GetPath(), stats.hits, stats.hits + stats.misses, stats.evictions);
+   }
 }
 
 // ============================================================================
@@ -935,7 +946,8 @@ bool LadspaEffect::ProcessInitialize(sampleCount /* totalLen */, ChannelNames /*
    /* Instantiate the plugin */
    if (!mReady)
    {
-      mMaster = InitInstance(mSampleRate);
+      mMasterRate = mSampleRate;
+      mMaster = AcquireInstance(mMasterRate);
       if (!mMaster)
       {
          return false;
@@ -954,7 +966,7 @@ bool LadspaEffect::ProcessFinalize()
    {
       mReady = false;
 
-      FreeInstance(mMaster);
+      ReleaseInstance(mMasterRate, mMaster);
       mMaster = NULL;
    }
 
@@ -989,13 +1001,14 @@ bool LadspaEffect::RealtimeInitialize()
 
 bool LadspaEffect::RealtimeAddProcessor(unsigned /* numChannels */, float sampleRate)
 {
-   LADSPA_Handle slave = InitInstance(sampleRate);
+   LADSPA_Handle slave = AcquireInstance(sampleRate);
    if (!slave)
    {
       return false;
    }
 
    mSlaves.push_back(slave);
+   mSlaveRates.push_back(sampleRate);
 
    return true;
 }
@@ -1005,9 +1018,10 @@ bool LadspaEffect::RealtimeFinalize() noexcept
 return GuardedCall<bool>([&]{
    for (size_t i = 0, cnt = mSlaves.size(); i < cnt; i++)
    {
-      FreeInstance(mSlaves[i]);
+      ReleaseInstance(mSlaveRates[i], mSlaves[i]);
    }
    mSlaves.clear();
+   mSlaveRates.clear();
 
    return true;
 });
@@ -1585,6 +1599,9 @@ bool LadspaEffect::Load()
 
 void LadspaEffect::Unload()
 {
+   // Pooled instances refer to code in the library
+   mInstancePool.Clear();
+
    if (mLib.IsLoaded())
    {
       mLib.Unload();
@@ -1670,6 +1687,34 @@ void LadspaEffect::FreeInstance(LADSPA_Handle handle)
    mData->cleanup(handle);
 }
 
+LADSPA_Handle LadspaEffect::AcquireInstance(float sampleRate)
+{
+   LADSPA_Handle handle = mInstancePool.Acquire(sampleRate);
+   if (!handle)
+   {
+      return InitInstance(sampleRate);
+   }
+
+   // Control ports remain connected to mInputControls and mOutputControls;
+   // activation after deactivation resets the plugin's internal state
+   if (mData->activate)
+   {
+      mData->activate(handle);
+   }
+
+   return handle;
+}
+
+void LadspaEffect::ReleaseInstance(float sampleRate, LADSPA_Handle handle)
+{
+   if (mData->deactivate)
+   {
+      mData->deactivate(handle);
+   }
+
+   mInstancePool.Release(sampleRate, handle);
+}
+
 void LadspaEffect::OnCheckBox(wxCommandEvent & evt)
 {
    int p = evt.GetId() - ID_Toggles;
@@ -25,6 +25,7 @@ class NumericTextCtrl;
 
 #include "PluginInterface.h"
 
+#include "../EffectInstancePool.h"
 #include "ladspa.h"
 
 #define LADSPAEFFECTS_VERSION wxT("1.0.0.0")
@@ -136,6 +137,11 @@ private:
    LADSPA_Handle InitInstance(float sampleRate);
    void FreeInstance(LADSPA_Handle handle);
 
+   // Reuse an idle instance from the pool, or make a NEW one
+   LADSPA_Handle AcquireInstance(float sampleRate);
+   // Deactivate the instance and keep it for later reuse
+   void ReleaseInstance(float sampleRate, LADSPA_Handle handle);
+
    void OnCheckBox(wxCommandEvent & evt);
    void OnSlider(wxCommandEvent & evt);
    void OnTextCtrl(wxCommandEvent & evt);
@@ -155,6 +161,7 @@ private:
    bool mReady;
 
    LADSPA_Handle mMaster;
+   float mMasterRate;
 
    double mSampleRate;
    size_t mBlockSize;
@@ -178,6 +185,11 @@ private:
 
    // Realtime processing
    std::vector<LADSPA_Handle> mSlaves;
+   std::vector<float> mSlaveRates;
+
+   // Idle, deactivated instances; declared after mLib and mData so that it
+   // is destroyed while the library is still loaded
+   EffectInstancePool<LADSPA_Handle> mInstancePool;
 
    NumericTextCtrl *mDuration;
    wxWeakRef<wxDialog> mDialog;
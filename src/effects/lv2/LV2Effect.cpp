@@ -37,7 +37,6 @@
 #include <wx/dialog.h>
 #include <wx/crt.h>
 #include <wx/log.h>
-#include <wx/msgqueue.h>
 
 #ifdef __WXMAC__
 #include <wx/evtloop.h>
@@ -358,12 +357,22 @@ BEGIN_EVENT_TABLE(LV2Effect, wxEvtHandler)
 END_EVENT_TABLE()
 
 LV2Effect::LV2Effect(const LilvPlugin *plug)
+   : mInstancePool{ [this](LV2Wrapper *wrapper){
+      // Pooled instances are already deactivated, so keep the wrapper's
+      // destructor from deactivating again and from clearing the flag that
+      // belongs to the master or slaves
+      auto activated = mActivated;
+      mActivated = false;
+      FreeInstance(wrapper);
+      mActivated = activated;
+   } }
 {
    mPlug = plug;
 
    mHost = NULL;
    mMaster = NULL;
    mProcess = NULL;
+   mProcessRate = 0;
    mSuilInstance = NULL;
 
    mSampleRate = 44100;
@@ -415,6 +424,12 @@ LV2Effect::LV2Effect(const LilvPlugin *plug)
 
 LV2Effect::~LV2Effect()
 {
+   const auto &stats = mInstancePool.GetStatistics();
+   if (stats.hits + stats.misses > 0)
+   {
+      wxLogDebug(wxT("%s: instance pool reused %zu of %zu, evicted %zu"),
+         GetPath(), stats.hits, stats.hits + stats.misses, stats.evictions);
+   }
 }
 
 // ============================================================================
@@ -1035,7 +1050,8 @@ size_t LV2Effect::GetTailSize()
 
 bool LV2Effect::ProcessInitialize(sampleCount /* totalLen */, ChannelNames /* chanMap */)
 {
-   mProcess = InitInstance(mSampleRate);
+   mProcessRate = mSampleRate;
+   mProcess = AcquireInstance(mProcessRate);
    if (!mProcess)
    {
       return false;
@@ -1058,7 +1074,12 @@ bool LV2Effect::ProcessFinalize()
 {
    if (mProcess)
    {
-      FreeInstance(mProcess);
+      if (mActivated)
+      {
+         lilv_instance_deactivate(mProcess->GetInstance());
+         mActivated = false;
+      }
+      ReleaseInstance(mProcessRate, mProcess);
       mProcess = NULL;
    }
 
@@ -1137,7 +1158,6 @@ size_t LV2Effect::ProcessBlock(
       }
       else
       {
-         port->mBuffer.resize(port->mMinimumSize);
          *(( LV2_Atom *) buf) =
          {
             port->mMinimumSize,
@@ -1154,8 +1174,6 @@ size_t LV2Effect::ProcessBlock(
    {
       if (!port->mIsInput)
       {
-         port->mBuffer.resize(port->mMinimumSize);
-
          LV2_Atom *chunk = ( LV2_Atom *) port->mBuffer.data();
          chunk->size = port->mMinimumSize;
          chunk->type = urid_Chunk;
@@ -1303,7 +1321,8 @@ bool LV2Effect::RealtimeProcessStart()
             else
             {
                zix_ring_skip(ring, atom.size);
-               wxLogError(wxT("LV2 sequence buffer overflow"));
+               // Don't log here; logging allocates and locks
+               ++mSequenceOverflows;
             }
          }
          lv2_atom_forge_pop(&mForge, &seqFrame);
@@ -1317,7 +1336,6 @@ bool LV2Effect::RealtimeProcessStart()
       }
       else
       {
-         port->mBuffer.resize(port->mMinimumSize);
          *((LV2_Atom *) buf) =
          {
             port->mMinimumSize,
@@ -1385,8 +1403,6 @@ size_t LV2Effect::RealtimeProcess(int group,
 
       if (!port->mIsInput)
       {
-         port->mBuffer.resize(port->mMinimumSize);
-
          LV2_Atom *chunk = ( LV2_Atom *) buf;
          chunk->size = port->mMinimumSize;
          chunk->type = urid_Chunk;
@@ -1989,6 +2005,31 @@ LV2Wrapper *LV2Effect::InitInstance(float sampleRate)
    wrapper->SetBlockSize();
    wrapper->SetSampleRate();
 
+   ConnectInstancePorts(instance);
+
+   // Give plugin a chance to initialize.  The SWH plugins (like AllPass) need
+   // this before it can be safely deleted.
+   lilv_instance_activate(instance);
+   lilv_instance_deactivate(instance);
+
+   for (auto & port : mAtomPorts)
+   {
+      if (!port->mIsInput)
+      {
+         ZixRing *ring = port->mRing;
+
+         LV2_ATOM_SEQUENCE_FOREACH(( LV2_Atom_Sequence *) port->mBuffer.data(), ev)
+         {
+            zix_ring_write(ring, &ev->body, ev->body.size + sizeof(LV2_Atom));
+         }
+      }
+   }
+
+   return wrapper;
+}
+
+void LV2Effect::ConnectInstancePorts(LilvInstance *instance)
+{
    // Connect all control ports
    for (auto & port : mControlPorts)
    {
@@ -2015,31 +2056,33 @@ LV2Wrapper *LV2Effect::InitInstance(float sampleRate)
    {
       lilv_instance_connect_port(instance, port->mIndex, port->mBuffer.get());
    }
+}
 
-   // Give plugin a chance to initialize.  The SWH plugins (like AllPass) need
-   // this before it can be safely deleted.
-   lilv_instance_activate(instance);
-   lilv_instance_deactivate(instance);
+void LV2Effect::FreeInstance(LV2Wrapper *wrapper)
+{
+   delete wrapper;
+}
 
-   for (auto & port : mAtomPorts)
+LV2Wrapper *LV2Effect::AcquireInstance(float sampleRate)
+{
+   LV2Wrapper *wrapper = mInstancePool.Acquire(sampleRate);
+   if (!wrapper)
    {
-      if (!port->mIsInput)
-      {
-         ZixRing *ring = port->mRing;
-
-         LV2_ATOM_SEQUENCE_FOREACH(( LV2_Atom_Sequence *) port->mBuffer.data(), ev)
-         {
-            zix_ring_write(ring, &ev->body, ev->body.size + sizeof(LV2_Atom));
-         }
-      }
+      return InitInstance(sampleRate);
    }
 
+   // The block size and the presence of a master may have changed since the
+   // instance was made; the caller's activation resets its internal state
+   wrapper->SetBlockSize();
+   wrapper->SetSampleRate();
+   ConnectInstancePorts(wrapper->GetInstance());
+
    return wrapper;
 }
 
-void LV2Effect::FreeInstance(LV2Wrapper *wrapper)
+void LV2Effect::ReleaseInstance(float sampleRate, LV2Wrapper *wrapper)
 {
-   delete wrapper;
+   mInstancePool.Release(sampleRate, wrapper);
 }
 
 bool LV2Effect::BuildFancy()
@@ -2751,6 +2794,12 @@ void LV2Effect::OnTimer(wxTimerEvent &evt)
 {
    evt.Skip();
 
+   if (auto overflows = mSequenceOverflows.exchange(0))
+   {
+      wxLogError(wxT("LV2 sequence buffer overflow (%u events dropped)"),
+                 overflows);
+   }
+
    if (mExternalWidget)
    {
       LV2_EXTERNAL_UI_RUN(mExternalWidget);
@@ -3262,6 +3311,16 @@ LV2Wrapper::LV2Wrapper(LV2Effect *effect)
    mFreeWheeling = false;
    mLatency = 0.0;
    mStopWorker = false;
+
+   mRequests = zix_ring_new(WorkerRingSize);
+   mResponses = zix_ring_new(WorkerRingSize);
+   mFreeWheelResponses = zix_ring_new(WorkerRingSize);
+   zix_ring_mlock(mRequests);
+   zix_ring_mlock(mResponses);
+   zix_ring_mlock(mFreeWheelResponses);
+   mRequestData.resize(zix_ring_capacity(mRequests));
+   mResponseData.resize(zix_ring_capacity(mResponses));
+   zix_sem_init(&mWorkAvailable, 0);
 }
 
 LV2Wrapper::~LV2Wrapper()
@@ -3272,9 +3331,7 @@ LV2Wrapper::~LV2Wrapper()
       if (thread && thread->IsAlive())
       {
          mStopWorker = true;
-
-         LV2Work work = {0, NULL};
-         mRequests.Post(work);
+         zix_sem_post(&mWorkAvailable);
 
          thread->Wait();
       }
@@ -3288,6 +3345,11 @@ LV2Wrapper::~LV2Wrapper()
       lilv_instance_free(mInstance);
       mInstance = NULL;
    }
+
+   zix_ring_free(mRequests);
+   zix_ring_free(mResponses);
+   zix_ring_free(mFreeWheelResponses);
+   zix_sem_destroy(&mWorkAvailable);
 }
 
 LilvInstance *LV2Wrapper::Instantiate(const LilvPlugin *plugin,
@@ -3423,20 +3485,25 @@ void LV2Wrapper::ConnectPorts(float **inbuf, float **outbuf)
 
 void *LV2Wrapper::Entry()
 {
-   LV2Work work;
-
-   while (mRequests.Receive(work) == wxMSGQUEUE_NO_ERROR)
+   while (zix_sem_wait(&mWorkAvailable) == ZIX_STATUS_SUCCESS)
    {
       if (mStopWorker)
       {
          break;
       }
 
+      // Each post follows a complete message
+      uint32_t size;
+      if (!ReadMessage(mRequests, mRequestData, size))
+      {
+         continue;
+      }
+
       mWorkerInterface->work(mHandle,
                              respond,
                              this,
-                             work.size,
-                             work.data);
+                             size,
+                             mRequestData.data());
    }
 
    return (void *) 0;
@@ -3446,11 +3513,16 @@ void LV2Wrapper::SendResponses()
 {
    if (mWorkerInterface)
    {
-      LV2Work work;
+      uint32_t size;
 
-      while (mResponses.ReceiveTimeout(0, work) == wxMSGQUEUE_NO_ERROR)
+      while (ReadMessage(mFreeWheelResponses, mResponseData, size))
       {
-         mWorkerInterface->work_response(mHandle, work.size, work.data);
+         mWorkerInterface->work_response(mHandle, size, mResponseData.data());
+      }
+
+      while (ReadMessage(mResponses, mResponseData, size))
+      {
+         mWorkerInterface->work_response(mHandle, size, mResponseData.data());
       }
 
       if (mWorkerInterface->end_run)
@@ -3460,6 +3532,37 @@ void LV2Wrapper::SendResponses()
    }
 }
 
+bool LV2Wrapper::ReadMessage(ZixRing *ring, std::vector<uint8_t> &buffer,
+                             uint32_t &size)
+{
+   // The writer may have stored the size but not yet the body
+   if (zix_ring_peek(ring, &size, sizeof(size)) != sizeof(size) ||
+       zix_ring_read_space(ring) < sizeof(size) + size)
+   {
+      return false;
+   }
+
+   zix_ring_skip(ring, sizeof(size));
+   zix_ring_read(ring, buffer.data(), size);
+
+   return true;
+}
+
+LV2_Worker_Status LV2Wrapper::WriteMessage(ZixRing *ring,
+                                           uint32_t size, const void *data)
+{
+   // The plugin's data is valid only during the call, so copy it
+   if (zix_ring_write_space(ring) < sizeof(size) + size)
+   {
+      return LV2_WORKER_ERR_NO_SPACE;
+   }
+
+   zix_ring_write(ring, &size, sizeof(size));
+   zix_ring_write(ring, data, size);
+
+   return LV2_WORKER_SUCCESS;
+}
+
 // static callback
 LV2_Worker_Status LV2Wrapper::schedule_work(LV2_Worker_Schedule_Handle handle,
                                            uint32_t size,
@@ -3472,18 +3575,25 @@ LV2_Worker_Status LV2Wrapper::ScheduleWork(uint32_t size, const void *data)
 {
    if (mFreeWheeling)
    {
+      // Work now, on this thread, which is then the only producer of the
+      // responses; the worker thread may still be responding to earlier
+      // requests in the other ring
       return mWorkerInterface->work(mHandle,
-                                    respond,
+                                    respond_free_wheeling,
                                     this,
                                     size,
                                     data);
    }
 
-   LV2Work work = {size, data};
-
-   mRequests.Post(work);
+   auto status = WriteMessage(mRequests, size, data);
+   if (status == LV2_WORKER_SUCCESS)
+   {
+      // Wakes the worker without taking a lock, so the processing thread
+      // never waits for it
+      zix_sem_post(&mWorkAvailable);
+   }
 
-   return LV2_WORKER_SUCCESS;
+   return status;
 }
 
 // static callback
@@ -3496,11 +3606,15 @@ LV2_Worker_Status LV2Wrapper::respond(LV2_Worker_Respond_Handle handle,
 
 LV2_Worker_Status LV2Wrapper::Respond(uint32_t size, const void *data)
 {
-   LV2Work work = {size, data};
-
-   mResponses.Post(work);
+   return WriteMessage(mResponses, size, data);
+}
 
-   return LV2_WORKER_SUCCESS;
+// static callback
+LV2_Worker_Status LV2Wrapper::respond_free_wheeling(
+   LV2_Worker_Respond_Handle handle, uint32_t size, const void *data)
+{
+   return WriteMessage(((LV2Wrapper *) handle)->mFreeWheelResponses,
+                       size, data);
 }
 
 #endif
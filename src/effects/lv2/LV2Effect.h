@@ -18,7 +18,6 @@ class wxArrayString;
 #include <vector>
 
 #include <wx/event.h> // to inherit
-#include <wx/msgqueue.h>
 #include <wx/nativewin.h>
 #include <wx/thread.h>
 #include <wx/timer.h>
@@ -42,11 +41,14 @@ class wxArrayString;
 #include "../../shuttle/ShuttleGui.h"
 #include "SampleFormat.h"
 
+#include "../EffectInstancePool.h"
 #include "LoadLV2.h"
 
 #include "lv2_external_ui.h"
 #include "zix/ring.h"
+#include "zix/sem.h"
 
+#include <atomic>
 #include <unordered_map>
 
 #ifdef __WXGTK__
@@ -143,6 +145,8 @@ public:
    bool mIsMidi;
    bool mWantsPosition;
 
+   // Sized once, when the port is found, so that processing never
+   // reallocates it
    std::vector<uint8_t> mBuffer;
    ZixRing *mRing;
 };
@@ -348,6 +352,12 @@ private:
 
    LV2Wrapper *InitInstance(float sampleRate);
    void FreeInstance(LV2Wrapper *wrapper);
+   void ConnectInstancePorts(LilvInstance *instance);
+
+   // Reuse a deactivated instance from the pool, or make a NEW one
+   LV2Wrapper *AcquireInstance(float sampleRate);
+   // Keep a deactivated instance for later reuse
+   void ReleaseInstance(float sampleRate, LV2Wrapper *wrapper);
 
    static uint32_t uri_to_id(LV2_URI_Map_Callback_Data callback_data,
                              const char *map,
@@ -491,8 +501,13 @@ private:
    bool mRolling;
    bool mActivated;
 
+   // Counts events dropped by the processing thread for lack of room in an
+   // atom sequence; reported on the main thread
+   std::atomic<unsigned> mSequenceOverflows{ 0 };
+
    LV2Wrapper *mMaster;
    LV2Wrapper *mProcess;
+   float mProcessRate;
    std::vector<LV2Wrapper *> mSlaves;
 
    FloatBuffers mMasterIn, mMasterOut;
@@ -563,6 +578,10 @@ private:
    RegistryPaths mFactoryPresetNames;
    wxArrayString mFactoryPresetUris;
 
+   // Idle instances for offline processing; declared last so that it is
+   // destroyed first, while the rest of the effect is still intact
+   EffectInstancePool<LV2Wrapper *> mInstancePool;
+
    DECLARE_EVENT_TABLE()
 
    friend class LV2Wrapper;
@@ -589,11 +608,8 @@ inline wxString LilvString(LilvNode *node, bool free)
 class LV2Wrapper : public wxThreadHelper
 {
 public:
-   typedef struct LV2Work
-   {
-      uint32_t size;
-      const void *data;
-   } LV2Work;
+   //! Capacity in bytes of each of the worker request and response rings
+   static constexpr uint32_t WorkerRingSize = 16384;
 
 public:
    LV2Wrapper(LV2Effect *effect);
@@ -632,13 +648,32 @@ public:
 
    LV2_Worker_Status Respond(uint32_t size, const void *data);
 
+   //! Responds to work done on the processing thread when free-wheeling
+   static LV2_Worker_Status respond_free_wheeling(
+      LV2_Worker_Respond_Handle handle, uint32_t size, const void *data);
+
 private:
    LV2Effect *mEffect;
    LilvInstance *mInstance;
    LV2_Handle mHandle;
 
-   wxMessageQueue<LV2Work> mRequests;
-   wxMessageQueue<LV2Work> mResponses;
+   // Worker extension messages are copied, with a size prefix, into
+   // single-producer single-consumer rings, so that scheduling work and
+   // delivering responses never allocate on the processing thread
+   static bool ReadMessage(ZixRing *ring, std::vector<uint8_t> &buffer,
+                           uint32_t &size);
+   static LV2_Worker_Status WriteMessage(ZixRing *ring,
+                                         uint32_t size, const void *data);
+
+   ZixRing *mRequests;
+   ZixRing *mResponses;            // written only by the worker thread
+   ZixRing *mFreeWheelResponses;   // written only by the processing thread
+   std::vector<uint8_t> mRequestData;  // used only by the worker thread
+   std::vector<uint8_t> mResponseData; // used only by the processing thread
+
+   // Posted once for each complete message in mRequests, and once to stop
+   // the worker; posting neither locks nor blocks
+   ZixSem mWorkAvailable;
 
    // Options extension
    LV2_Options_Interface *mOptionsInterface;
@@ -652,7 +687,7 @@ private:
 
    float mLatency;
    bool mFreeWheeling;
-   bool mStopWorker;
+   std::atomic<bool> mStopWorker;
 };
 
 #endif
@@ -108,6 +108,10 @@ enum
 // Protect Nyquist from selections greater than 2^31 samples (bug 439)
 #define NYQ_MAX_LEN (std::numeric_limits<long>::max())
 
+// Number of the track's ideal-size blocks fetched by one read for the
+// input callback; Nyquist itself asks for much shorter runs
+#define NYQ_PREFETCH_BLOCKS 4
+
 #define UNINITIALIZED_CONTROL ((double)99999999.99)
 
 static const wxChar *KEY_Command = wxT("Command");
@@ -138,6 +142,10 @@ END_EVENT_TABLE()
 NyquistEffect::NyquistEffect(const wxString &fName)
 {
    mOutputTrack[0] = mOutputTrack[1] = nullptr;
+   for (size_t i = 0; i < 2; i++) {
+      mCurBufferCapacity[i] = mCurBufferLen[i] = 0;
+      mOutBufferCapacity[i] = mOutBufferLen[i] = 0;
+   }
 
    mAction = XO("Applying Nyquist Effect...");
    mIsPrompt = false;
@@ -834,6 +842,10 @@ bool NyquistEffect::Process()
    mFirstInGroup = true;
    Track *gtLast = NULL;
 
+   // Tracks are processed one at a time:  libnyquist keeps its interpreter,
+   // memory and callbacks in globals, so there can be only one in a process.
+   // Processing tracks in parallel would need helper processes, each with its
+   // own interpreter, and a protocol to exchange audio, output and progress.
    for (;
         bOnePassTool || pRange->first != pRange->second;
         (void) (!pRange || (++pRange->first, true))
@@ -1402,14 +1414,20 @@ bool NyquistEffect::ProcessOne()
       cmd += mCmd;
    }
 
-   // Put the fetch buffers in a clean initial state
-   for (size_t i = 0; i < mCurNumChannels; i++)
-      mCurBuffer[i].reset();
+   // Put the fetch and staging buffers in a clean initial state
+   for (size_t i = 0; i < 2; i++) {
+      mCurBufferLen[i] = 0;
+      mOutBufferLen[i] = 0;
+   }
 
    // Guarantee release of memory when done
    auto cleanup = finally( [&] {
-      for (size_t i = 0; i < mCurNumChannels; i++)
+      for (size_t i = 0; i < 2; i++) {
          mCurBuffer[i].reset();
+         mCurBufferCapacity[i] = mCurBufferLen[i] = 0;
+         mOutBuffer[i].reset();
+         mOutBufferCapacity[i] = mOutBufferLen[i] = 0;
+      }
    } );
 
    // Evaluate the expression, which may invoke the get callback, but often does
@@ -1577,7 +1595,8 @@ bool NyquistEffect::ProcessOne()
 
       // Clean the initial buffer states again for the get callbacks
       // -- is this really needed?
-      mCurBuffer[i].reset();
+      mCurBufferLen[i] = 0;
+      mOutBufferLen[i] = 0;
    }
 
    // Now fully evaluate the sound
@@ -1586,6 +1605,10 @@ bool NyquistEffect::ProcessOne()
       auto vr0 = valueRestorer( mOutputTrack[0], outputTrack[0].get() );
       auto vr1 = valueRestorer( mOutputTrack[1], outputTrack[1].get() );
       success = nyx_get_audio(StaticPutCallback, (void *)this);
+      if (success && !mpException) {
+         for (int i = 0; i < outChannels; i++)
+            FlushOutputBuffer(i);
+      }
    }
 
    // See if GetCallback found read errors
@@ -2440,40 +2463,44 @@ int NyquistEffect::StaticGetCallback(float *buffer, int channel,
 int NyquistEffect::GetCallback(float *buffer, int ch,
                                int64_t start, int64_t len, int64_t /* totlen */)
 {
-   if (mCurBuffer[ch]) {
-      if ((mCurStart[ch] + start) < mCurBufferStart[ch] ||
-          (mCurStart[ch] + start)+len >
-          mCurBufferStart[ch]+mCurBufferLen[ch]) {
-         mCurBuffer[ch].reset();
+   const auto pos = mCurStart[ch] + start;
+   if (mCurBufferLen[ch] > 0) {
+      if (pos < mCurBufferStart[ch] ||
+          pos + len > mCurBufferStart[ch] + mCurBufferLen[ch]) {
+         mCurBufferLen[ch] = 0;
       }
    }
 
-   if (!mCurBuffer[ch]) {
-      mCurBufferStart[ch] = (mCurStart[ch] + start);
-      mCurBufferLen[ch] = mCurTrack[ch]->GetBestBlockSize(mCurBufferStart[ch]);
+   if (mCurBufferLen[ch] == 0) {
+      // Read to the end of the current block, plus some whole blocks more,
+      // so that refills stay aligned with the track's sample blocks
+      size_t wanted = mCurTrack[ch]->GetBestBlockSize(pos) +
+         (NYQ_PREFETCH_BLOCKS - 1) * mCurTrack[ch]->GetIdealBlockSize();
+      wanted = std::max(wanted, (size_t) len);
+      wanted = limitSampleBufferSize( wanted, mCurStart[ch] + mCurLen - pos );
 
-      if (mCurBufferLen[ch] < (size_t) len) {
-         mCurBufferLen[ch] = mCurTrack[ch]->GetIdealBlockSize();
+      // Keep the allocation for later refills unless it is too small
+      if (wanted > mCurBufferCapacity[ch]) {
+         // C++20
+         // mCurBuffer[ch] = std::make_unique_for_overwrite(wanted);
+         mCurBuffer[ch] = Buffer{ safenew float[ wanted ] };
+         mCurBufferCapacity[ch] = wanted;
       }
 
-      mCurBufferLen[ch] =
-         limitSampleBufferSize( mCurBufferLen[ch],
-                                mCurStart[ch] + mCurLen - mCurBufferStart[ch] );
-
-      // C++20
-      // mCurBuffer[ch] = std::make_unique_for_overwrite(mCurBufferLen[ch]);
-      mCurBuffer[ch] = Buffer{ safenew float[ mCurBufferLen[ch] ] };
       try {
-         mCurTrack[ch]->GetFloats( mCurBuffer[ch].get(),
-            mCurBufferStart[ch], mCurBufferLen[ch]);
+         mCurTrack[ch]->GetFloats( mCurBuffer[ch].get(), pos, wanted );
       }
       catch ( ... ) {
          // Save the exception object for re-throw when out of the library
          mpException = std::current_exception();
          return -1;
       }
+      mCurBufferStart[ch] = pos;
+      mCurBufferLen[ch] = wanted;
    }
 
+   // libnyquist gives its own buffer to fill, so it can't be handed a
+   // pointer into ours; this copy is the only one after decoding.
    // We have guaranteed above that this is nonnegative and bounded by
    // mCurBufferLen[ch]:
    auto offset = ( mCurStart[ch] + start - mCurBufferStart[ch] ).as_size_t();
@@ -2521,12 +2548,39 @@ int NyquistEffect::PutCallback(float *buffer, int channel,
          }
       }
 
-      mOutputTrack[channel]->Append((samplePtr)buffer, floatSample, len);
+      auto &outBuffer = mOutBuffer[channel];
+      auto &outLen = mOutBufferLen[channel];
+      auto &capacity = mOutBufferCapacity[channel];
+      if (!outBuffer) {
+         capacity = mOutputTrack[channel]->GetIdealBlockSize();
+         outBuffer = Buffer{ safenew float[ capacity ] };
+         outLen = 0;
+      }
+
+      if (outLen + len > capacity)
+         FlushOutputBuffer(channel);
+
+      if ((size_t) len >= capacity)
+         mOutputTrack[channel]->Append((samplePtr)buffer, floatSample, len);
+      else {
+         std::memcpy(&outBuffer[outLen], buffer, len * sizeof(float));
+         outLen += len;
+      }
 
       return 0; // success
    }, MakeSimpleGuard( -1 ) ); // translate all exceptions into failure
 }
 
+void NyquistEffect::FlushOutputBuffer(int channel)
+{
+   if (mOutBufferLen[channel] > 0) {
+      mOutputTrack[channel]->Append(
+         (samplePtr)mOutBuffer[channel].get(), floatSample,
+         mOutBufferLen[channel]);
+      mOutBufferLen[channel] = 0;
+   }
+}
+
 void NyquistEffect::StaticOutputCallback(int c, void *This)
 {
    ((NyquistEffect *)This)->OutputCallback(c);
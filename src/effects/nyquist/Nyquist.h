@@ -159,6 +159,8 @@ private:
                    int64_t start, int64_t len, int64_t totlen);
    int PutCallback(float *buffer, int channel,
                    int64_t start, int64_t len, int64_t totlen);
+   // Append any output still held in mOutBuffer to mOutputTrack; may throw
+   void FlushOutputBuffer(int channel);
    void OutputCallback(int c);
    void OSCallback();
 
@@ -269,13 +271,21 @@ private:
    double            mProgressTot;
    double            mScale;
 
+   // Input prefetch buffers, reused for successive reads; the contents
+   // are valid only when mCurBufferLen is nonzero
    using Buffer = std::unique_ptr<float[]>;
    Buffer            mCurBuffer[2];
+   size_t            mCurBufferCapacity[2];
    sampleCount       mCurBufferStart[2];
    size_t            mCurBufferLen[2];
 
    WaveTrack        *mOutputTrack[2];
 
+   // Output staging buffers, so that many small puts become one Append
+   Buffer            mOutBuffer[2];
+   size_t            mOutBufferCapacity[2];
+   size_t            mOutBufferLen[2];
+
    wxArrayString     mCategories;
 
    wxString          mProps;
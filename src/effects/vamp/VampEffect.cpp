@@ -20,6 +20,13 @@
 #include <vamp-hostsdk/PluginChannelAdapter.h>
 #include <vamp-hostsdk/PluginInputDomainAdapter.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
 #include <wx/wxprec.h>
 #include <wx/button.h>
 #include <wx/checkbox.h>
@@ -341,6 +348,20 @@ bool VampEffect::Init()
    return true;
 }
 
+struct VampEffect::AnalysisJob
+{
+   const WaveTrack *left{};
+   const WaveTrack *right{};
+   unsigned channels{ 1 };
+   sampleCount start{ 0 };
+   sampleCount len{ 0 };
+
+   Vamp::Plugin::FeatureList features;
+
+   // Fraction done, written by the analyzing thread
+   std::atomic<double> progress{ 0.0 };
+};
+
 bool VampEffect::Process()
 {
    if (!mPlugin)
@@ -348,10 +369,7 @@ bool VampEffect::Process()
       return false;
    }
 
-   int count = 0;
-
    bool multiple = false;
-   unsigned prevTrackChannels = 0;
 
    if (GetNumWaveGroups() > 1)
    {
@@ -362,167 +380,272 @@ bool VampEffect::Process()
       multiple = true;
    }
 
+   size_t step = mPlugin->getPreferredStepSize();
+   size_t block = mPlugin->getPreferredBlockSize();
+
+   if (block == 0)
+   {
+      if (step != 0)
+      {
+         block = step;
+      }
+      else
+      {
+         block = 1024;
+      }
+   }
+
+   if (step == 0)
+   {
+      step = block;
+   }
+
+   auto leaders = inputTracks()->Leaders<const WaveTrack>();
+   std::vector<AnalysisJob> jobs(leaders.size());
    std::vector<std::shared_ptr<Effect::AddedAnalysisTrack>> addedTracks;
 
-   for (auto leader : inputTracks()->Leaders<const WaveTrack>())
+   auto pJob = jobs.begin();
+   for (auto leader : leaders)
    {
-      auto channelGroup = TrackList::Channels(leader);
-      auto left = *channelGroup.first++;
+      auto &job = *pJob++;
 
-      unsigned channels = 1;
+      auto channelGroup = TrackList::Channels(leader);
+      job.left = *channelGroup.first++;
 
       // channelGroup now contains all but the first channel
-      const WaveTrack *right =
-         channelGroup.size() ? *channelGroup.first++ : nullptr;
-      if (right)
-         channels = 2;
-
-      sampleCount start = 0;
-      sampleCount len = 0;
-      GetBounds(*left, right, &start, &len);
+      job.right = channelGroup.size() ? *channelGroup.first++ : nullptr;
+      if (job.right)
+         job.channels = 2;
 
       // TODO: more-than-two-channels
 
-      size_t step = mPlugin->getPreferredStepSize();
-      size_t block = mPlugin->getPreferredBlockSize();
+      GetBounds(*job.left, job.right, &job.start, &job.len);
 
-      bool initialiseRequired = true;
+      const auto effectName = GetSymbol().Translation();
+      addedTracks.push_back(AddAnalysisTrack(
+         multiple
+         ? wxString::Format( _("%s: %s"), job.left->GetName(), effectName )
+         : effectName
+      ));
+   }
 
-      if (block == 0)
-      {
-         if (step != 0)
-         {
-            block = step;
-         }
-         else
-         {
-            block = 1024;
-         }
-      }
+   // Each thread analyzes whole tracks with its own plug-in instance, so
+   // that results do not depend on the number of threads.  The main thread
+   // only reports progress and notices cancellation.
+   const size_t nThreads = std::min<size_t>(jobs.size(),
+      std::max(1u, std::thread::hardware_concurrency()));
 
-      if (step == 0)
-      {
-         step = block;
-      }
+   std::atomic<size_t> nextJob{ 0 };
+   std::atomic<size_t> nFinished{ 0 };
+   std::atomic<bool> cancelled{ false };
+   std::atomic<bool> failed{ false };
+   std::exception_ptr pException;
+   std::mutex exceptionMutex;
 
-      if (prevTrackChannels > 0)
+   auto work = [&]
+   {
+      std::unique_ptr<Vamp::Plugin> plugin;
+      unsigned pluginChannels = 0;
+      try
       {
-         // Plugin has already been initialised, so if the number of
-         // channels remains the same, we only need to do a reset.
-         // Otherwise we need to re-construct the whole plugin,
-         // because a Vamp plugin can't be re-initialised.
-         if (prevTrackChannels == channels)
+         while (!cancelled && !failed)
          {
-            mPlugin->reset();
-            initialiseRequired = false;
-         }
-         else
-         {
-            //!!! todo: retain parameters previously set
-            Init();
+            const size_t ii = nextJob++;
+            if (ii >= jobs.size())
+            {
+               break;
+            }
+            if (!AnalyzeTrack(jobs[ii], plugin, pluginChannels,
+                  step, block, cancelled))
+            {
+               failed = true;
+            }
          }
       }
-
-      if (initialiseRequired)
+      catch (...)
       {
-         if (!mPlugin->initialise(channels, step, block))
-         {
-            Effect::MessageBox(
-               XO("Sorry, Vamp Plug-in failed to initialize.") );
-            return false;
-         }
+         std::lock_guard<std::mutex> guard{ exceptionMutex };
+         if (!pException)
+            pException = std::current_exception();
+         failed = true;
       }
+      ++nFinished;
+   };
 
-      const auto effectName = GetSymbol().Translation();
-      addedTracks.push_back(AddAnalysisTrack(
-         multiple
-         ? wxString::Format( _("%s: %s"), left->GetName(), effectName )
-         : effectName
-      ));
-      LabelTrack *ltrack = addedTracks.back()->get();
+   std::vector<std::thread> threads;
+   for (size_t ii = 0; ii < nThreads; ++ii)
+      threads.emplace_back(work);
+
+   while (nFinished < nThreads)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+      double progress = 0.0;
+      for (auto &job : jobs)
+         progress += job.progress;
+      if (!cancelled && TotalProgress(progress / jobs.size()))
+         cancelled = true;
+   }
+
+   for (auto &thread : threads)
+      thread.join();
+
+   if (pException)
+      std::rethrow_exception(pException);
 
-      FloatBuffers data{ channels, block };
+   if (cancelled)
+      return false;
+
+   if (failed)
+   {
+      Effect::MessageBox(
+         XO("Sorry, Vamp Plug-in failed to initialize.") );
+      return false;
+   }
 
-      auto originalLen = len;
+   for (size_t ii = 0; ii < jobs.size(); ++ii)
+      AddFeatures(addedTracks[ii]->get(), jobs[ii].features);
 
-      auto pos = start;
+   // All completed without cancellation, so commit the addition of tracks now
+   for (auto &addedTrack : addedTracks)
+      addedTrack->Commit();
 
-      while (len != 0)
+   return true;
+}
+
+std::unique_ptr<Vamp::Plugin> VampEffect::MakeAnalysisPlugin()
+{
+   // The loader and the dialog's plug-in instance are shared by all
+   // analyzing threads
+   static std::mutex loaderMutex;
+   std::lock_guard<std::mutex> guard{ loaderMutex };
+
+   Vamp::HostExt::PluginLoader *loader = Vamp::HostExt::PluginLoader::getInstance();
+   std::unique_ptr<Vamp::Plugin> plugin{
+      loader->loadPlugin(mKey, mRate, Vamp::HostExt::PluginLoader::ADAPT_ALL) };
+   if (!plugin)
+   {
+      return {};
+   }
+
+   // Copy the settings that the user chose
+   if (!mPlugin->getPrograms().empty())
+   {
+      plugin->selectProgram(mPlugin->getCurrentProgram());
+   }
+
+   for (auto &param : mPlugin->getParameterDescriptors())
+   {
+      plugin->setParameter(param.identifier,
+         mPlugin->getParameter(param.identifier));
+   }
+
+   return plugin;
+}
+
+bool VampEffect::AnalyzeTrack(AnalysisJob &job,
+   std::unique_ptr<Vamp::Plugin> &plugin, unsigned &pluginChannels,
+   size_t step, size_t block, const std::atomic<bool> &cancelled)
+{
+   if (plugin && pluginChannels == job.channels)
+   {
+      // Plugin has already been initialised for the same number of
+      // channels, so we only need to do a reset.
+      plugin->reset();
+   }
+   else
+   {
+      // A Vamp plugin can't be re-initialised, so make another
+      plugin = MakeAnalysisPlugin();
+      pluginChannels = job.channels;
+      if (!plugin || !plugin->initialise(job.channels, step, block))
       {
-         const auto request = limitSampleBufferSize( block, len );
+         plugin.reset();
+         return false;
+      }
+   }
 
-         if (left)
-         {
-            left->GetFloats(data[0].get(), pos, request);
-         }
+   FloatBuffers data{ job.channels, block };
 
-         if (right)
-         {
-            right->GetFloats(data[1].get(), pos, request);
-         }
+   auto len = job.len;
+   auto pos = job.start;
 
-         if (request < block)
-         {
-            for (unsigned int c = 0; c < channels; ++c)
-            {
-               for (decltype(block) i = request; i < block; ++i)
-               {
-                  data[c][i] = 0.f;
-               }
-            }
-         }
+   // Number of samples at the front of data, starting at pos, that were
+   // already read for the previous overlapping window
+   size_t valid = 0;
 
-         // UNSAFE_SAMPLE_COUNT_TRUNCATION
-         // Truncation in case of very long tracks!
-         Vamp::RealTime timestamp = Vamp::RealTime::frame2RealTime(
-            long( pos.as_long_long() ),
-            (int)(mRate + 0.5)
-         );
+   while (len != 0)
+   {
+      if (cancelled)
+      {
+         return true;
+      }
 
-         Vamp::Plugin::FeatureSet features = mPlugin->process(
-            reinterpret_cast< float** >( data.get() ), timestamp);
-         AddFeatures(ltrack, features);
+      const auto request = limitSampleBufferSize( block, len );
 
-         if (len > (int)step)
+      if (valid < request)
+      {
+         job.left->GetFloats(data[0].get() + valid, pos + valid, request - valid);
+
+         if (job.right)
          {
-            len -= step;
+            job.right->GetFloats(data[1].get() + valid, pos + valid, request - valid);
          }
-         else
+      }
+
+      if (request < block)
+      {
+         for (unsigned int c = 0; c < job.channels; ++c)
          {
-            len = 0;
+            std::fill(data[c].get() + request, data[c].get() + block, 0.f);
          }
+      }
 
-         pos += step;
+      // UNSAFE_SAMPLE_COUNT_TRUNCATION
+      // Truncation in case of very long tracks!
+      Vamp::RealTime timestamp = Vamp::RealTime::frame2RealTime(
+         long( pos.as_long_long() ),
+         (int)(mRate + 0.5)
+      );
 
-         if (channels > 1)
-         {
-            if (TrackGroupProgress(count,
-                  (pos - start).as_double() /
-                  originalLen.as_double() ))
-            {
-               return false;
-            }
-         }
-         else
+      Vamp::Plugin::FeatureSet features = plugin->process(
+         reinterpret_cast< float** >( data.get() ), timestamp);
+      auto &list = features[mOutput];
+      job.features.insert(job.features.end(), list.begin(), list.end());
+
+      // Slide the overlap with the next window to the front
+      if (step < request)
+      {
+         valid = request - step;
+         for (unsigned int c = 0; c < job.channels; ++c)
          {
-            if (TrackProgress(count,
-                  (pos - start).as_double() /
-                  originalLen.as_double() ))
-            {
-               return false;
-            }
+            std::memmove(data[c].get(), data[c].get() + step, valid * sizeof(float));
          }
       }
+      else
+      {
+         valid = 0;
+      }
+
+      if (len > (int)step)
+      {
+         len -= step;
+      }
+      else
+      {
+         len = 0;
+      }
 
-      Vamp::Plugin::FeatureSet features = mPlugin->getRemainingFeatures();
-      AddFeatures(ltrack, features);
+      pos += step;
 
-      prevTrackChannels = channels;
+      job.progress = (pos - job.start).as_double() / job.len.as_double();
    }
 
-   // All completed without cancellation, so commit the addition of tracks now
-   for (auto &addedTrack : addedTracks)
-      addedTrack->Commit();
+   Vamp::Plugin::FeatureSet features = plugin->getRemainingFeatures();
+   auto &list = features[mOutput];
+   job.features.insert(job.features.end(), list.begin(), list.end());
+
+   job.progress = 1.0;
 
    return true;
 }
@@ -718,10 +841,9 @@ bool VampEffect::TransferDataFromWindow()
 // VampEffect implementation
 
 void VampEffect::AddFeatures(LabelTrack *ltrack,
-                             Vamp::Plugin::FeatureSet &features)
+                             const Vamp::Plugin::FeatureList &features)
 {
-   for (Vamp::Plugin::FeatureList::iterator fli = features[mOutput].begin();
-        fli != features[mOutput].end(); ++fli)
+   for (auto fli = features.begin(); fli != features.end(); ++fli)
    {
       Vamp::RealTime ftime0 = fli->timestamp;
       double ltime0 = ftime0.sec + (double(ftime0.nsec) / 1000000000.0);
@@ -15,6 +15,8 @@
 
 #if defined(USE_VAMP)
 
+#include <atomic>
+
 #include <vamp-hostsdk/PluginLoader.h>
 
 #include "../Effect.h"
@@ -76,7 +78,21 @@ public:
 private:
    // VampEffect implementation
 
-   void AddFeatures(LabelTrack *track, Vamp::Plugin::FeatureSet & features);
+   struct AnalysisJob;
+
+   // Make another instance of the plug-in with the current settings;
+   // may be called from any thread
+   std::unique_ptr<Vamp::Plugin> MakeAnalysisPlugin();
+
+   // Run one track through the plug-in, collecting its features in the job;
+   // reuses or replaces plugin, which was last initialised for
+   // pluginChannels channels; returns false if initialisation fails
+   bool AnalyzeTrack(AnalysisJob &job,
+      std::unique_ptr<Vamp::Plugin> &plugin, unsigned &pluginChannels,
+      size_t step, size_t block, const std::atomic<bool> &cancelled);
+
+   void AddFeatures(LabelTrack *track,
+      const Vamp::Plugin::FeatureList & features);
 
    void UpdateFromPlugin();
 
@@ -9,6 +9,7 @@
 // Tenacity libraries
 #include <lib-preferences/Prefs.h>
 #include <lib-project/Project.h>
+#include <lib-project/ProjectStatus.h>
 
 #include "../AdornedRulerPanel.h"
 #include "../Clipboard.h"
@@ -16,6 +17,7 @@
 #include "../LabelTrack.h"
 #include "../Menus.h"
 #include "../NoteTrack.h"
+#include "../ProjectAudioIO.h"
 #include "../ProjectHistory.h"
 #include "ProjectRate.h"
 #include "../ProjectSettings.h"
@@ -682,6 +684,16 @@ void OnDuplicate(const CommandContext &context)
    auto &selectedRegion = ViewInfo::Get( project ).selectedRegion;
    auto &window = ProjectWindow::Get( project );
 
+   // Only wave tracks join a playing stream
+   if (ProjectAudioIO::Get( project ).IsAudioActive() &&
+       tracks.Selected().size() != tracks.Selected<const WaveTrack>().size())
+   {
+      ProjectStatus::Get( project ).Set(
+         XO("Can't duplicate non-audio tracks with active audio"));
+      wxBell();
+      return;
+   }
+
    // This iteration is unusual because we add to the list inside the loop
    auto range = tracks.Selected();
    auto last = *range.rbegin();
@@ -1132,7 +1144,7 @@ BaseItemSharedPtr EditMenu()
             AudioIONotBusyFlag(), wxT("Ctrl+V") ),
          /* i18n-hint: (verb)*/
          Command( wxT("Duplicate"), XXO("Duplic&ate"), FN(OnDuplicate),
-                  AudioIONotBusyFlag() | EditableTracksSelectedFlag(), wxT("Ctrl+D") ),
+                  CaptureNotBusyFlag() | EditableTracksSelectedFlag(), wxT("Ctrl+D") ),
 
          Section( "",
             Menu( wxT("RemoveSpecial"), XXO("R&emove Special"),
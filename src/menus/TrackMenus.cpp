@@ -682,7 +682,21 @@ void OnResample(const CommandContext &context)
 
 void OnRemoveTracks(const CommandContext &context)
 {
-   TrackUtilities::DoRemoveTracks( context.project );
+   auto &project = context.project;
+   auto &tracks = TrackList::Get( project );
+
+   // The playing stream can let go of wave tracks, but it reads the warp
+   // of a time track as it plays
+   if (ProjectAudioIO::Get( project ).IsAudioActive() &&
+       tracks.Selected().size() != tracks.Selected<const WaveTrack>().size())
+   {
+      ProjectStatus::Get( project ).Set(
+         XO("Can't delete track with active audio"));
+      wxBell();
+      return;
+   }
+
+   TrackUtilities::DoRemoveTracks( project );
 }
 
 static void MuteTracks(const CommandContext &context, bool mute, bool selected)
@@ -1030,10 +1044,11 @@ BaseItemSharedPtr TracksMenu()
    Menu( wxT("Tracks"), XXO("&Tracks"),
       Section( "Add",
          Menu( wxT("Add"), XXO("Add &New"),
+            // Playback continues with the new track
             Command( wxT("NewMonoTrack"), XXO("&Mono Track"), FN(OnNewWaveTrack),
-               AudioIONotBusyFlag(), wxT("Ctrl+Shift+N") ),
+               CaptureNotBusyFlag(), wxT("Ctrl+Shift+N") ),
             Command( wxT("NewStereoTrack"), XXO("&Stereo Track"),
-               FN(OnNewStereoTrack), AudioIONotBusyFlag() ),
+               FN(OnNewStereoTrack), CaptureNotBusyFlag() ),
             Command( wxT("NewLabelTrack"), XXO("&Label Track"),
                FN(OnNewLabelTrack), AudioIONotBusyFlag() ),
             Command( wxT("NewTimeTrack"), XXO("&Time Track"),
@@ -1076,7 +1091,7 @@ BaseItemSharedPtr TracksMenu()
 
       Section( "",
          Command( wxT("RemoveTracks"), XXO("Remo&ve Tracks"), FN(OnRemoveTracks),
-            AudioIONotBusyFlag() | AnyTracksSelectedFlag() )
+            CaptureNotBusyFlag() | AnyTracksSelectedFlag() )
       ),
 
       Section( "",
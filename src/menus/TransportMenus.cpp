@@ -671,7 +671,7 @@ void OnUnlockPlayRegion(const CommandContext &context)
 
 void OnRescanDevices(const CommandContext &/* context */ )
 {
-   DeviceManager::Instance()->Rescan();
+   DeviceManager::Instance()->RescanInBackground();
 }
 
 void OnSoundActivated(const CommandContext &context)
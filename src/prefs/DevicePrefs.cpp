@@ -113,6 +113,7 @@ void DevicePrefs::GetNamesAndLabels()
    // Gather list of hosts.  Only added hosts that have devices attached.
    // FIXME: TRAP_ERR PaErrorCode not handled in DevicePrefs GetNamesAndLabels()
    // With an error code won't add hosts, but won't report a problem either.
+   DeviceManager::Instance()->WaitForRescan();
    int nDevices = Pa_GetDeviceCount();
    for (int i = 0; i < nDevices; i++) {
       const PaDeviceInfo *info = Pa_GetDeviceInfo(i);
@@ -215,6 +216,7 @@ void DevicePrefs::OnHost(wxCommandEvent & e)
    // Find the index for the host API selected
    int index = -1;
    auto apiName = mHostLabels[mHost->GetCurrentSelection()];
+   DeviceManager::Instance()->WaitForRescan();
    int nHosts = Pa_GetHostApiCount();
    for (int i = 0; i < nHosts; ++i) {
       wxString name = wxSafeConvertMB2WX(Pa_GetHostApiInfo(i)->name);
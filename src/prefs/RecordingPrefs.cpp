@@ -30,6 +30,7 @@
 #include <lib-preferences/Prefs.h>
 #include <lib-screen-geometry/Decibels.h>
 
+#include "../CaptureJournal.h"
 #include "../shuttle/ShuttleGui.h"
 
 using std::min;
@@ -112,6 +113,9 @@ void RecordingPrefs::PopulateOrExchange(ShuttleGui & S)
                      {WarningDialogKey(wxT("DropoutDetected")),
                       true});
 
+       S.TieCheckBox(XXO("&Keep a raw copy of recordings until saved, for crash recovery"),
+                     CaptureJournalEnabled);
+
 
    }
    S.EndStatic();
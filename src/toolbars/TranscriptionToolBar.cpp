@@ -584,6 +584,7 @@ void TranscriptionToolBar::OnStartOn(wxCommandEvent & /* event */)
       return;
    }
 
+   mVk->Forget();
    mVk->AdjustThreshold(GetSensitivity());
 
    auto t = *TrackList::Get( mProject ).Any< const WaveTrack >().begin();
@@ -615,6 +616,7 @@ void TranscriptionToolBar::OnStartOff(wxCommandEvent & /* event */)
       SetButton(false,mButtons[TTB_StartOff]);
       return;
    }
+   mVk->Forget();
    mVk->AdjustThreshold(GetSensitivity());
    TenacityProject *p = &mProject;
 
@@ -650,6 +652,7 @@ void TranscriptionToolBar::OnEndOn(wxCommandEvent & /* event */)
       return;
    }
 
+   mVk->Forget();
    mVk->AdjustThreshold(GetSensitivity());
    TenacityProject *p = &mProject;
    auto t = *TrackList::Get( mProject ).Any< const WaveTrack >().begin();
@@ -686,6 +689,7 @@ void TranscriptionToolBar::OnEndOff(wxCommandEvent & /* event */)
       SetButton(false,mButtons[TTB_EndOff]);
       return;
    }
+   mVk->Forget();
    mVk->AdjustThreshold(GetSensitivity());
    TenacityProject *p = &mProject;
 
@@ -724,6 +728,7 @@ void TranscriptionToolBar::OnSelectSound(wxCommandEvent & /* event */)
    }
 
 
+   mVk->Forget();
    mVk->AdjustThreshold(GetSensitivity());
 
 
@@ -762,6 +767,7 @@ void TranscriptionToolBar::OnSelectSilence(wxCommandEvent & /* event */)
       return;
    }
 
+   mVk->Forget();
    mVk->AdjustThreshold(GetSensitivity());
 
 
@@ -807,6 +813,7 @@ void TranscriptionToolBar::OnCalibrate(wxCommandEvent & /* event */)
       sampleCount start, len;
       GetSamples(wt, &start, &len);
 
+      mVk->Forget();
       mVk->CalibrateNoise(*wt, start, len);
       mVk->AdjustThreshold(3);
 
@@ -904,6 +911,7 @@ void TranscriptionToolBar::OnAutomateSelection(wxCommandEvent & /* event */)
 
    wxBusyCursor busy;
 
+   mVk->Forget();
    mVk->AdjustThreshold(GetSensitivity());
    TrackList *tl = &TrackList::Get( mProject );
    if(auto wt = *tl->Any<const WaveTrack>().begin()) {
@@ -44,6 +44,7 @@
 #include <wx/setup.h> // for wxUSE_* macros
 #include <wx/wxcrtvararg.h>
 #include <wx/defs.h>
+#include <wx/checkbox.h>
 #include <wx/dialog.h>
 #include <wx/dcbuffer.h>
 #include <wx/frame.h>
@@ -291,6 +292,7 @@ MeterPanel::MeterPanel(TenacityProject *project,
 : MeterPanelBase(parent, id, pos, size, wxTAB_TRAVERSAL | wxNO_BORDER | wxWANTS_CHARS),
    mProject(project),
    mQueue(1024),
+   mMetering(MAX_AUDIO),
    mWidth(size.x),
    mHeight(size.y),
    mIsInput(isInput),
@@ -401,6 +403,7 @@ void MeterPanel::UpdatePrefs()
          gPrefs->Read(Key(wxT("RefreshRate")), 30)));
    mSolidColors = gPrefs->Read(Key(wxT("Bars")), wxT("Gradient")) == wxT("Gradient");
    mDB = gPrefs->Read(Key(wxT("Type")), wxT("dB")) == wxT("dB");
+   mTruePeak = gPrefs->ReadBool(Key(wxT("TruePeak")), false);
    mMeterDisabled = gPrefs->Read(Key(wxT("Disabled")), (long)0);
 
    if (mDesiredStyle != MixerTrackCluster)
@@ -938,6 +941,7 @@ void MeterPanel::Reset(double sampleRate, bool resetClipping)
 
    // While it's stopped, empty the queue
    mQueue.Clear();
+   mResetMetering = true;
 
    mLayoutValid = false;
 
@@ -986,36 +990,27 @@ static float ToDB(float v, float range)
 void MeterPanel::UpdateDisplay(
    unsigned numChannels, int numFrames, const float *sampleData)
 {
-   auto sptr = sampleData;
+   if (mResetMetering.exchange(false))
+      mMetering.Reset();
+   const bool truePeak = mTruePeak;
+   const auto &levels =
+      mMetering.Measure(sampleData, numChannels, numFrames, truePeak);
    auto num = std::min(numChannels, mNumBars);
    MeterUpdateMsg msg;
 
    memset(&msg, 0, sizeof(msg));
    msg.numFrames = numFrames;
 
-   for(int i=0; i<numFrames; i++) {
-      for(unsigned int j=0; j<num; j++) {
-         msg.peak[j] = floatMax(msg.peak[j], fabs(sptr[j]));
-         msg.rms[j] += sptr[j]*sptr[j];
-
-         // In addition to looking for mNumPeakSamplesToClip peaked
-         // samples in a row, also send the number of peaked samples
-         // at the head and tail, in case there's a run of peaked samples
-         // that crosses block boundaries
-         if (fabs(sptr[j])>=MAX_AUDIO) {
-            if (msg.headPeakCount[j]==i)
-               msg.headPeakCount[j]++;
-            msg.tailPeakCount[j]++;
-            if (msg.tailPeakCount[j] > mNumPeakSamplesToClip)
-               msg.clipping[j] = true;
-         }
-         else
-            msg.tailPeakCount[j] = 0;
-      }
-      sptr += numChannels;
+   for(unsigned int j=0; j<num; j++) {
+      msg.peak[j] = truePeak ? levels[j].truePeak : levels[j].peak;
+      msg.rms[j] = levels[j].rms;
+      msg.clipping[j] =
+         levels[j].longestClipped > size_t(mNumPeakSamplesToClip);
+      // Also send the number of peaked samples at the head and tail, in case
+      // there's a run of peaked samples that crosses block boundaries
+      msg.headPeakCount[j] = levels[j].headClipped;
+      msg.tailPeakCount[j] = levels[j].tailClipped;
    }
-   for(unsigned int j=0; j<mNumBars; j++)
-      msg.rms[j] = sqrt(msg.rms[j]/numFrames);
 
    mQueue.Put(msg);
 }
@@ -1976,6 +1971,7 @@ void MeterPanel::OnPreferences(wxCommandEvent & /* event */)
    wxRadioButton *rms;
    wxRadioButton *db;
    wxRadioButton *linear;
+   wxCheckBox *truePeak;
    wxRadioButton *automatic;
    wxRadioButton *horizontal;
    wxRadioButton *vertical;
@@ -2028,6 +2024,8 @@ void MeterPanel::OnPreferences(wxCommandEvent & /* event */)
            {
               db = S.AddRadioButton(XXO("dB"), true, mDB);
               linear = S.AddRadioButtonToGroup(XXO("Linear"), false, mDB);
+              truePeak = S.AddCheckBox(XXO("True peak (4x oversampled)"),
+                 mTruePeak);
            }
            S.EndVerticalLay();
         }
@@ -2073,6 +2071,7 @@ void MeterPanel::OnPreferences(wxCommandEvent & /* event */)
       gPrefs->Write(Key(wxT("Style")), style[s]);
       gPrefs->Write(Key(wxT("Bars")), gradient->GetValue() ? wxT("Gradient") : wxT("RMS"));
       gPrefs->Write(Key(wxT("Type")), db->GetValue() ? wxT("dB") : wxT("Linear"));
+      gPrefs->Write(Key(wxT("TruePeak")), truePeak->GetValue());
       gPrefs->Write(Key(wxT("RefreshRate")), rate->GetValue());
 
       gPrefs->Flush();
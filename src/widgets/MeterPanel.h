@@ -21,7 +21,10 @@
 #include <wx/defs.h>
 #include <wx/timer.h> // member variable
 
+#include <atomic>
+
 // Tenacity libraries
+#include <lib-math/Metering.h>
 #include <lib-math/SampleFormat.h>
 #include <lib-preferences/Prefs.h>
 
@@ -234,6 +237,11 @@ class TENACITY_DLL_API MeterPanel final
    MeterUpdateQueue mQueue;
    wxTimer          mTimer;
 
+   //! Used by UpdateDisplay only, which may be on the audio thread
+   Metering  mMetering;
+   //! Set by Reset() so that UpdateDisplay resets mMetering
+   std::atomic<bool> mResetMetering{ true };
+
    int       mWidth;
    int       mHeight;
 
@@ -246,6 +254,8 @@ class TENACITY_DLL_API MeterPanel final
    Style     mDesiredStyle;
    bool      mSolidColors;
    bool      mDB;
+   //! Whether peaks are measured 4x oversampled
+   std::atomic<bool> mTruePeak{ false };
    int       mDBRange;
    bool      mDecay;
    float     mDecayRate; // dB/sec
@@ -0,0 +1,277 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file LibraryTest.cpp
+
+ *********************************************************************/
+
+#include "LibraryTest.h"
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/init.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+// Tenacity libraries
+#include <lib-preferences/FileConfig.h>
+#include <lib-preferences/Prefs.h>
+
+namespace LibraryTest {
+
+namespace {
+
+struct Test
+{
+   std::string name;
+   TestFunction function;
+};
+
+struct Benchmark
+{
+   std::string name;
+   BenchmarkFunction function;
+};
+
+// Function-local statics, because registrations run during static
+// initialization of the test sources
+std::vector<Test> &Tests()
+{
+   static std::vector<Test> tests;
+   return tests;
+}
+
+std::vector<Benchmark> &Benchmarks()
+{
+   static std::vector<Benchmark> benchmarks;
+   return benchmarks;
+}
+
+std::string sRecordDirectory;
+std::string sCompareDirectory;
+std::chrono::steady_clock::time_point sStart;
+
+//! Preferences that are never written, so that settings read their defaults
+class TestConfig final : public FileConfig
+{
+public:
+   using FileConfig::FileConfig;
+
+protected:
+   void Warn() override {}
+};
+
+std::string ReferencePath(const std::string &directory, const std::string &name)
+{
+   return directory + "/" + name + ".f32";
+}
+
+}
+
+Registration::Registration(const char *name, TestFunction function)
+{
+   Tests().push_back({ name, function });
+}
+
+Registration::Registration(const char *name, BenchmarkFunction function)
+{
+   Benchmarks().push_back({ name, function });
+}
+
+void StartTiming()
+{
+   sStart = std::chrono::steady_clock::now();
+}
+
+void Fail(const char *file, int line, const std::string &message)
+{
+   char location[32];
+   snprintf(location, sizeof(location), ":%d: ", line);
+   throw Failure{ file + std::string(location) + message };
+}
+
+void CheckNear(double actual, double expected, double tolerance,
+   const char *file, int line, const char *expression)
+{
+   if (std::fabs(actual - expected) <= tolerance)
+      return;
+   char message[128];
+   snprintf(message, sizeof(message), " is %.9g, expected %.9g within %.3g",
+      actual, expected, tolerance);
+   Fail(file, line, expression + std::string(message));
+}
+
+void CheckReference(const std::string &name,
+   const float *data, size_t count, float tolerance,
+   const char *file, int line)
+{
+   if (!sRecordDirectory.empty()) {
+      std::ofstream stream{
+         ReferencePath(sRecordDirectory, name), std::ios::binary };
+      stream.write(reinterpret_cast<const char *>(data), count * sizeof(float));
+      if (!stream)
+         Fail(file, line, "could not record reference " + name);
+   }
+
+   if (sCompareDirectory.empty())
+      return;
+
+   std::ifstream stream{
+      ReferencePath(sCompareDirectory, name), std::ios::binary };
+   std::vector<float> reference(count);
+   stream.read(reinterpret_cast<char *>(reference.data()),
+      count * sizeof(float));
+   if (!stream || stream.peek() != std::char_traits<char>::eof())
+      Fail(file, line, "reference " + name + " is missing or has another length");
+
+   if (tolerance == 0) {
+      if (memcmp(reference.data(), data, count * sizeof(float)) != 0)
+         Fail(file, line, "output differs from reference " + name);
+      return;
+   }
+
+   for (size_t ii = 0; ii < count; ++ii) {
+      // Also fails for NaN
+      if (!(std::fabs(data[ii] - reference[ii]) <= tolerance)) {
+         char message[128];
+         snprintf(message, sizeof(message),
+            " differs at %zu: %.9g, reference %.9g",
+            ii, data[ii], reference[ii]);
+         Fail(file, line, "output of " + name + message);
+      }
+   }
+}
+
+std::vector<float> Noise(size_t count, unsigned seed, float amplitude)
+{
+   // mt19937 produces the same sequence everywhere, but the standard
+   // distributions may not, so scale the bits directly
+   std::mt19937 engine{ seed };
+   std::vector<float> result(count);
+   for (auto &sample : result) {
+      const auto unit = (engine() >> 8) / float(1 << 24);
+      sample = amplitude * (2 * unit - 1);
+   }
+   return result;
+}
+
+std::vector<float> Sine(size_t count, double frequency, double rate,
+   float amplitude)
+{
+   std::vector<float> result(count);
+   const auto step = 2 * M_PI * frequency / rate;
+   for (size_t ii = 0; ii < count; ++ii)
+      result[ii] = amplitude * std::sin(step * ii);
+   return result;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+   using namespace LibraryTest;
+
+   bool benchmark = false;
+   std::string filter;
+   for (int ii = 1; ii < argc; ++ii) {
+      const std::string arg{ argv[ii] };
+      const bool hasValue = ii + 1 < argc;
+      if (arg == "--benchmark")
+         benchmark = true;
+      else if (arg == "--filter" && hasValue)
+         filter = argv[++ii];
+      else if (arg == "--record" && hasValue)
+         sRecordDirectory = argv[++ii];
+      else if (arg == "--compare" && hasValue)
+         sCompareDirectory = argv[++ii];
+      else {
+         fprintf(stderr,
+            "usage: %s [--benchmark] [--filter TEXT] "
+            "[--record DIR] [--compare DIR]\n", argv[0]);
+         return 2;
+      }
+   }
+
+   wxInitializer initializer;
+   if (!initializer.IsOk()) {
+      fprintf(stderr, "Could not initialize wxWidgets\n");
+      return 1;
+   }
+
+   // Some of the libraries read preferences; give them a configuration
+   // that has only defaults
+   const wxFileName configFile{
+      wxFileName::GetTempDir(), wxT("tenacity-library-test.cfg") };
+   auto config = std::make_unique<TestConfig>(
+      wxEmptyString, wxEmptyString, configFile.GetFullPath(),
+      wxEmptyString, wxCONFIG_USE_LOCAL_FILE);
+   config->Init();
+   InitPreferences(std::move(config));
+
+   const auto selected = [&](const std::string &name) {
+      return filter.empty() || name.find(filter) != std::string::npos;
+   };
+
+   int failures = 0;
+   if (benchmark) {
+      printf("%-40s %12s %14s\n", "benchmark", "seconds", "Msamples/s");
+      for (const auto &bench : Benchmarks()) {
+         if (!selected(bench.name))
+            continue;
+
+         // Best of three, to discount interference from other processes
+         double best = HUGE_VAL;
+         size_t samples = 0;
+         try {
+            for (int run = 0; run < 3; ++run) {
+               StartTiming();
+               samples = bench.function();
+               const std::chrono::duration<double> elapsed =
+                  std::chrono::steady_clock::now() - sStart;
+               best = std::min(best, elapsed.count());
+            }
+         }
+         catch (const Failure &failure) {
+            printf("%-40s FAILED: %s\n", bench.name.c_str(),
+               failure.message.c_str());
+            ++failures;
+            continue;
+         }
+         printf("%-40s %12.6f %14.2f\n", bench.name.c_str(), best,
+            best > 0 ? samples / best / 1e6 : 0.0);
+      }
+   }
+   else {
+      int count = 0;
+      for (const auto &test : Tests()) {
+         if (!selected(test.name))
+            continue;
+         ++count;
+         try {
+            test.function();
+         }
+         catch (const Failure &failure) {
+            printf("FAILED %s\n  %s\n", test.name.c_str(),
+               failure.message.c_str());
+            ++failures;
+         }
+         catch (...) {
+            printf("FAILED %s\n  unexpected exception\n", test.name.c_str());
+            ++failures;
+         }
+      }
+      printf("%d of %d tests passed\n", count - failures, count);
+   }
+
+   FinishPreferences();
+   wxRemoveFile(configFile.GetFullPath());
+
+   return failures == 0 ? 0 : 1;
+}
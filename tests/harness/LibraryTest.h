@@ -0,0 +1,100 @@
+/**********************************************************************
+
+ Tenacity: A Digital Audio Editor
+
+ @file LibraryTest.h
+
+ A small harness for the tests and benchmarks of the libraries
+
+ *********************************************************************/
+
+#ifndef __TENACITY_LIBRARY_TEST__
+#define __TENACITY_LIBRARY_TEST__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//! Tests and benchmarks, registered by the macros below
+/*!
+ The executable made by tenacity_library_test() accepts these options:
+
+ - no options: run every test; the exit status is nonzero if any failed
+ - --benchmark: run every benchmark instead, printing times and throughput
+ - --filter TEXT: only run the tests or benchmarks whose names contain TEXT
+ - --record DIR: save the outputs that tests pass to CHECK_REFERENCE
+ - --compare DIR: compare those outputs with the ones saved in DIR
+
+ Record references with a build from before an optimization, and compare
+ with a build from after it, to show that the results are bit-exact, or
+ within the tolerance that the test allows.
+
+ Benchmarks use fixed random seeds, so that every run does the same work.
+ */
+namespace LibraryTest {
+
+using TestFunction = void (*)();
+
+//! Returns the number of samples processed, for reporting throughput
+using BenchmarkFunction = size_t (*)();
+
+//! Called by a benchmark after its setup, which is then not timed
+void StartTiming();
+
+struct Registration
+{
+   Registration(const char *name, TestFunction function);
+   Registration(const char *name, BenchmarkFunction function);
+};
+
+//! Thrown by the CHECK macros, ending the test
+struct Failure
+{
+   std::string message;
+};
+
+[[noreturn]] void Fail(const char *file, int line, const std::string &message);
+
+void CheckNear(double actual, double expected, double tolerance,
+   const char *file, int line, const char *expression);
+
+//! Save data, or compare it with the data saved in a previous run
+/*! Does nothing unless --record or --compare was given.
+ @param tolerance greatest allowed absolute difference; zero requires an
+ identical bit pattern
+ */
+void CheckReference(const std::string &name,
+   const float *data, size_t count, float tolerance,
+   const char *file, int line);
+
+//! Uniform noise in [-amplitude, amplitude), the same for the same seed
+std::vector<float> Noise(size_t count, unsigned seed, float amplitude = 1.0f);
+
+//! A sine wave starting at phase zero
+std::vector<float> Sine(size_t count, double frequency, double rate,
+   float amplitude = 1.0f);
+
+}
+
+#define LIBRARY_TEST(name) \
+   static void name(); \
+   static ::LibraryTest::Registration name##Registration{ #name, &name }; \
+   static void name()
+
+#define LIBRARY_BENCHMARK(name) \
+   static size_t name(); \
+   static ::LibraryTest::Registration name##Registration{ #name, &name }; \
+   static size_t name()
+
+#define CHECK(condition) \
+   ((condition) ? (void)0 : ::LibraryTest::Fail(__FILE__, __LINE__, #condition))
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+   ::LibraryTest::CheckNear((actual), (expected), (tolerance), \
+      __FILE__, __LINE__, #actual)
+
+#define CHECK_REFERENCE(name, data, count, tolerance) \
+   ::LibraryTest::CheckReference((name), (data), (count), (tolerance), \
+      __FILE__, __LINE__)
+
+#endif